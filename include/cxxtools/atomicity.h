@@ -181,6 +181,18 @@ atomic_t atomicExchange(volatile atomic_t& val, atomic_t exch);
 */
 void* atomicExchange(void* volatile& dest, void* exch);
 
+/** @brief Atomically get a pointer
+
+    Returns the pointer after employing a memory fence, so that the data
+    published with atomicExchange or atomicCompareExchange is visible.
+*/
+inline void* atomicGet(void* volatile& ptr)
+{
+    // a compare exchange, which never changes the value, is a load with a
+    // memory fence on every platform
+    return atomicCompareExchange(ptr, 0, 0);
+}
+
 }
 
 #endif
@@ -44,9 +44,15 @@ namespace cxxtools
 
                 explicit Formatter(std::ostream& out);
 
-                void begin(std::ostream& out);
+                /// Starts output to the passed stream. When resetDictionary is
+                /// false, strings sent in earlier messages are referenced by
+                /// dictionary index. The reader must keep its dictionary then too.
+                void begin(std::ostream& out, bool resetDictionary = true);
 
-                void finish();
+                void finish()
+                { finish(true); }
+
+                void finish(bool resetDictionary);
 
                 virtual void addValueString(const std::string& name, const std::string& type,
                                       const cxxtools::String& value);
@@ -94,10 +100,13 @@ namespace cxxtools
                 void printInt(int64_t v, const std::string& name);
                 void printTypeCode(const std::string& type, bool plain);
                 void outputString(const std::string& value);
+                void clearDictionary();
 
                 std::ostream* _out;
                 TextOStream _ts;
                 std::vector<std::string> _dictionary;
+                // open addressing hash table of dictionary indexes + 1
+                std::vector<unsigned> _dictionaryIndex;
         };
 
     }
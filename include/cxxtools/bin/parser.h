@@ -31,6 +31,7 @@
 
 #include <cxxtools/serializationinfo.h>
 #include <vector>
+#include <set>
 #include <iosfwd>
 
 namespace cxxtools
@@ -51,17 +52,19 @@ class Parser
         Parser& operator= (const Parser&) { return *this; }
 #endif
 
-        explicit Parser(std::vector<std::string>* dictionary)
+        Parser(std::vector<std::string>* dictionary, std::set<std::string>* dictionaryIndex)
             : _deserializer(0),
               _next(0),
-              _dictionary(dictionary)
+              _dictionary(dictionary),
+              _dictionaryIndex(dictionaryIndex)
         { }
 
     public:
         Parser()
             : _deserializer(0),
               _next(0),
-              _dictionary(&_mydictionary)
+              _dictionary(&_mydictionary),
+              _dictionaryIndex(&_mydictionaryIndex)
         { }
 
         ~Parser() 
@@ -136,6 +139,9 @@ class Parser
         Parser* _next;
         std::vector<std::string> _mydictionary;
         std::vector<std::string>* _dictionary;
+        // the strings of the dictionary, to skip strings sent again
+        std::set<std::string> _mydictionaryIndex;
+        std::set<std::string>* _dictionaryIndex;
 };
 }
 }
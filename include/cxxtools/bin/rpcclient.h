@@ -169,6 +169,15 @@ class RpcClient : public RemoteClient
 
         void domain(const std::string& p);
 
+        /// Keep the dictionary of member and type names for all calls on one
+        /// connection instead of sending them again with each call.
+        ///
+        /// The mode is negotiated with the server when connecting. Servers not
+        /// supporting it are called as usual. Changing it closes the connection.
+        bool keepDictionary() const;
+
+        void keepDictionary(bool sw);
+
         Delegate<bool, const SslCertificate&>& acceptSslCertificate();
 };
 
@@ -132,19 +132,14 @@ namespace cxxtools
                 template <typename T>
                 Serializer& serialize(const T& v, const std::string& name)
                 {
-                    Decomposer<T> s;
-                    s.begin(v);
-                    s.setName(name);
-                    s.format(_formatter);
+                    formatValue(_formatter, name, v);
                     return *this;
                 }
 
                 template <typename T>
                 Serializer& serialize(const T& v)
                 {
-                    Decomposer<T> s;
-                    s.begin(v);
-                    s.format(_formatter);
+                    formatValue(_formatter, std::string(), v);
                     return *this;
                 }
 
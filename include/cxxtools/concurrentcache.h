@@ -0,0 +1,330 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef CXXTOOLS_CONCURRENTCACHE_H
+#define CXXTOOLS_CONCURRENTCACHE_H
+
+#include <cxxtools/lrucache.h>
+#include <cxxtools/mutex.h>
+#include <cxxtools/condition.h>
+#include <map>
+#include <vector>
+#include <cstddef>
+#if __cplusplus >= 201103L
+#include <functional>
+#endif
+
+namespace cxxtools
+{
+  /**
+     Hash function used by ConcurrentCache to select a shard.
+
+     With C++11 it uses std::hash. Otherwise specialize it for the key type
+     or pass a hash function object to ConcurrentCache.
+   */
+  template <typename Key>
+  struct CacheHash
+  {
+#if __cplusplus >= 201103L
+    std::size_t operator()(const Key& key) const
+    { return std::hash<Key>()(key); }
+#endif
+  };
+
+  /**
+     Implements a thread safe cache for multi threaded servers.
+
+     The elements are distributed by hash of the key to a number of shards.
+     Each shard is a cache of type \a Shard (LruCache or Cache) with its own
+     mutex, so that threads accessing different shards do not block each
+     other. The eviction policy of the shard type applies per shard and the
+     maximum number of elements is divided between the shards.
+
+     Since a cache hit changes the order of the elements, reads need the
+     shard lock too. Values are returned as copies, so that they stay valid
+     when the element is dropped by another thread.
+   */
+  template <typename Key, typename Value,
+            typename Shard = LruCache<Key, Value>,
+            typename Hash = CacheHash<Key> >
+  class ConcurrentCache
+  {
+#if __cplusplus >= 201103L
+      ConcurrentCache(const ConcurrentCache&) = delete;
+      ConcurrentCache& operator=(const ConcurrentCache&) = delete;
+#else
+      ConcurrentCache(const ConcurrentCache&);
+      ConcurrentCache& operator=(const ConcurrentCache&);
+#endif
+
+    public:
+      typedef typename Shard::size_type size_type;
+      typedef Value value_type;
+
+    private:
+      // a value which is currently created by getOrCreate
+      struct Pending
+      {
+        bool done;
+        bool failed;
+        unsigned waiters;
+        Value value;
+        Pending()
+          : done(false),
+            failed(false),
+            waiters(0)
+            { }
+      };
+
+      typedef std::map<Key, Pending*> PendingType;
+
+      struct ShardData
+      {
+        mutable Mutex mutex;
+        Condition created;
+        Shard cache;
+        PendingType pending;
+        explicit ShardData(size_type maxElements)
+          : cache(maxElements)
+          { }
+      };
+
+      std::vector<ShardData*> _shards;
+      size_type _maxElements;
+      Hash _hash;
+
+      ShardData& _shard(const Key& key) const
+      { return *_shards[_hash(key) % _shards.size()]; }
+
+      size_type _shardMaxElements(size_type maxElements) const
+      { return (maxElements + _shards.size() - 1) / _shards.size(); }
+
+      // Removes the pending entry after creation; the last one using it deletes it.
+      static void _release(ShardData& s, const Key& key, Pending* p, bool failed)
+      {
+        p->done = true;
+        p->failed = failed;
+        s.pending.erase(key);
+        if (p->waiters == 0)
+          delete p;
+        else
+          s.created.broadcast();
+      }
+
+    public:
+      explicit ConcurrentCache(size_type maxElements, unsigned shards = 16, const Hash& hash = Hash())
+        : _maxElements(maxElements),
+          _hash(hash)
+      {
+        if (shards == 0)
+          shards = 1;
+
+        _shards.reserve(shards);
+        for (unsigned n = 0; n < shards; ++n)
+          _shards.push_back(0);
+
+        for (unsigned n = 0; n < shards; ++n)
+          _shards[n] = new ShardData(_shardMaxElements(maxElements));
+      }
+
+      ~ConcurrentCache()
+      {
+        for (typename std::vector<ShardData*>::iterator it = _shards.begin(); it != _shards.end(); ++it)
+          delete *it;
+      }
+
+      /// returns the number of shards
+      unsigned shards() const   { return _shards.size(); }
+
+      /// returns the number of elements currently in the cache
+      size_type size() const
+      {
+        size_type ret = 0;
+        for (typename std::vector<ShardData*>::const_iterator it = _shards.begin(); it != _shards.end(); ++it)
+        {
+          MutexLock lock((*it)->mutex);
+          ret += (*it)->cache.size();
+        }
+        return ret;
+      }
+
+      /// returns the maximum number of elements in the cache
+      size_type getMaxElements() const      { return _maxElements; }
+
+      void setMaxElements(size_type maxElements)
+      {
+        _maxElements = maxElements;
+        for (typename std::vector<ShardData*>::iterator it = _shards.begin(); it != _shards.end(); ++it)
+        {
+          MutexLock lock((*it)->mutex);
+          (*it)->cache.setMaxElements(_shardMaxElements(maxElements));
+        }
+      }
+
+      /// removes a element from the cache and returns true, if found
+      bool erase(const Key& key)
+      {
+        ShardData& s = _shard(key);
+        MutexLock lock(s.mutex);
+        return s.cache.erase(key);
+      }
+
+      /// clears the cache.
+      void clear(bool stats = false)
+      {
+        for (typename std::vector<ShardData*>::iterator it = _shards.begin(); it != _shards.end(); ++it)
+        {
+          MutexLock lock((*it)->mutex);
+          (*it)->cache.clear(stats);
+        }
+      }
+
+      /// puts a new element in the cache.
+      void put(const Key& key, const Value& value)
+      {
+        ShardData& s = _shard(key);
+        MutexLock lock(s.mutex);
+        s.cache.put(key, value);
+      }
+
+      /// returns a pair of values - a flag, if the value was found and the
+      /// value if found or the passed default otherwise.
+      std::pair<bool, Value> getx(const Key& key, Value def = Value())
+      {
+        ShardData& s = _shard(key);
+        MutexLock lock(s.mutex);
+        Value* v = s.cache.getptr(key);
+        return v ? std::pair<bool, Value>(true, *v)
+                 : std::pair<bool, Value>(false, def);
+      }
+
+      /// returns the value to a key or the passed default value if not found.
+      Value get(const Key& key, Value def = Value())
+      {
+        return getx(key, def).second;
+      }
+
+      /** @brief Returns the value to a key; creates it when not found
+
+          When the key is not found, \a create is called with the key and the
+          result is put into the cache. Only one thread creates the value of a
+          key at a time. Other threads asking for the same key meanwhile wait
+          for that result instead of creating it again. The shard is not
+          locked while \a create runs. If \a create throws, the exception is
+          propagated to the creating thread and a waiting thread takes over.
+       */
+      template <typename Create>
+      Value getOrCreate(const Key& key, Create create)
+      {
+        ShardData& s = _shard(key);
+        MutexLock lock(s.mutex);
+
+        while (true)
+        {
+          Value* v = s.cache.getptr(key);
+          if (v)
+            return *v;
+
+          typename PendingType::iterator it = s.pending.find(key);
+          if (it == s.pending.end())
+            break;
+
+          // another thread creates the value - wait for it
+          Pending* p = it->second;
+          ++p->waiters;
+          while (!p->done)
+            s.created.wait(lock);
+          --p->waiters;
+
+          bool failed = p->failed;
+          Value value = failed ? Value() : p->value;
+          if (p->waiters == 0)
+            delete p;
+
+          if (!failed)
+            return value;
+        }
+
+        Pending* p = new Pending();
+        s.pending.insert(typename PendingType::value_type(key, p));
+
+        try
+        {
+          lock.unlock();
+          p->value = create(key);
+          lock.lock();
+        }
+        catch (...)
+        {
+          lock.lock();
+          _release(s, key, p, true);
+          throw;
+        }
+
+        Value value = s.cache.put(key, p->value);
+        _release(s, key, p, false);
+        return value;
+      }
+
+      /// returns the number of hits summed over all shards.
+      unsigned getHits() const
+      {
+        unsigned ret = 0;
+        for (typename std::vector<ShardData*>::const_iterator it = _shards.begin(); it != _shards.end(); ++it)
+        {
+          MutexLock lock((*it)->mutex);
+          ret += (*it)->cache.getHits();
+        }
+        return ret;
+      }
+
+      /// returns the number of misses summed over all shards.
+      unsigned getMisses() const
+      {
+        unsigned ret = 0;
+        for (typename std::vector<ShardData*>::const_iterator it = _shards.begin(); it != _shards.end(); ++it)
+        {
+          MutexLock lock((*it)->mutex);
+          ret += (*it)->cache.getMisses();
+        }
+        return ret;
+      }
+
+      /// returns the cache hit ratio between 0 and 1.
+      double hitRatio() const
+      {
+        unsigned hits = getHits();
+        unsigned misses = getMisses();
+        return hits+misses > 0 ? static_cast<double>(hits)/static_cast<double>(hits+misses) : 0;
+      }
+
+  };
+
+}
+
+#endif // CXXTOOLS_CONCURRENTCACHE_H
@@ -295,6 +295,36 @@ OutIterT putFloat(OutIterT it, T d, const FormatT& fmt, int precision);
 template <typename OutIterT, typename T>
 OutIterT putFloat(OutIterT it, T d);
 
+/** @brief Formats a double with few digits, which read back give the same value.
+
+    The digits are the shortest in almost all cases. Rarely a digit more
+    than needed is written.
+ */
+template <typename OutIterT>
+OutIterT putFloat(OutIterT it, double d);
+
+/** @brief Formats a float with few digits, which read back give the same value.
+
+    The digits are the shortest in almost all cases. Rarely a digit more
+    than needed is written.
+ */
+template <typename OutIterT>
+OutIterT putFloat(OutIterT it, float d);
+
+/** @internal @brief Computes short decimal digits of a positive finite value.
+
+    The digits are written to \a digits, which must have room for 17
+    characters. The value is 0.d1d2...dn * 10^exp. Returns the number of
+    digits. The result is read back to the same value. The algorithm
+    (Grisu2) finds the shortest digits for almost all values, but not for
+    all of them.
+ */
+unsigned shortestDigits(double value, char* digits, int& exp);
+
+/** @internal @brief Computes short decimal digits of a positive finite float.
+ */
+unsigned shortestDigits(float value, char* digits, int& exp);
+
 //
 // number parsing
 //
@@ -623,6 +653,52 @@ inline CharT* formatInt(CharT* buf, std::size_t buflen, T i, const BinaryFormat<
 }
    
 
+//! @internal @brief Returns the decimal digits of 0 to 99 as pairs of characters.
+inline const char* decimalDigitPairs()
+{
+    static const char pairs[] =
+        "00010203040506070809"
+        "10111213141516171819"
+        "20212223242526272829"
+        "30313233343536373839"
+        "40414243444546474849"
+        "50515253545556575859"
+        "60616263646566676869"
+        "70717273747576777879"
+        "80818283848586878889"
+        "90919293949596979899";
+    return pairs;
+}
+
+/** @internal @brief Writes the decimal digits of \a u in front of \a end.
+
+    Two digits are produced per division. Returns the first digit.
+ */
+template <typename UnsignedInt>
+inline char* formatDecimalDigits(char* end, UnsignedInt u)
+{
+    const char* pairs = decimalDigitPairs();
+
+    while (u >= 100)
+    {
+        unsigned r = static_cast<unsigned>(u % 100) * 2;
+        u /= 100;
+        *--end = pairs[r + 1];
+        *--end = pairs[r];
+    }
+
+    if (u >= 10)
+    {
+        unsigned r = static_cast<unsigned>(u) * 2;
+        *--end = pairs[r + 1];
+        *--end = pairs[r];
+    }
+    else
+        *--end = static_cast<char>('0' + u);
+
+    return end;
+}
+
 template <typename OutIterT, typename T, typename FormatT>
 inline OutIterT putInt(OutIterT it, T i, const FormatT& fmt)
 {
@@ -642,8 +718,19 @@ inline OutIterT putInt(OutIterT it, T i, const FormatT& fmt)
 template <typename OutIterT, typename T>
 inline OutIterT putInt(OutIterT it, T i)
 {
-    DecimalFormat<char> fmt;
-    return putInt(it, i, fmt);
+    // digits10 + 1 digits and a sign
+    char buf[std::numeric_limits<T>::digits10 + 2];
+    char* end = buf + sizeof(buf);
+
+    bool isNeg = false;
+    char* p = formatDecimalDigits(end, formatAbs(i, isNeg));
+    if (isNeg)
+        *--p = '-';
+
+    for (; p != end; ++p)
+        *it++ = *p;
+
+    return it;
 }
 
 
@@ -762,6 +849,82 @@ inline OutIterT putFloat(OutIterT it, T value)
 }
 
 
+//! @internal @brief Formats float or double with the digits of shortestDigits.
+template <typename OutIterT, typename T>
+inline OutIterT putShortestFloat(OutIterT it, T value)
+{
+    FloatFormat<char> fmt;
+
+    if (value != value)
+    {
+        for (const char* nanstr = fmt.nan(); *nanstr != 0; ++nanstr)
+            *it++ = *nanstr;
+        return it;
+    }
+
+    if (value < 0)
+        *it++ = fmt.minus();
+
+    T num = std::fabs(value);
+
+    if (num == std::numeric_limits<T>::infinity())
+    {
+        for (const char* infstr = fmt.inf(); *infstr != 0; ++infstr)
+            *it++ = *infstr;
+        return it;
+    }
+
+    if (num == 0)
+    {
+        *it++ = '0';
+        return it;
+    }
+
+    // like putFloat with precision: no exponent, no trailing zeros in the fraction
+    char digits[17];
+    int exp;
+    unsigned len = shortestDigits(num, digits, exp);
+
+    if (exp <= 0)
+    {
+        *it++ = '0';
+        *it++ = '.';
+        for ( ; exp < 0; ++exp)
+            *it++ = '0';
+        for (unsigned n = 0; n < len; ++n)
+            *it++ = digits[n];
+    }
+    else
+    {
+        for (unsigned n = 0; n < len; ++n)
+        {
+            if (exp-- == 0)
+                *it++ = '.';
+            *it++ = digits[n];
+        }
+
+        while (exp-- > 0)
+            *it++ = '0';
+    }
+
+    return it;
+}
+
+
+template <typename OutIterT>
+inline OutIterT putFloat(OutIterT it, double value)
+{
+    return putShortestFloat(it, value);
+}
+
+
+template <typename OutIterT>
+inline OutIterT putFloat(OutIterT it, float value)
+{
+    return putShortestFloat(it, value);
+}
+
+
 template <typename InIterT, typename FormatT>
 InIterT getSign(InIterT it, InIterT end, bool& pos, const FormatT& fmt)
 {
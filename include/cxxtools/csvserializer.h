@@ -86,9 +86,7 @@ namespace cxxtools
             template <typename T>
             void serialize(const T& type)
             {
-                Decomposer<T> decomposer;
-                decomposer.begin(type);
-                decomposer.format(*_formatter);
+                formatValue(*_formatter, std::string(), type);
                 _formatter->finish();
             }
 
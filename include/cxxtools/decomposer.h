@@ -29,13 +29,12 @@
 #define cxxtools_Decomposer_h
 
 #include <cxxtools/serializationinfo.h>
+#include <cxxtools/formatter.h>
 #include <string>
 
 namespace cxxtools
 {
 
-class Formatter;
-
 class IDecomposer
 {
     public:
@@ -84,6 +83,271 @@ class Decomposer : public IDecomposer
 };
 
 
+/**
+    @brief Tells, whether formatValue writes containers of T directly
+
+    It is true for fundamental types, strings and containers of them.
+ */
+template <typename T>
+struct DirectFormat { enum { value = false }; };
+
+template <> struct DirectFormat<bool> { enum { value = true }; };
+template <> struct DirectFormat<char> { enum { value = true }; };
+template <> struct DirectFormat<signed char> { enum { value = true }; };
+template <> struct DirectFormat<unsigned char> { enum { value = true }; };
+template <> struct DirectFormat<short> { enum { value = true }; };
+template <> struct DirectFormat<unsigned short> { enum { value = true }; };
+template <> struct DirectFormat<int> { enum { value = true }; };
+template <> struct DirectFormat<unsigned int> { enum { value = true }; };
+template <> struct DirectFormat<long> { enum { value = true }; };
+template <> struct DirectFormat<unsigned long> { enum { value = true }; };
+#ifdef HAVE_LONG_LONG
+template <> struct DirectFormat<long long> { enum { value = true }; };
+#endif
+#ifdef HAVE_UNSIGNED_LONG_LONG
+template <> struct DirectFormat<unsigned long long> { enum { value = true }; };
+#endif
+template <> struct DirectFormat<float> { enum { value = true }; };
+template <> struct DirectFormat<double> { enum { value = true }; };
+template <> struct DirectFormat<long double> { enum { value = true }; };
+template <> struct DirectFormat<std::string> { enum { value = true }; };
+template <> struct DirectFormat<String> { enum { value = true }; };
+template <> struct DirectFormat<Char> { enum { value = true }; };
+
+template <typename T, typename A>
+struct DirectFormat<std::vector<T, A> > { enum { value = DirectFormat<T>::value }; };
+
+template <typename T, typename A>
+struct DirectFormat<std::list<T, A> > { enum { value = DirectFormat<T>::value }; };
+
+template <typename T, typename A>
+struct DirectFormat<std::deque<T, A> > { enum { value = DirectFormat<T>::value }; };
+
+template <typename T, typename C, typename A>
+struct DirectFormat<std::set<T, C, A> > { enum { value = DirectFormat<T>::value }; };
+
+template <typename T, typename C, typename A>
+struct DirectFormat<std::multiset<T, C, A> > { enum { value = DirectFormat<T>::value }; };
+
+template <typename A, typename B>
+struct DirectFormat<std::pair<A, B> > { enum { value = DirectFormat<A>::value && DirectFormat<B>::value }; };
+
+template <typename K, typename V, typename P, typename A>
+struct DirectFormat<std::map<K, V, P, A> > { enum { value = DirectFormat<K>::value && DirectFormat<V>::value }; };
+
+template <typename K, typename V, typename P, typename A>
+struct DirectFormat<std::multimap<K, V, P, A> > { enum { value = DirectFormat<K>::value && DirectFormat<V>::value }; };
+
+/// @internal Removes the container overloads of formatValue, which are not enabled.
+template <bool Enable>
+struct FormatEnable { };
+
+template <>
+struct FormatEnable<true> { typedef void type; };
+
+/**
+    @brief Passes a value directly to a formatter
+
+    The serializers use formatValue to write objects without building a
+    SerializationInfo tree first. The generic version falls back to the
+    serialization operator <<=, so every serializable type works. For
+    fundamental types and strings the values are passed to the formatter
+    directly. The calls to the formatter are the same as from
+    IDecomposer::formatEach for the serialization info.
+
+    The standard containers and pairs are written directly only, when
+    DirectFormat is true for their elements. Otherwise they are passed to
+    operator <<=, so that an own operator <<= for e.g. a
+    std::vector<MyType> is still used.
+
+    Types may provide an own overload in their namespace to be written
+    without intermediate serialization info. To write containers of the
+    type directly as well, DirectFormat is specialized:
+
+    @code
+    void formatValue(cxxtools::Formatter& formatter, const std::string& name, const MyType& obj)
+    {
+        formatter.beginObject(name, "MyType");
+        cxxtools::formatMember(formatter, "a", obj.a);
+        cxxtools::formatMember(formatter, "b", obj.b);
+        formatter.finishObject();
+    }
+
+    namespace cxxtools
+    {
+        template <> struct DirectFormat<MyType> { enum { value = true }; };
+    }
+    @endcode
+ */
+template <typename T>
+void formatValue(Formatter& formatter, const std::string& name, const T& value)
+{
+    SerializationInfo si;
+    si <<= value;
+    si.setName(name);
+    IDecomposer::formatEach(si, formatter);
+}
+
+inline void formatValue(Formatter& formatter, const std::string& name, bool value)
+{ formatter.addValueBool(name, "bool", value); }
+
+inline void formatValue(Formatter& formatter, const std::string& name, char value)
+{ formatter.addValueChar(name, "char", value); }
+
+inline void formatValue(Formatter& formatter, const std::string& name, signed char value)
+{ formatter.addValueInt(name, "char", value); }
+
+inline void formatValue(Formatter& formatter, const std::string& name, unsigned char value)
+{ formatter.addValueUnsigned(name, "char", value); }
+
+inline void formatValue(Formatter& formatter, const std::string& name, short value)
+{ formatter.addValueInt(name, "int", value); }
+
+inline void formatValue(Formatter& formatter, const std::string& name, unsigned short value)
+{ formatter.addValueUnsigned(name, "int", value); }
+
+inline void formatValue(Formatter& formatter, const std::string& name, int value)
+{ formatter.addValueInt(name, "int", value); }
+
+inline void formatValue(Formatter& formatter, const std::string& name, unsigned int value)
+{ formatter.addValueUnsigned(name, "int", value); }
+
+inline void formatValue(Formatter& formatter, const std::string& name, long value)
+{ formatter.addValueInt(name, "int", value); }
+
+inline void formatValue(Formatter& formatter, const std::string& name, unsigned long value)
+{ formatter.addValueUnsigned(name, "int", value); }
+
+#ifdef HAVE_LONG_LONG
+inline void formatValue(Formatter& formatter, const std::string& name, long long value)
+{ formatter.addValueInt(name, "int", static_cast<Formatter::int_type>(value)); }
+#endif
+
+#ifdef HAVE_UNSIGNED_LONG_LONG
+inline void formatValue(Formatter& formatter, const std::string& name, unsigned long long value)
+{ formatter.addValueUnsigned(name, "int", static_cast<Formatter::unsigned_type>(value)); }
+#endif
+
+inline void formatValue(Formatter& formatter, const std::string& name, float value)
+{ formatter.addValueFloat(name, "float", value); }
+
+inline void formatValue(Formatter& formatter, const std::string& name, double value)
+{ formatter.addValueDouble(name, "double", value); }
+
+inline void formatValue(Formatter& formatter, const std::string& name, long double value)
+{ formatter.addValueLongDouble(name, "double", value); }
+
+inline void formatValue(Formatter& formatter, const std::string& name, const std::string& value)
+{ formatter.addValueStdString(name, "string", value); }
+
+inline void formatValue(Formatter& formatter, const std::string& name, const char* value)
+{ formatter.addValueStdString(name, "string", value); }
+
+inline void formatValue(Formatter& formatter, const std::string& name, const String& value)
+{ formatter.addValueString(name, "string", value); }
+
+inline void formatValue(Formatter& formatter, const std::string& name, const Char& value)
+{ formatter.addValueString(name, "char", String(1, value)); }
+
+// The container versions are declared first, so that they find each other
+// for nested containers.
+
+template <typename T, typename A>
+typename FormatEnable<DirectFormat<std::vector<T, A> >::value>::type
+formatValue(Formatter& formatter, const std::string& name, const std::vector<T, A>& vec);
+
+template <typename T, typename A>
+typename FormatEnable<DirectFormat<std::list<T, A> >::value>::type
+formatValue(Formatter& formatter, const std::string& name, const std::list<T, A>& list);
+
+template <typename T, typename A>
+typename FormatEnable<DirectFormat<std::deque<T, A> >::value>::type
+formatValue(Formatter& formatter, const std::string& name, const std::deque<T, A>& deque);
+
+template <typename T, typename C, typename A>
+typename FormatEnable<DirectFormat<std::set<T, C, A> >::value>::type
+formatValue(Formatter& formatter, const std::string& name, const std::set<T, C, A>& set);
+
+template <typename T, typename C, typename A>
+typename FormatEnable<DirectFormat<std::multiset<T, C, A> >::value>::type
+formatValue(Formatter& formatter, const std::string& name, const std::multiset<T, C, A>& multiset);
+
+template <typename A, typename B>
+typename FormatEnable<DirectFormat<std::pair<A, B> >::value>::type
+formatValue(Formatter& formatter, const std::string& name, const std::pair<A, B>& p);
+
+template <typename K, typename V, typename P, typename A>
+typename FormatEnable<DirectFormat<std::map<K, V, P, A> >::value>::type
+formatValue(Formatter& formatter, const std::string& name, const std::map<K, V, P, A>& map);
+
+template <typename K, typename V, typename P, typename A>
+typename FormatEnable<DirectFormat<std::multimap<K, V, P, A> >::value>::type
+formatValue(Formatter& formatter, const std::string& name, const std::multimap<K, V, P, A>& multimap);
+
+/// Writes a member of an object, which was started with Formatter::beginObject.
+template <typename T>
+void formatMember(Formatter& formatter, const std::string& name, const T& value)
+{
+    formatter.beginMember(name);
+    formatValue(formatter, name, value);
+    formatter.finishMember();
+}
+
+template <typename Iterator>
+void formatArray(Formatter& formatter, const std::string& name, const std::string& type,
+    Iterator begin, Iterator end)
+{
+    formatter.beginArray(name, type);
+    for ( ; begin != end; ++begin)
+        formatValue(formatter, std::string(), *begin);
+    formatter.finishArray();
+}
+
+template <typename T, typename A>
+typename FormatEnable<DirectFormat<std::vector<T, A> >::value>::type
+formatValue(Formatter& formatter, const std::string& name, const std::vector<T, A>& vec)
+{ formatArray(formatter, name, "array", vec.begin(), vec.end()); }
+
+template <typename T, typename A>
+typename FormatEnable<DirectFormat<std::list<T, A> >::value>::type
+formatValue(Formatter& formatter, const std::string& name, const std::list<T, A>& list)
+{ formatArray(formatter, name, "list", list.begin(), list.end()); }
+
+template <typename T, typename A>
+typename FormatEnable<DirectFormat<std::deque<T, A> >::value>::type
+formatValue(Formatter& formatter, const std::string& name, const std::deque<T, A>& deque)
+{ formatArray(formatter, name, "deque", deque.begin(), deque.end()); }
+
+template <typename T, typename C, typename A>
+typename FormatEnable<DirectFormat<std::set<T, C, A> >::value>::type
+formatValue(Formatter& formatter, const std::string& name, const std::set<T, C, A>& set)
+{ formatArray(formatter, name, "set", set.begin(), set.end()); }
+
+template <typename T, typename C, typename A>
+typename FormatEnable<DirectFormat<std::multiset<T, C, A> >::value>::type
+formatValue(Formatter& formatter, const std::string& name, const std::multiset<T, C, A>& multiset)
+{ formatArray(formatter, name, "multiset", multiset.begin(), multiset.end()); }
+
+template <typename A, typename B>
+typename FormatEnable<DirectFormat<std::pair<A, B> >::value>::type
+formatValue(Formatter& formatter, const std::string& name, const std::pair<A, B>& p)
+{
+    formatter.beginObject(name, "pair");
+    formatMember(formatter, "first", p.first);
+    formatMember(formatter, "second", p.second);
+    formatter.finishObject();
+}
+
+template <typename K, typename V, typename P, typename A>
+typename FormatEnable<DirectFormat<std::map<K, V, P, A> >::value>::type
+formatValue(Formatter& formatter, const std::string& name, const std::map<K, V, P, A>& map)
+{ formatArray(formatter, name, "map", map.begin(), map.end()); }
+
+template <typename K, typename V, typename P, typename A>
+typename FormatEnable<DirectFormat<std::multimap<K, V, P, A> >::value>::type
+formatValue(Formatter& formatter, const std::string& name, const std::multimap<K, V, P, A>& multimap)
+{ formatArray(formatter, name, "multimap", multimap.begin(), multimap.end()); }
+
 } // namespace cxxtools
 
 #endif
@@ -54,6 +54,7 @@ namespace cxxtools
 #endif
 
             Deserializer()
+                : _reuseStorage(false)
             { }
 
             virtual ~Deserializer()
@@ -94,6 +95,19 @@ namespace cxxtools
 
             void clear();
 
+            /** @brief Keeps the storage of the deserialized data for the next message
+
+                When enabled, clear() and begin() reset the SerializationInfo
+                instead of releasing it, so that deserializing the next
+                message reuses the nodes, names and type names of the previous
+                one instead of allocating them again.
+             */
+            void reuseStorage(bool sw)
+            { _reuseStorage = sw; }
+
+            bool reuseStorage() const
+            { return _reuseStorage; }
+
             SerializationInfo* current()
             { return _current.empty() ? 0 : _current.top(); }
 
@@ -143,6 +157,7 @@ namespace cxxtools
         private:
             SerializationInfo _si;
             std::stack<SerializationInfo*> _current;
+            bool _reuseStorage;
     };
 
 }
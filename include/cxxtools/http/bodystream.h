@@ -0,0 +1,160 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#ifndef cxxtools_Http_BodyStream_h
+#define cxxtools_Http_BodyStream_h
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace cxxtools {
+
+class IOStream;
+
+namespace http {
+
+/**
+    Stream buffer for http message bodies.
+
+    The data is kept in a chain of blocks, which grow in size, so that
+    appending never moves data already written. The size is known without
+    collecting the data. The http client writes large blocks to its socket
+    without copying. The http server writes its socket asynchronously and
+    copies the blocks to the stream buffer of the socket once.
+
+    Data written can be read again like from a std::stringbuf.
+ */
+class BodyBuffer : public std::streambuf
+{
+        struct Block
+        {
+            char* data;
+            std::size_t size;
+            std::size_t capacity;
+        };
+
+        std::vector<Block> _blocks;
+        std::size_t _size;          // bytes in blocks without the put area
+        std::size_t _readBlock;     // index of the block in the get area
+        std::size_t _consumed;      // bytes in blocks before _readBlock
+
+        // not copyable
+        BodyBuffer(const BodyBuffer&);
+        BodyBuffer& operator=(const BodyBuffer&);
+
+        void commit();
+        void addBlock(std::size_t minCapacity);
+
+    public:
+        BodyBuffer();
+        ~BodyBuffer();
+
+        /// Returns the number of bytes written.
+        std::size_t size() const
+        { return _size + (pptr() - pbase()); }
+
+        /// Returns the number of blocks.
+        std::size_t blocks() const
+        { return _blocks.size(); }
+
+        /// Returns the data of block n.
+        const char* blockData(std::size_t n) const
+        { return _blocks[n].data; }
+
+        /// Returns the number of bytes in block n.
+        std::size_t blockSize(std::size_t n) const
+        { return n + 1 == _blocks.size() && pptr() ? pptr() - _blocks[n].data
+                                                   : _blocks[n].size; }
+
+        /// Returns the whole content including data already read.
+        std::string str() const;
+
+        /// Replaces the content.
+        void str(const std::string& s);
+
+        /// Removes all data. The first block is kept for reuse.
+        void clear();
+
+        /// Writes the content to the output stream.
+        void sendTo(std::ostream& out) const;
+
+        /**
+            Writes the content to the I/O stream.
+
+            Large blocks are passed directly to the device after flushing
+            the stream buffer instead of copying them to the buffer. The
+            device must not be in an asynchronous write operation.
+         */
+        void sendTo(IOStream& out) const;
+
+    protected:
+        int_type overflow(int_type ch);
+        int_type underflow();
+        std::streamsize xsputn(const char* s, std::streamsize n);
+        std::streamsize showmanyc();
+};
+
+/**
+    Input and output stream for http message bodies.
+
+    It replaces a std::stringstream, so it has the str methods of it, but
+    it keeps the data in a BodyBuffer.
+ */
+class BodyStream : public std::iostream
+{
+        BodyBuffer _buffer;
+
+    public:
+        BodyStream()
+            : std::iostream(0)
+        { init(&_buffer); }
+
+        BodyBuffer& buffer()
+        { return _buffer; }
+
+        const BodyBuffer& buffer() const
+        { return _buffer; }
+
+        /// Returns the number of bytes written.
+        std::size_t size() const
+        { return _buffer.size(); }
+
+        std::string str() const
+        { return _buffer.str(); }
+
+        void str(const std::string& s)
+        { _buffer.str(s); }
+};
+
+} // namespace http
+
+} // namespace cxxtools
+
+#endif
@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#ifndef cxxtools_Http_FileService_h
+#define cxxtools_Http_FileService_h
+
+#include <cxxtools/http/service.h>
+#include <map>
+#include <string>
+
+namespace cxxtools {
+
+namespace http {
+
+/**
+    Service, which delivers static files from a directory.
+
+    The part of the url after the url prefix is taken as the path of the
+    file relative to the document root. Paths with ".." components are
+    rejected. The service supports GET and HEAD requests, single byte
+    ranges, ETag, If-None-Match, If-Modified-Since and If-Range.
+
+    The content of the file is not read by the service. The server
+    transmits it with sendfile(2) on plain sockets.
+
+    Example:
+    @code
+      cxxtools::http::FileService fileService("/var/www/static", "/static/");
+      server.addService(cxxtools::Regex("^/static/"), fileService);
+    @endcode
+ */
+class FileService : public CachedServiceBase
+{
+        std::string _documentRoot;
+        std::string _urlPrefix;
+
+        typedef std::map<std::string, std::string> MimeTypes;
+        MimeTypes _mimeTypes;
+        std::string _defaultMimeType;
+
+    public:
+        explicit FileService(const std::string& documentRoot,
+                             const std::string& urlPrefix = "/");
+
+        const std::string& documentRoot() const
+        { return _documentRoot; }
+
+        const std::string& urlPrefix() const
+        { return _urlPrefix; }
+
+        /// Sets the content type for files with the extension (without the dot).
+        void addMimeType(const std::string& extension, const std::string& mimeType)
+        { _mimeTypes[extension] = mimeType; }
+
+        /// Sets the content type for files with unknown extension.
+        void defaultMimeType(const std::string& mimeType)
+        { _defaultMimeType = mimeType; }
+
+        const std::string& defaultMimeType() const
+        { return _defaultMimeType; }
+
+        /// Returns the content type for the file name.
+        const std::string& mimeType(const std::string& fileName) const;
+
+    protected:
+        Responder* newResponder();
+};
+
+} // namespace http
+
+} // namespace cxxtools
+
+#endif
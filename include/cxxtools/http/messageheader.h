@@ -36,6 +36,8 @@
 namespace cxxtools
 {
 
+class DateTime;
+
 namespace http
 {
 
@@ -126,6 +128,10 @@ class MessageHeader
         void addHeader(const char* key, const char* value)
         { setHeader(key, value, false); }
 
+        /// Adds a header from strings, which need not be zero terminated.
+        void addHeader(const char* key, std::size_t keySize,
+                       const char* value, std::size_t valueSize);
+
         void removeHeader(const char* key);
 
         const char* getHeader(const char* key) const;
@@ -163,6 +169,10 @@ class MessageHeader
         /// The buffer must have at least 30 bytes.
         static char* htdateCurrent(char* buffer);
 
+        /// Returns a properly formatted time-string of the passed UTC time.
+        /// The buffer must have at least 30 bytes.
+        static char* htdate(const DateTime& dt, char* buffer);
+
 };
 
 } // namespace http
@@ -30,6 +30,7 @@
 #define cxxtools_Http_Reply_h
 
 #include <cxxtools/http/replyheader.h>
+#include <cxxtools/http/bodystream.h>
 #include <string>
 #include <sstream>
 
@@ -42,12 +43,26 @@ class Request;
 class Reply
 {
         ReplyHeader _header;
-        std::stringstream _body;
+        BodyStream _body;
+
+        int _fileFd;
+        std::streamoff _fileOffset;
+        std::size_t _fileSize;
+
+        // not copyable
+        Reply(const Reply&);
+        Reply& operator=(const Reply&);
 
     public:
         Reply()
+            : _fileFd(-1),
+              _fileOffset(0),
+              _fileSize(0)
             { }
 
+        ~Reply()
+            { clearFile(); }
+
         ReplyHeader& header()
         { return _header; }
 
@@ -84,6 +99,7 @@ class Reply
             _header.clear();
             _body.clear();
             _body.str(std::string());
+            clearFile();
         }
 
         unsigned httpReturnCode() const
@@ -98,14 +114,50 @@ class Reply
         std::string body() const
         { return _body.str(); }
 
-        std::stringstream& bodyStream()
+        /**
+            Returns the stream of the body.
+
+            This used to return a std::stringstream. BodyStream is a
+            std::iostream with the str methods of std::stringstream, so
+            code using the returned stream as std::iostream or calling str
+            just needs a recompile. Code binding it to std::stringstream&
+            must use BodyStream& instead.
+         */
+        BodyStream& bodyStream()
         { return _body; }
 
+        /// Returns the size of the body including the file range.
         std::size_t bodySize() const
-        { return _body.str().size(); }
+        { return _body.size() + _fileSize; }
+
+        /**
+            Sends size bytes of the file starting at offset after the body.
+
+            The reply takes ownership of the file descriptor and closes it
+            when the reply is cleared or destroyed. The server transmits the
+            file with sendfile(2) if possible.
+         */
+        void setFile(int fd, std::streamoff offset, std::size_t size);
+
+        /// Closes the file set with setFile.
+        void clearFile();
+
+        /// Returns the file descriptor set with setFile or -1.
+        int fileFd() const
+        { return _fileFd; }
+
+        std::streamoff fileOffset() const
+        { return _fileOffset; }
+
+        std::size_t fileSize() const
+        { return _fileSize; }
 
         void sendBody(std::ostream& out) const
-        { out << _body.str(); }
+        { _body.buffer().sendTo(out); }
+
+        /// Sends the body. Large parts are written directly to the device.
+        void sendBody(IOStream& out) const
+        { _body.buffer().sendTo(out); }
 
         operator std::string() const
         { return _body.str(); }
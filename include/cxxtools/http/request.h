@@ -30,6 +30,7 @@
 #define cxxtools_Http_Request_h
 
 #include <cxxtools/http/requestheader.h>
+#include <cxxtools/http/bodystream.h>
 #include <string>
 #include <sstream>
 
@@ -40,7 +41,7 @@ namespace http {
 class Request
 {
         RequestHeader _header;
-        std::ostringstream _body;
+        BodyStream _body;
 
     public:
         struct Auth
@@ -116,10 +117,14 @@ class Request
         { return _body; }
 
         std::size_t bodySize() const
-        { return _body.str().size(); }
+        { return _body.size(); }
 
         void sendBody(std::ostream& out) const
-        { out << _body.str(); }
+        { _body.buffer().sendTo(out); }
+
+        /// Sends the body. Large parts are written directly to the device.
+        void sendBody(IOStream& out) const
+        { _body.buffer().sendTo(out); }
 
         Auth auth() const;
 
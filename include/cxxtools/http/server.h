@@ -111,6 +111,23 @@ class Server
         unsigned maxThreads() const;
         void maxThreads(unsigned m);
 
+        /** Sets the number of reactors.
+
+            A reactor is an event loop with its own listening sockets, idle
+            connections and worker threads. The first reactor uses the event
+            loop passed to the constructor. Each additional reactor runs its
+            own event loop in a separate thread. All reactors listen on the
+            same addresses using SO_REUSEPORT and the kernel distributes the
+            incoming connections between them.
+
+            The thread limits set with minThreads and maxThreads apply to each
+            reactor. The number of reactors must be set before the first call
+            to listen and before the server runs. Otherwise std::logic_error
+            is thrown. The default is 1.
+         */
+        void reactors(unsigned n);
+        unsigned reactors() const;
+
         enum Runmode {
           Stopped,
           Starting,
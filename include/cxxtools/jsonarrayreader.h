@@ -0,0 +1,121 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef CXXTOOLS_JSONARRAYREADER_H
+#define CXXTOOLS_JSONARRAYREADER_H
+
+#include <cxxtools/jsondeserializer.h>
+#include <iosfwd>
+#include <vector>
+
+namespace cxxtools
+{
+    /**
+     * This class reads a json array element by element.
+     *
+     * Unlike JsonDeserializer, which builds a SerializationInfo of the whole
+     * document, only the current element is held in memory. This makes it
+     * possible to process arrays much larger than the available memory.
+     *
+     * @code
+     * std::ifstream in("records.json");
+     * cxxtools::JsonArrayReader reader(in);
+     *
+     * Record record;
+     * while (reader.get(record))
+     *   process(record);
+     * @endcode
+     *
+     * The input is read in blocks, so the stream is read past the end of the
+     * array. The input is parsed as bytes like in
+     * JsonDeserializer::advance(const char*&, const char*).
+     */
+    class JsonArrayReader
+    {
+            // make non copyable
+            JsonArrayReader(const JsonArrayReader&);
+            JsonArrayReader& operator=(const JsonArrayReader&);
+
+        public:
+            explicit JsonArrayReader(std::istream& in);
+
+            explicit JsonArrayReader(std::streambuf& in);
+
+            /// Reads the next element of the array.
+            /// Returns false, when the end of the array is reached.
+            bool next();
+
+            /// Returns the element read by the last call of next().
+            const SerializationInfo& si() const
+            { return _deserializer.si(); }
+
+            /// Reads the next element of the array into value.
+            /// Returns false, when the end of the array is reached.
+            template <typename T>
+            bool get(T& value)
+            {
+                if (!next())
+                    return false;
+                _deserializer.deserialize(value);
+                return true;
+            }
+
+            /// Returns the number of elements read so far.
+            unsigned count() const
+            { return _count; }
+
+        private:
+            std::streambuf* _in;
+            JsonDeserializer _deserializer;
+            std::vector<char> _buffer;
+            const char* _begin;
+            const char* _end;
+            unsigned _lineNo;
+            unsigned _count;
+
+            enum
+            {
+                state_0,
+                state_array,
+                state_element,
+                state_next,
+                state_comment0,
+                state_commentline,
+                state_comment,
+                state_comment_e,
+                state_end
+            } _state, _nextState;
+
+            void init();
+            bool fill();
+            void readElement();
+            void doThrow(const std::string& msg);
+    };
+}
+
+#endif // CXXTOOLS_JSONARRAYREADER_H
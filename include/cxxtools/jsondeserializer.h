@@ -107,6 +107,11 @@ namespace cxxtools
 
             explicit JsonDeserializer(std::basic_istream<Char>& in);
 
+            /// Reads json from the bytes of the stream buffer without decoding.
+            /// String values are passed as std::string with the bytes of the
+            /// input (see JsonParser::advance(const char*&, const char*)).
+            explicit JsonDeserializer(std::streambuf& in);
+
             JsonDeserializer()
             { }
 
@@ -115,6 +120,22 @@ namespace cxxtools
             int advance(Char ch) // 1: end character detected; -1: end but char not consumed; 0: no end
             { return _parser.advance(ch); }
 
+            /// Processes the bytes in [begin, end) and returns true, when the end
+            /// of the json value is reached. begin points to the first
+            /// unprocessed byte then.
+            bool advance(const char*& begin, const char* end)
+            { return _parser.advance(begin, end); }
+
+            /// Processes the bytes available in the stream buffer. When no bytes
+            /// are available, the buffer is filled first, which may block.
+            /// Returns true, when the end of the json value is reached. Bytes
+            /// following the value are left in the buffer.
+            bool advance(std::streambuf& in);
+
+            /// Like advance(std::streambuf&) and sets \a count to the number of
+            /// bytes consumed from the stream buffer.
+            bool advance(std::streambuf& in, std::size_t& count);
+
             void finish()
             { return _parser.finish(); }
 
@@ -60,6 +60,8 @@ namespace cxxtools
             {
                     JsonParser* _jsonParser;
                     String _str;
+                    std::string _bytes;
+                    bool _wide;
                     unsigned _count;
                     unsigned short _value;
 
@@ -70,22 +72,39 @@ namespace cxxtools
                         state_hex
                     } _state;
 
+                    void append(Char ch);
+
                 public:
                     explicit JsonStringParser(JsonParser* jsonParser)
                         : _jsonParser(jsonParser),
+                          _wide(false),
                           _state(state_0)
                         { }
 
                     bool advance(Char ch);
 
+                    // In byte mode unescaped characters are collected in a
+                    // std::string. This returns true, when appending is possible.
+                    bool plain() const
+                    { return _state == state_0 && !_wide; }
+
+                    void append(const char* begin, const char* end)
+                    { _bytes.append(begin, end); }
+
                     void clear()
-                    { _state = state_0; _str.clear(); }
+                    { _state = state_0; _str.clear(); _bytes.clear(); _wide = false; }
+
+                    // true, when the string is collected as unicode string
+                    bool wide() const
+                    { return !_jsonParser->_byteMode || _wide; }
 
                     const String& str() const
                     { return _str; }
 
-                    void str(const String& s)
-                    { _str = s; }
+                    const std::string& bytes() const
+                    { return _bytes; }
+
+                    void str(const std::string& s);
             };
 
             // make non copyable:
@@ -101,9 +120,23 @@ namespace cxxtools
                 _state = state_0;
                 _token.clear();
                 _deserializer = &handler;
+                _byteMode = false;
             }
 
             int advance(Char ch); // 1: end character detected; -1: end but char not consumed; 0: no end
+
+            /// Processes json directly from the bytes in [begin, end).
+            ///
+            /// Unlike advance(Char), the input is not decoded first. Runs of
+            /// string characters and numbers are taken in bulk and string values
+            /// are passed as std::string with the bytes of the input. Only
+            /// strings with \u escapes of non ascii characters are passed as
+            /// unicode strings.
+            ///
+            /// Returns true, when the end of the value is reached. begin then
+            /// points to the first character following it.
+            bool advance(const char*& begin, const char* end);
+
             void finish();
 
         private:
@@ -133,13 +166,17 @@ namespace cxxtools
                 state_end
             } _state, _nextState;
 
-            String _token;
+            std::string _token;
 
             JsonDeserializer* _deserializer;
             JsonStringParser _stringParser;
             JsonParser* _next;
             unsigned _lineNo;
+            bool _byteMode;
 
+            void beginNext();
+            void beginObjectMember();
+            void setStringValue();
             void doThrow(const std::string& msg);
             void throwInvalidCharacter(Char ch);
     };
@@ -141,17 +141,13 @@ namespace cxxtools
             template <typename T>
             JsonSerializer& serialize(const T& v, const std::string& name)
             {
-                Decomposer<T> s;
-                s.begin(v);
-                s.setName(name);
-
                 if (!_inObject)
                 {
                     _formatter.beginObject(std::string(), std::string());
                     _inObject = true;
                 }
 
-                s.format(_formatter);
+                formatValue(_formatter, name, v);
                 return *this;
             }
 
@@ -161,9 +157,7 @@ namespace cxxtools
                 if (_inObject)
                     throw std::logic_error("can't serialize object without name into another object");
 
-                Decomposer<T> s;
-                s.begin(v);
-                s.format(_formatter);
+                formatValue(_formatter, std::string(), v);
                 _os->flush();
                 return *this;
             }
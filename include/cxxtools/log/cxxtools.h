@@ -29,6 +29,7 @@
 #ifndef CXXTOOLS_LOG_CXXTOOLS_H
 #define CXXTOOLS_LOG_CXXTOOLS_H
 
+#include <cxxtools/atomicity.h>
 #include <string>
 #include <iostream>
 
@@ -181,7 +182,7 @@ namespace cxxtools
 
     private:
       std::string category;
-      int flags;
+      mutable atomic_t flags;  // replaced with atomicSet on reconfiguration
 
     public:
       /// Initalizes a new logger.
@@ -192,13 +193,13 @@ namespace cxxtools
       const std::string& getCategory() const
         { return category; }
       bool isEnabled(log_flag_type l) const
-        { return (flags & l) != 0; }
+        { return (atomicGet(flags) & l) != 0; }
       log_level_type getLogLevel() const
-        { return static_cast<log_level_type>(flags); }
+        { return static_cast<log_level_type>(atomicGet(flags)); }
       int getLogFlags() const
-        { return flags; }
+        { return static_cast<int>(atomicGet(flags)); }
       void setLogFlags(int f)
-        { flags = f; }
+        { atomicSet(flags, f); }
   };
 
   //////////////////////////////////////////////////////////////////////
@@ -277,9 +278,25 @@ namespace cxxtools
 
       void setFile(const std::string& fname);
       void setFile(const std::string& fname, unsigned maxfilesize, unsigned maxbackupindex);
+      /// Writes structured binary records to a memory mapped file instead of
+      /// text lines. The tool cxxtools-logformat converts the file to text or
+      /// json.
+      void setBinaryFile(const std::string& fname);
       void setLoghost(const std::string& host, unsigned short port, bool broadcast = false);
       void setStdout();
       void setStderr();
+
+      /// Writes log messages in a background thread.
+      /// The messages are passed to the thread through a lock free queue
+      /// with room for queueSize messages. When the queue is full, messages
+      /// are dropped or, when block is set, the logging thread waits.
+      /// Fatal messages are written before the log statement returns.
+      void setAsync(unsigned queueSize = 8192, bool block = false);
+      /// Writes log messages in the logging thread (the default).
+      void setSync();
+      /// Takes the timestamps of log entries from a coarse clock, which is
+      /// cheaper to read but has just the resolution of the kernel tick.
+      void setCoarseClock(bool sw = true);
   };
 
   void operator>>= (const SerializationInfo& si, LogConfiguration& logConfiguration);
@@ -30,12 +30,16 @@
 #define CXXTOOLS_LRUCACHE_H
 
 #include <map>
-#include <limits>
 
 namespace cxxtools
 {
   /**
      Implements a lru cache
+
+     The elements are kept in a map for lookup and additionally in a doubly
+     linked list ordered by the time of last access. Hits move the element to
+     the front of the list in constant time and the element at the back is the
+     one to drop when the cache is full.
    */
 
   template <typename Key, typename Value>
@@ -43,12 +47,15 @@ namespace cxxtools
   {
       struct Data
       {
-        unsigned serial;
         Value value;
-        Data() { }
-        Data(unsigned serial_, const Value& value_)
-          : serial(serial_),
-            value(value_)
+        const Key* key;   // points to the key in the map
+        Data* newer;
+        Data* older;
+        explicit Data(const Value& value_)
+          : value(value_),
+            key(0),
+            newer(0),
+            older(0)
             { }
       };
 
@@ -56,33 +63,64 @@ namespace cxxtools
       DataType data;
 
       typename DataType::size_type maxElements;
-      unsigned serial;
+      Data* newest;
+      Data* oldest;
       unsigned hits;
       unsigned misses;
 
-      unsigned _nextSerial()
+      void _unlink(Data* d)
       {
-        if (serial == std::numeric_limits<unsigned>::max())
-        {
-          for (typename DataType::iterator it = data.begin(); it != data.end(); ++it)
-            it->second.serial = 0;
-          serial = 1;
-        }
+        if (d->newer)
+          d->newer->older = d->older;
+        else
+          newest = d->older;
 
-        return serial++;
+        if (d->older)
+          d->older->newer = d->newer;
+        else
+          oldest = d->newer;
       }
 
-      typename DataType::iterator _getOldest()
+      void _linkNewest(Data* d)
       {
-        typename DataType::iterator foundElement = data.begin();
+        d->newer = 0;
+        d->older = newest;
+        if (newest)
+          newest->newer = d;
+        else
+          oldest = d;
+        newest = d;
+      }
 
-        typename DataType::iterator it = data.begin();
+      void _touch(Data* d)
+      {
+        if (d != newest)
+        {
+          _unlink(d);
+          _linkNewest(d);
+        }
+      }
 
-        for (++it; it != data.end(); ++it)
-          if (it->second.serial < foundElement->second.serial)
-            foundElement = it;
+      void _eraseOldest()
+      {
+        Data* d = oldest;
+        _unlink(d);
+        data.erase(*d->key);
+      }
+
+      typename DataType::iterator _insert(const Key& key, const Value& value)
+      {
+        typename DataType::iterator it = data.insert(
+          typename DataType::value_type(key, Data(value))).first;
+        it->second.key = &it->first;
+        _linkNewest(&it->second);
+        return it;
+      }
 
-        return foundElement;
+      void _copy(const LruCache& c)
+      {
+        for (const Data* d = c.oldest; d; d = d->newer)
+          _insert(*d->key, d->value);
       }
 
     public:
@@ -91,11 +129,33 @@ namespace cxxtools
 
       explicit LruCache(size_type maxElements_)
         : maxElements(maxElements_),
-          serial(0),
+          newest(0),
+          oldest(0),
           hits(0),
           misses(0)
         { }
 
+      LruCache(const LruCache& c)
+        : maxElements(c.maxElements),
+          newest(0),
+          oldest(0),
+          hits(c.hits),
+          misses(c.misses)
+        { _copy(c); }
+
+      LruCache& operator=(const LruCache& c)
+      {
+        if (this != &c)
+        {
+          clear();
+          maxElements = c.maxElements;
+          hits = c.hits;
+          misses = c.misses;
+          _copy(c);
+        }
+        return *this;
+      }
+
       /// returns the number of elements currently in the cache
       size_type size() const        { return data.size(); }
 
@@ -106,7 +166,7 @@ namespace cxxtools
       {
         maxElements = maxElements_;
         while (data.size() > maxElements)
-          data.erase(_getOldest());
+          _eraseOldest();
       }
 
       /// removes a element from the cache and returns true, if found
@@ -116,6 +176,7 @@ namespace cxxtools
         if (it == data.end())
           return false;
 
+        _unlink(&it->second);
         data.erase(it);
         return true;
       }
@@ -124,6 +185,7 @@ namespace cxxtools
       void clear(bool stats = false)
       {
         data.clear();
+        newest = oldest = 0;
         if (stats)
           hits = misses = 0;
       }
@@ -136,17 +198,15 @@ namespace cxxtools
         typename DataType::iterator it = data.find(key);
         if (it == data.end())
         {
-          if (data.size() >= maxElements)
-            data.erase(_getOldest());
+          while (oldest && data.size() >= maxElements)
+            _eraseOldest();
 
-          it = data.insert(data.begin(),
-            typename DataType::value_type(key,
-              Data(_nextSerial(), value)));
+          it = _insert(key, value);
         }
         else
         {
           // element found
-          it->second.serial = _nextSerial();
+          _touch(&it->second);
         }
 
         return it->second.value;
@@ -161,7 +221,7 @@ namespace cxxtools
           return 0;
         }
 
-        it->second.serial = _nextSerial();
+        _touch(&it->second);
 
         ++hits;
         return &it->second.value;
@@ -63,7 +63,14 @@ namespace net
     class TcpServerImpl* _impl;
 
     public:
-      enum { INHERIT = 1, DEFER_ACCEPT = 2, REUSEADDR = 4 };
+      /** @brief Flags for listen
+
+          REUSEPORT sets SO_REUSEPORT, so that multiple servers (e.g. one per
+          thread) can listen on the same address. The kernel distributes
+          incoming connections between them. It is ignored on systems without
+          SO_REUSEPORT.
+      */
+      enum { INHERIT = 1, DEFER_ACCEPT = 2, REUSEADDR = 4, REUSEPORT = 8 };
 
       TcpServer();
 
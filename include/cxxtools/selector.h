@@ -32,7 +32,7 @@
 
 #include <cxxtools/timespan.h>
 #include <cxxtools/connectable.h>
-#include <map>
+#include <vector>
 
 namespace cxxtools {
 
@@ -219,10 +219,39 @@ namespace cxxtools {
             bool updateTimer(Timespan& timeout);
 
             //! @internal
-            typedef std::multimap<Timespan, Timer*> TimerMap;
+            struct TimerEntry
+            {
+                Timespan finished;
+                uint64_t serial;
+                Timer* timer;
+
+                bool operator< (const TimerEntry& other) const
+                {
+                    return finished < other.finished
+                        || (finished == other.finished && serial < other.serial);
+                }
+            };
+
+            //! @internal Inserts the timer into the heap or updates its position
+            void timerHeapPut(Timer& timer);
+
+            //! @internal Removes the timer from the heap
+            void timerHeapErase(Timer& timer);
+
+            //! @internal
+            void timerHeapUp(std::size_t n);
 
             //! @internal
-            TimerMap _timers;
+            void timerHeapDown(std::size_t n);
+
+            //! @internal Binary min heap of active timers ordered by expiry
+            typedef std::vector<TimerEntry> TimerHeap;
+
+            //! @internal
+            TimerHeap _timers;
+
+            //! @internal keeps the insertion order of timers expiring at the same time
+            uint64_t _timerSerial;
     };
 
     class Selector : public SelectorBase
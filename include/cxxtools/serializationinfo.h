@@ -110,6 +110,7 @@ namespace cxxtools
 class SerializationInfo
 {
         typedef std::deque<SerializationInfo> Nodes;
+        class MemberIndex;
         friend void operator <<=(SerializationInfo& si, const SerializationInfo& ssi);
 
     public:
@@ -185,6 +186,8 @@ class SerializationInfo
         void setName(const std::string& name)
         {
             _name = name;
+            if (_owner)
+                _nameChanged();
         }
 
         /** @brief Serialization of flat data-types
@@ -321,7 +324,7 @@ class SerializationInfo
 
         size_t memberCount() const
         {
-            return nodes().size();
+            return _size;
         }
 
         Iterator begin()
@@ -331,7 +334,7 @@ class SerializationInfo
 
         Iterator end()
         {
-            return nodes().end();
+            return nodes().begin() + _size;
         }
 
         ConstIterator begin() const
@@ -341,11 +344,22 @@ class SerializationInfo
 
         ConstIterator end() const
         {
-            return nodes().end();
+            return nodes().begin() + _size;
         }
 
         void clear();
 
+        /** @brief Removes all members and the value but keeps the storage
+
+            The member nodes with their names and type names are kept and
+            reused by subsequent calls to addMember, recursively. This makes it
+            possible to build a new tree into the same object again and again,
+            e.g. once per request on a connection, without allocating memory
+            for each node. The storage is released by clear() or when the
+            object is destroyed.
+         */
+        void reset();
+
         void swap(SerializationInfo& si);
 
         bool isNull() const       { return _t == t_none && (_category == Void || _category == Value); }
@@ -388,6 +402,9 @@ class SerializationInfo
         long double _getLongDouble() const;
         Nodes& nodes();
         const Nodes& nodes() const;
+        void _createIndex();
+        void _nameChanged();
+        void _reset();
         // assignment without name
         void assignData(const SerializationInfo& si);
 
@@ -426,14 +443,20 @@ class SerializationInfo
           t_ldouble
         } _t;
 
-        Nodes* _nodes;             // objects/arrays
+        Nodes* _nodes;             // objects/arrays; may hold unused nodes after reset()
+        Nodes::size_type _size;    // number of used nodes
+        MemberIndex* _index;       // name lookup index for objects with many members
+        MemberIndex* _owner;       // index of the parent, which is notified about renames
 };
 
 
 inline SerializationInfo::SerializationInfo()
 : _category(Void),
   _t(t_none),
-  _nodes(0)
+  _nodes(0),
+  _size(0),
+  _index(0),
+  _owner(0)
 { }
 
 
@@ -31,17 +31,54 @@
 
 #include <cxxtools/callable.h>
 #include <cxxtools/timespan.h>
+#include <vector>
+#include <stdexcept>
+#include <cstddef>
+
+#if __cplusplus >= 201103L
+#include <exception>
+#include <type_traits>
+#include <utility>
+#endif
 
 namespace cxxtools
 {
     class ThreadPoolImpl;
 
+    /**
+        A pool of threads, which process scheduled jobs.
+
+        Each thread has its own queue of jobs. Jobs scheduled from outside
+        are distributed round robin to the queues, jobs scheduled from a
+        thread of the pool are put into the queue of that thread. A thread
+        processes the jobs of its own queue in the order they were
+        scheduled. When its queue is empty, it takes the oldest job from
+        the queue of another thread.
+     */
     class ThreadPool
     {
             ThreadPool(const ThreadPool&) { }
             ThreadPool& operator=(const ThreadPool&) { return *this; }
 
         public:
+            /**
+                The Job is the unit of work processed by the thread pool.
+
+                Most users do not need to implement it, since the schedule
+                methods wrap callables into jobs.
+             */
+            class Job
+            {
+                public:
+                    virtual ~Job() { }
+
+                    /// Runs the job in a thread of the pool.
+                    virtual void run() = 0;
+
+                    /// Is called in the exception handler, when run throws.
+                    virtual void fail() { }
+            };
+
             /**
                 The Future class monitors the state of a job, which runs in the thread pool.
 
@@ -103,6 +140,164 @@ namespace cxxtools
 
             };
 
+            /**
+                A job, which keeps the return value of its computation.
+
+                When run throws and C++11 is available, the exception is kept
+                and rethrown by Result::get.
+             */
+            template <typename R>
+            class ResultJob : public Job
+            {
+                    R _value;
+#if __cplusplus >= 201103L
+                    std::exception_ptr _exception;
+#endif
+
+                protected:
+                    virtual R compute() = 0;
+
+                public:
+                    ResultJob()
+                        : _value()
+                    { }
+
+                    virtual void run()
+                    { _value = compute(); }
+
+                    virtual void fail()
+                    {
+#if __cplusplus >= 201103L
+                        _exception = std::current_exception();
+#endif
+                    }
+
+                    void rethrow() const
+                    {
+#if __cplusplus >= 201103L
+                        if (_exception)
+                            std::rethrow_exception(_exception);
+#endif
+                        throw std::runtime_error("job failed");
+                    }
+
+                    const R& value() const
+                    { return _value; }
+            };
+
+            /**
+                A future of a job with a return value.
+
+                The return value is kept by the job, which lives as long as
+                any future of it.
+             */
+            template <typename R>
+            class Result : public Future
+            {
+                    const ResultJob<R>* _job;
+
+                public:
+                    Result()
+                        : _job(0)
+                    { }
+
+                    Result(const Future& f, const ResultJob<R>* job)
+                        : Future(f),
+                          _job(job)
+                    { }
+
+                    /** Waits for the job and returns its value.
+
+                        When the job failed, the exception is rethrown. When
+                        it was canceled, a std::runtime_error is thrown.
+                     */
+                    const R& get() const
+                    {
+                        wait();
+                        if (isCanceled())
+                            throw std::runtime_error("job canceled");
+                        if (isFailed())
+                            _job->rethrow();
+                        return _job->value();
+                    }
+            };
+
+            /// The body of a parallel for loop processes the range [begin, end).
+            class RangeJob
+            {
+                public:
+                    virtual ~RangeJob() { }
+                    virtual void run(std::size_t begin, std::size_t end) = 0;
+            };
+
+        private:
+            template <typename R>
+            class CallableJob : public ResultJob<R>
+            {
+                    Callable<R>* _callable;
+
+                    CallableJob(const CallableJob&);
+                    CallableJob& operator=(const CallableJob&);
+
+                protected:
+                    virtual R compute()
+                    { return (*_callable)(); }
+
+                public:
+                    explicit CallableJob(const Callable<R>& cb)
+                        : _callable(cb.clone())
+                    { }
+
+                    ~CallableJob()
+                    { delete _callable; }
+            };
+
+            class CallableRangeJob : public RangeJob
+            {
+                    const Callable<void, std::size_t, std::size_t>& _body;
+
+                public:
+                    explicit CallableRangeJob(const Callable<void, std::size_t, std::size_t>& body)
+                        : _body(body)
+                    { }
+
+                    virtual void run(std::size_t begin, std::size_t end)
+                    { _body(begin, end); }
+            };
+
+#if __cplusplus >= 201103L
+            template <typename F, typename R>
+            class FunctionJob : public ResultJob<R>
+            {
+                    F _function;
+
+                protected:
+                    virtual R compute()
+                    { return _function(); }
+
+                public:
+                    template <typename G>
+                    explicit FunctionJob(G&& function)
+                        : _function(std::forward<G>(function))
+                    { }
+            };
+
+            template <typename F>
+            class FunctionRangeJob : public RangeJob
+            {
+                    F& _body;
+
+                public:
+                    explicit FunctionRangeJob(F& body)
+                        : _body(body)
+                    { }
+
+                    virtual void run(std::size_t begin, std::size_t end)
+                    { _body(begin, end); }
+            };
+#endif
+
+        public:
             /** @brief Creates a thread pool structure.
 
                 When the argument \a doStart is set to true (which is the
@@ -135,6 +330,75 @@ namespace cxxtools
              */
             Future schedule(const Callable<void>& cb);
 
+            /** @brief Schedules a task, which returns a value.
+
+                The value is fetched with Result::get.
+             */
+            template <typename R>
+            Result<R> schedule(const Callable<R>& cb)
+            {
+                ResultJob<R>* job = new CallableJob<R>(cb);
+                return Result<R>(scheduleJob(job), job);
+            }
+
+#if __cplusplus >= 201103L
+            /** @brief Schedules a function object, which may be move only.
+
+                Function objects returning void are scheduled like callables.
+             */
+            template <typename F,
+                      typename R = decltype(std::declval<typename std::decay<F>::type&>()()),
+                      typename = typename std::enable_if<
+                          !std::is_base_of<Callable<void>, typename std::decay<F>::type>::value>::type>
+            Result<R> schedule(F&& function)
+            {
+                ResultJob<R>* job = new FunctionJob<typename std::decay<F>::type, R>(std::forward<F>(function));
+                return Result<R>(scheduleJob(job), job);
+            }
+#endif
+
+            /** @brief Schedules a job. The thread pool takes the ownership.
+             */
+            Future scheduleJob(Job* job);
+
+            /** @brief Schedules many jobs at once.
+
+                The thread pool takes the ownership of the jobs. The jobs are
+                distributed to the threads with one lock per thread instead of
+                one per job. The futures are returned in the order of the jobs.
+             */
+            std::vector<Future> scheduleBatch(const std::vector<Job*>& jobs);
+
+            /** @brief Runs body for all indexes in [begin, end) and waits for it.
+
+                The range is split into chunks of \a grain indexes, which are
+                passed to body as begin and end of the chunk. The calling
+                thread processes chunks as well. When grain is 0, a size
+                giving each thread some chunks is chosen. The first exception
+                thrown by body is rethrown, when all chunks are done.
+             */
+            void parallelFor(std::size_t begin, std::size_t end,
+                             const Callable<void, std::size_t, std::size_t>& body,
+                             std::size_t grain = 0)
+            {
+                CallableRangeJob job(body);
+                parallelFor(begin, end, job, grain);
+            }
+
+#if __cplusplus >= 201103L
+            template <typename F,
+                      typename = typename std::enable_if<
+                          !std::is_base_of<RangeJob, typename std::decay<F>::type>::value>::type>
+            void parallelFor(std::size_t begin, std::size_t end, F&& body, std::size_t grain = 0)
+            {
+                FunctionRangeJob<typename std::remove_reference<F>::type> job(body);
+                parallelFor(begin, end, job, grain);
+            }
+#endif
+
+            /// Runs the range job for all indexes in [begin, end) and waits for it.
+            void parallelFor(std::size_t begin, std::size_t end, RangeJob& body, std::size_t grain = 0);
+
             /** @brief Returns true, if the threadpool is in running state.
              */
             bool running() const;
@@ -146,6 +410,67 @@ namespace cxxtools
         private:
             ThreadPoolImpl* _impl;
     };
+
+    template <>
+    class ThreadPool::ResultJob<void> : public ThreadPool::Job
+    {
+#if __cplusplus >= 201103L
+            std::exception_ptr _exception;
+#endif
+
+        protected:
+            virtual void compute() = 0;
+
+        public:
+            virtual void run()
+            { compute(); }
+
+            virtual void fail()
+            {
+#if __cplusplus >= 201103L
+                _exception = std::current_exception();
+#endif
+            }
+
+            void rethrow() const
+            {
+#if __cplusplus >= 201103L
+                if (_exception)
+                    std::rethrow_exception(_exception);
+#endif
+                throw std::runtime_error("job failed");
+            }
+    };
+
+    template <>
+    class ThreadPool::Result<void> : public ThreadPool::Future
+    {
+            const ResultJob<void>* _job;
+
+        public:
+            Result()
+                : _job(0)
+            { }
+
+            Result(const Future& f, const ResultJob<void>* job)
+                : Future(f),
+                  _job(job)
+            { }
+
+            /** Waits for the job.
+
+                When the job failed, the exception is rethrown. When it was
+                canceled, a std::runtime_error is thrown.
+             */
+            void get() const
+            {
+                wait();
+                if (isCanceled())
+                    throw std::runtime_error("job canceled");
+                if (isFailed())
+                    _job->rethrow();
+            }
+    };
 }
 
 #endif // CXXTOOLS_THREADPOOL_H
@@ -28,6 +28,7 @@
 
 #include <cxxtools/signal.h>
 #include <cxxtools/timespan.h>
+#include <cstddef>
 
 namespace cxxtools {
 
@@ -69,6 +70,7 @@ namespace cxxtools {
     */
     class Timer
     {
+        friend class SelectorBase;
         class Sentry;
 
         public:
@@ -198,6 +200,10 @@ namespace cxxtools {
             Timespan      _interval;
             Timespan      _finished;
             bool          _once;
+
+            // position in the timer heap of the selector
+            static const std::size_t NoHeapIndex = static_cast<std::size_t>(-1);
+            std::size_t   _heapIndex;
     };
 
 }
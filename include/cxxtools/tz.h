@@ -30,6 +30,7 @@
 
 #include <cxxtools/datetime.h>
 #include <stdexcept>
+#include <cstddef>
 #include <string>
 #include <iosfwd>
 
@@ -131,6 +132,11 @@ public:
     /// Interprets the specified date time as UTC and returns the time zoned date and time.
     TzDateTime toLocal(const UtcDateTime& dt) const;
 
+    /// Converts `count` UTC times to local times.
+    /// Conversions of times in the same period as the previous one do not
+    /// search the transitions again.
+    void toLocal(const UtcDateTime* utc, LocalDateTime* local, std::size_t count) const;
+
     /// Returns the first UTC time witch matches the specified date time in the time zone.
     UtcDateTime toUtc(const LocalDateTime& dt) const;
 
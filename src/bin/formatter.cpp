@@ -77,6 +77,20 @@ namespace
                                  "                " // d0-df
                                  "                " // e0-ef
                                  "                "; // f0-ff
+
+    // FNV-1a
+    std::size_t hashString(const std::string& s)
+    {
+        uint32_t h = 2166136261u;
+        for (std::string::const_iterator it = s.begin(); it != s.end(); ++it)
+        {
+            h ^= static_cast<unsigned char>(*it);
+            h *= 16777619u;
+        }
+        return h;
+    }
+
+    const unsigned maxDictionarySize = 0x10000;
 }
 
 Formatter::Formatter()
@@ -92,20 +106,28 @@ Formatter::Formatter(std::ostream& out)
     begin(out);
 }
 
-void Formatter::begin(std::ostream& out)
+void Formatter::begin(std::ostream& out, bool resetDictionary)
 {
     _out = &out;
     _ts.attach(out);
-    _dictionary.clear();
+    if (resetDictionary)
+        clearDictionary();
 }
 
-void Formatter::finish()
+void Formatter::finish(bool resetDictionary)
 {
     _ts.detach();
-    _dictionary.clear();
+    if (resetDictionary)
+        clearDictionary();
     _out = 0;
 }
 
+void Formatter::clearDictionary()
+{
+    _dictionary.clear();
+    _dictionaryIndex.clear();
+}
+
 void Formatter::addValueString(const std::string& name, const std::string& type,
                       const cxxtools::String& value)
 {
@@ -905,9 +927,27 @@ void Formatter::outputString(const std::string& value)
         return;
     }
 
-    unsigned idx;
-    for (idx = 0; idx < _dictionary.size(); ++idx)
+    // keep the table at most half full
+    if (_dictionaryIndex.size() < 2 * (_dictionary.size() + 1)
+        && _dictionary.size() < maxDictionarySize)
+    {
+        std::vector<unsigned> index(_dictionaryIndex.empty() ? 64 : 2 * _dictionaryIndex.size(), 0);
+        std::size_t mask = index.size() - 1;
+        for (unsigned n = 0; n < _dictionary.size(); ++n)
+        {
+            std::size_t i = hashString(_dictionary[n]) & mask;
+            while (index[i] != 0)
+                i = (i + 1) & mask;
+            index[i] = n + 1;
+        }
+        _dictionaryIndex.swap(index);
+    }
+
+    std::size_t mask = _dictionaryIndex.size() - 1;
+    std::size_t i;
+    for (i = hashString(value) & mask; _dictionaryIndex[i] != 0; i = (i + 1) & mask)
     {
+        unsigned idx = _dictionaryIndex[i] - 1;
         if (_dictionary[idx] == value)
         {
             log_debug("use dictionary value \"" << value << "\" idx=" << idx);
@@ -918,9 +958,10 @@ void Formatter::outputString(const std::string& value)
         }
     }
 
-    if (_dictionary.size() <= 0xffff)
+    if (_dictionary.size() < maxDictionarySize)
     {
         log_debug("add dictionary value \"" << value << "\" idx=" << _dictionary.size());
+        _dictionaryIndex[i] = _dictionary.size() + 1;
         _dictionary.push_back(value);
     }
 
@@ -127,7 +127,10 @@ void Parser::begin(Deserializer& handler, bool resetDictionary)
     _next = 0;
 
     if (resetDictionary)
+    {
         _mydictionary.clear();
+        _mydictionaryIndex.clear();
+    }
 }
 
 void Parser::finish()
@@ -483,13 +486,13 @@ bool Parser::advance(std::streambuf& in, bool atLeastOne)
                 break;
 
             case state_name_idx0:
-                _dictidx = static_cast<unsigned>(ch) << 8;
+                _dictidx = static_cast<unsigned>(static_cast<unsigned char>(ch)) << 8;
                 _state = state_name_idx1;
                 in.sbumpc();
                 break;
 
             case state_name_idx1:
-                _dictidx |= static_cast<unsigned>(ch);
+                _dictidx |= static_cast<unsigned char>(ch);
                 if (_dictidx >= _dictionary->size())
                 {
                     log_error("invalid dictionary index " << _dictidx);
@@ -528,14 +531,14 @@ bool Parser::advance(std::streambuf& in, bool atLeastOne)
 
             case state_value_type_other_idx0:
             case state_value_type_bcd_idx0:
-                _dictidx = static_cast<unsigned>(ch) << 8;
+                _dictidx = static_cast<unsigned>(static_cast<unsigned char>(ch)) << 8;
                 _state = (_state == state_value_type_bcd_idx0 ? state_value_type_bcd_idx1 : state_value_type_other_idx1);
                 in.sbumpc();
                 break;
 
             case state_value_type_other_idx1:
             case state_value_type_bcd_idx1:
-                _dictidx |= static_cast<unsigned>(ch);
+                _dictidx |= static_cast<unsigned char>(ch);
                 if (_dictidx >= _dictionary->size())
                 {
                     log_error("invalid dictionary index " << _dictidx);
@@ -813,13 +816,13 @@ bool Parser::advance(std::streambuf& in, bool atLeastOne)
                 break;
 
             case state_object_type_other_idx0:
-                _dictidx = static_cast<unsigned>(ch) << 8;
+                _dictidx = static_cast<unsigned>(static_cast<unsigned char>(ch)) << 8;
                 _state = state_object_type_other_idx1;
                 in.sbumpc();
                 break;
 
             case state_object_type_other_idx1:
-                _dictidx |= static_cast<unsigned>(ch);
+                _dictidx |= static_cast<unsigned char>(ch);
                 if (_dictidx >= _dictionary->size())
                 {
                     log_error("invalid dictionary index " << _dictidx);
@@ -843,7 +846,7 @@ bool Parser::advance(std::streambuf& in, bool atLeastOne)
                 }
 
                 if (_next == 0)
-                    _next = new Parser(_dictionary);
+                    _next = new Parser(_dictionary, _dictionaryIndex);
 
                 if (_deserializer)
                 {
@@ -906,13 +909,13 @@ bool Parser::advance(std::streambuf& in, bool atLeastOne)
                 break;
 
             case state_array_type_other_idx0:
-                _dictidx = static_cast<unsigned>(ch) << 8;
+                _dictidx = static_cast<unsigned>(static_cast<unsigned char>(ch)) << 8;
                 _state = state_array_type_other_idx1;
                 in.sbumpc();
                 break;
 
             case state_array_type_other_idx1:
-                _dictidx |= static_cast<unsigned>(ch);
+                _dictidx |= static_cast<unsigned char>(ch);
                 if (_dictidx >= _dictionary->size())
                 {
                     log_error("invalid dictionary index " << _dictidx);
@@ -935,7 +938,7 @@ bool Parser::advance(std::streambuf& in, bool atLeastOne)
                 }
 
                 if (_next == 0)
-                    _next = new Parser(_dictionary);
+                    _next = new Parser(_dictionary, _dictionaryIndex);
 
                 if (_deserializer)
                 {
@@ -1044,15 +1047,13 @@ bool Parser::processFloatBase(char ch, unsigned shift, unsigned expOffset)
 
 void Parser::dict(const std::string& value)
 {
-    if (value.empty())
+    // Our formatter sends a string literally only when it is not in its
+    // dictionary, but other peers may send known strings again. Those must
+    // not get a new index.
+    if (value.empty() || _dictionary->size() >= 0x10000
+        || !_dictionaryIndex->insert(value).second)
         return;
 
-    for (unsigned idx = 0; idx < _dictionary->size(); ++idx)
-    {
-        if ((*_dictionary)[idx] == value)
-            return;
-    }
-
     log_debug("add dictionary value \"" << value << "\" idx=" << _dictionary->size());
     _dictionary->push_back(value);
 }
@@ -50,9 +50,10 @@ void Responder::reply(IOStream& out)
     log_info("send reply");
 
     out << '\xc1';
-    _formatter.begin(out);
+    _formatter.begin(out, _resetReplyDictionary);
+    _resetReplyDictionary = !_keepDictionary;
     _result->format(_formatter);
-    _formatter.finish();
+    _formatter.finish(!_keepDictionary);
     out << '\xff';
 }
 
@@ -60,6 +61,9 @@ void Responder::replyError(IOStream& out, const char* msg, int rc)
 {
     log_info("send error \"" << msg << '"');
 
+    // the client discards its reply dictionary on errors
+    _resetReplyDictionary = true;
+
     out << '\xc2'
         << static_cast<char>(static_cast<uint32_t>(rc) >> 24)
         << static_cast<char>(static_cast<uint32_t>(rc) >> 16)
@@ -75,7 +79,13 @@ bool Responder::onInput(IOStream& ios)
     {
         if (advance(ios.buffer()))
         {
-            if (_failed)
+            if (_handshake)
+            {
+                log_info("keep dictionary on this connection");
+                _keepDictionary = true;
+                ios << '\xc1' << '\xff';
+            }
+            else if (_failed)
             {
                 replyError(ios, _errorMessage.c_str(), 0);
             }
@@ -104,8 +114,9 @@ bool Responder::onInput(IOStream& ios)
             _result = 0;
             _state = state_0;
             _failed = false;
+            _handshake = false;
             _errorMessage.clear();
-            _deserializer.begin();
+            _deserializer.begin(!_keepDictionary);
 
             return true;
         }
@@ -148,6 +159,15 @@ bool Responder::advance(std::streambuf& in)
             case state_method:
                 if (ch == '\0')
                 {
+                    if (_methodName.empty() && _domain.empty())
+                    {
+                        log_debug("dictionary handshake");
+                        _handshake = true;
+                        _state = state_params_skip;
+                        in.sbumpc();
+                        break;
+                    }
+
                     log_info("rpc method \"" << _methodName << '"');
 
                     _proc = _serviceRegistry.getProcedure(_domain.empty() ? _methodName : _domain + '\0' + _methodName);
@@ -70,7 +70,10 @@ class Responder
               _proc(0),
               _args(0),
               _result(0),
-              _failed(false)
+              _failed(false),
+              _handshake(false),
+              _keepDictionary(false),
+              _resetReplyDictionary(true)
         { }
 
         ~Responder();
@@ -95,6 +98,12 @@ class Responder
 
         bool _failed;
         std::string _errorMessage;
+
+        // The client may request with an empty method name to keep the
+        // dictionaries of the parser and formatter for the whole connection.
+        bool _handshake;
+        bool _keepDictionary;
+        bool _resetReplyDictionary;
 };
 }
 }
@@ -212,6 +212,16 @@ void RpcClient::domain(const std::string& p)
     getImpl()->domain(p);
 }
 
+bool RpcClient::keepDictionary() const
+{
+    return getImpl()->keepDictionary();
+}
+
+void RpcClient::keepDictionary(bool sw)
+{
+    getImpl()->keepDictionary(sw);
+}
+
 Delegate<bool, const SslCertificate&>& RpcClient::acceptSslCertificate()
 {
     return getImpl()->socket().acceptSslCertificate;
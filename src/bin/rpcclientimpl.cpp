@@ -45,6 +45,8 @@ RpcClientImpl::RpcClientImpl()
     : _stream(_socket, 8192, true),
       _ssl(false),
       _sslVerifyLevel(0),
+      _keepDictionary(false),
+      _dictionaryState(dictionary_off),
       _exceptionPending(false),
       _proc(0),
       _timeout(Selectable::WaitInfinite),
@@ -69,6 +71,8 @@ void RpcClientImpl::connect()
         _socket.setSslVerify(_sslVerifyLevel, _sslCa);
         _socket.sslConnect();
     }
+
+    newConnection();
 }
 
 void RpcClientImpl::close()
@@ -86,11 +90,15 @@ void RpcClientImpl::beginCall(IComposer& r, IRemoteProcedure& method, IDecompose
 
     _proc = &method;
 
+    bool connected = _socket.isConnected();
+    if (!connected)
+        newConnection();
+
     prepareRequest(method.name(), argv, argc);
 
     try
     {
-        if (_socket.isConnected())
+        if (connected)
         {
             try
             {
@@ -99,6 +107,14 @@ void RpcClientImpl::beginCall(IComposer& r, IRemoteProcedure& method, IDecompose
             catch (const IOError&)
             {
                 log_debug("write failed, connection is not active any more");
+                if (_dictionaryState == dictionary_on)
+                {
+                    // the request refers to the dictionary of the lost connection
+                    _stream.buffer().discard();
+                    newConnection();
+                    prepareRequest(method.name(), argv, argc);
+                }
+
                 _socket.beginConnect(_addrInfo);
             }
         }
@@ -120,13 +136,15 @@ void RpcClientImpl::beginCall(IComposer& r, IRemoteProcedure& method, IDecompose
             throw;
     }
 
-    _scanner.begin(_deserializer, r);
+    _scanner.begin(_deserializer, r, _dictionaryState != dictionary_on);
+    if (_dictionaryState == dictionary_pending)
+        _scanner.expectHandshake();
 }
 
 void RpcClientImpl::endCall()
 {
     _proc = 0;
-    _formatter.finish();
+    _formatter.finish(_dictionaryState != dictionary_on);
 
     if (_exceptionPending)
     {
@@ -171,6 +189,7 @@ void RpcClientImpl::call(IComposer& r, IRemoteProcedure& method, IDecomposer** a
         if (!_socket.isConnected())
         {
             log_debug("socket is not connected");
+            newConnection();
             _socket.setTimeout(_connectTimeout);
             _socket.connect(_addrInfo);
             if (_ssl)
@@ -186,7 +205,9 @@ void RpcClientImpl::call(IComposer& r, IRemoteProcedure& method, IDecomposer** a
             sb.pubsync();
         }
 
-        _scanner.begin(_deserializer, r);
+        _scanner.begin(_deserializer, r, _dictionaryState != dictionary_on);
+        if (_dictionaryState == dictionary_pending)
+            _scanner.expectHandshake();
 
         while (true)
         {
@@ -199,6 +220,7 @@ void RpcClientImpl::call(IComposer& r, IRemoteProcedure& method, IDecomposer** a
             if (_scanner.advance(sb))
             {
                 _proc = 0;
+                replyReceived();
                 _scanner.finish();
                 break;
             }
@@ -249,9 +271,40 @@ void RpcClientImpl::wait(Timespan timeout)
     }
 }
 
+void RpcClientImpl::keepDictionary(bool sw)
+{
+    if (sw == _keepDictionary)
+        return;
+
+    // the server may already keep its dictionary for this connection
+    _keepDictionary = sw;
+    _socket.close();
+    newConnection();
+}
+
+void RpcClientImpl::newConnection()
+{
+    _dictionaryState = _keepDictionary ? dictionary_request : dictionary_off;
+}
+
+void RpcClientImpl::replyReceived()
+{
+    if (_dictionaryState == dictionary_pending)
+        _dictionaryState = _scanner.handshakeAccepted() ? dictionary_on : dictionary_off;
+}
+
 void RpcClientImpl::prepareRequest(const String& name, IDecomposer** argv, unsigned argc)
 {
-    _formatter.begin(_stream);
+    if (_dictionaryState == dictionary_request)
+    {
+        // A request with an empty method name asks the server to keep the
+        // dictionaries on this connection. Servers not knowing it reply
+        // with an error and we continue without.
+        _stream << '\xc0' << '\0' << '\xff';
+        _dictionaryState = dictionary_pending;
+    }
+
+    _formatter.begin(_stream, _dictionaryState != dictionary_on);
     if (_domain.empty())
         _stream << '\xc0' << name << '\0';
     else
@@ -367,6 +420,7 @@ void RpcClientImpl::onInput(StreamBuffer& sb)
 
         if (_scanner.advance(sb))
         {
+            replyReceived();
             _scanner.finish();
             IRemoteProcedure* proc = _proc;
             _proc = 0;
@@ -112,7 +112,14 @@ class RpcClientImpl : public RefCounted, public Connectable
         void domain(const std::string& p)
         { _domain = p; }
 
+        bool keepDictionary() const
+        { return _keepDictionary; }
+
+        void keepDictionary(bool sw);
+
     private:
+        void newConnection();
+        void replyReceived();
         void prepareRequest(const String& name, IDecomposer** argv, unsigned argc);
         void onConnect(net::TcpSocket& socket);
         void onSslConnect(net::TcpSocket& socket);
@@ -135,6 +142,15 @@ class RpcClientImpl : public RefCounted, public Connectable
         Deserializer _deserializer;
         Formatter _formatter;
 
+        bool _keepDictionary;
+        enum
+        {
+            dictionary_off,
+            dictionary_request,     // handshake to be sent with the next request
+            dictionary_pending,     // handshake sent; waiting for reply
+            dictionary_on
+        } _dictionaryState;
+
         bool _exceptionPending;
         IRemoteProcedure* _proc;
 
@@ -40,9 +40,9 @@ namespace cxxtools
 namespace bin
 {
 
-void Scanner::begin(Deserializer& handler, IComposer& composer)
+void Scanner::begin(Deserializer& handler, IComposer& composer, bool resetDictionary)
 {
-    _vp.begin(handler);
+    _vp.begin(handler, resetDictionary);
     _deserializer = &handler;
     _composer = &composer;
     _deserializer->begin();
@@ -68,6 +68,8 @@ bool Scanner::advance(std::streambuf& in)
                 }
                 else if (ch == '\xc2')
                 {
+                    // the server starts a new dictionary after an error
+                    _vp.begin(*_deserializer);
                     _failed = true;
                     _state = state_errorcode;
                     _count = 4;
@@ -113,6 +115,47 @@ bool Scanner::advance(std::streambuf& in)
                 else
                     throw std::runtime_error("end of response marker expected");
                 break;
+
+            case state_handshake:
+                // servers, which do not support the handshake, reply with an error
+                if (ch == '\xc1')
+                {
+                    _handshakeAccepted = true;
+                    _state = state_handshake_end;
+                }
+                else if (ch == '\xc2')
+                {
+                    _state = state_handshake_errorcode;
+                    _count = 4;
+                }
+                else
+                    throw std::runtime_error("response expected");
+
+                in.sbumpc();
+                break;
+
+            case state_handshake_errorcode:
+                if (--_count == 0)
+                    _state = state_handshake_errormessage;
+                in.sbumpc();
+                break;
+
+            case state_handshake_errormessage:
+                if (ch == '\0')
+                    _state = state_handshake_end;
+                in.sbumpc();
+                break;
+
+            case state_handshake_end:
+                if (ch == '\xff')
+                {
+                    log_debug("dictionary handshake " << (_handshakeAccepted ? "accepted" : "refused"));
+                    _state = state_0;
+                    in.sbumpc();
+                }
+                else
+                    throw std::runtime_error("end of response marker expected");
+                break;
         }
     }
 
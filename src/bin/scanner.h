@@ -50,10 +50,18 @@ namespace cxxtools
                       _composer(0),
                       _count(0),
                       _failed(false),
-                      _errorCode(0)
+                      _errorCode(0),
+                      _handshakeAccepted(false)
                 { }
 
-                void begin(Deserializer& handler, IComposer& composer);
+                void begin(Deserializer& handler, IComposer& composer, bool resetDictionary = true);
+
+                // The reply to a dictionary handshake precedes the actual reply.
+                void expectHandshake()
+                { _state = state_handshake; _handshakeAccepted = false; }
+
+                bool handshakeAccepted() const
+                { return _handshakeAccepted; }
 
                 bool advance(std::streambuf& in);
 
@@ -66,7 +74,11 @@ namespace cxxtools
                     state_value,
                     state_errorcode,
                     state_errormessage,
-                    state_end
+                    state_end,
+                    state_handshake,
+                    state_handshake_errorcode,
+                    state_handshake_errormessage,
+                    state_handshake_end
                 } _state;
 
                 Parser _vp;
@@ -78,6 +90,7 @@ namespace cxxtools
                 bool _failed;
                 int _errorCode;
                 std::string _errorMessage;
+                bool _handshakeAccepted;
         };
     }
 }
@@ -30,6 +30,12 @@
 #include <iomanip>
 #include <limits>
 #include <cctype>
+#include <clocale>
+#include <cstdlib>
+#include <cstring>
+#include <stdint.h>
+#include <stdlib.h>
+#include <unistd.h>
 
 namespace cxxtools
 {
@@ -97,9 +103,287 @@ class nullterm_array_iterator : public std::iterator<std::input_iterator_tag, T>
         const T* _ptr;
 };
 
+//
+// Fast paths for parsing plain decimal numbers
+//
+// These handle the common case of a number with optional surrounding
+// whitespace without going through iterators and formats. Whenever the
+// input does not match or is out of range, the caller falls back to getInt
+// or getFloat, so results and errors for unusual input do not change.
+//
+
+namespace
+{
+    inline uint32_t charValue(char ch)
+    { return static_cast<unsigned char>(ch); }
+
+    inline uint32_t charValue(Char ch)
+    { return static_cast<uint32_t>(ch.value()); }
+
+    template <typename CharT>
+    inline bool isSpace(CharT ch)
+    {
+        uint32_t c = charValue(ch);
+        return c == ' ' || (c >= '\t' && c <= '\r');
+    }
+
+    // returns the digit value or a value greater than 9 for non digits
+    template <typename CharT>
+    inline uint32_t digitValue(CharT ch)
+    { return charValue(ch) - '0'; }
+
+    template <typename CharT>
+    const CharT* skipSpace(const CharT* p, const CharT* end)
+    {
+        while (p != end && isSpace(*p))
+            ++p;
+        return p;
+    }
+
+    template <typename CharT, typename T>
+    bool parseInt(const CharT* p, const CharT* end, T& n)
+    {
+        typedef typename IntTraits<T>::Unsigned UnsignedInt;
+
+        p = skipSpace(p, end);
+        if (p == end)
+            return false;
+
+        bool neg = false;
+        if (charValue(*p) == '-')
+        {
+            if (!std::numeric_limits<T>::is_signed)
+                return false;
+            neg = true;
+            ++p;
+        }
+        else if (charValue(*p) == '+')
+            ++p;
+
+        UnsignedInt max = static_cast<UnsignedInt>(std::numeric_limits<T>::max());
+        if (neg)
+            max += 1u;  // abs(min)
+
+        const CharT* digits = p;
+        UnsignedInt u = 0;
+        for ( ; p != end; ++p)
+        {
+            uint32_t d = digitValue(*p);
+            if (d > 9)
+                break;
+
+            if (u > (max - d) / 10u)
+                return false;
+
+            u = static_cast<UnsignedInt>(u * 10u + d);
+        }
+
+        if (p == digits || skipSpace(p, end) != end)
+            return false;
+
+        n = neg ? static_cast<T>(0u - u) : static_cast<T>(u);
+        return true;
+    }
+
+    template <typename T>
+    struct FastFloat;
+
+    template <>
+    struct FastFloat<float>
+    {
+        static const int maxExp10 = 10;
+    };
+
+    template <>
+    struct FastFloat<double>
+    {
+        static const int maxExp10 = 22;
+    };
+
+    template <typename T>
+    struct StrToFloat;
+
+    template <>
+    struct StrToFloat<float>
+    {
+        static float convert(const char* s)
+        {
+            // rounding the result of strtod to float may round twice
+#if __cplusplus >= 201103L
+            return std::strtof(s, 0);
+#elif defined(_POSIX_VERSION) && _POSIX_VERSION >= 200112L
+            return ::strtof(s, 0);
+#else
+            return static_cast<float>(std::strtod(s, 0));
+#endif
+        }
+    };
+
+    template <>
+    struct StrToFloat<double>
+    {
+        static double convert(const char* s)
+        { return std::strtod(s, 0); }
+    };
+
+    template <typename T>
+    T exactPow10(int e)
+    {
+        static const T pow10[] = {
+            1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10,
+            1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20,
+            1e21, 1e22
+        };
+        return pow10[e];
+    }
+
+    template <typename CharT, typename T>
+    bool parseFloat(const CharT* p, const CharT* end, T& n)
+    {
+        const CharT* begin = skipSpace(p, end);
+        p = begin;
+        if (p == end)
+            return false;
+
+        bool neg = false;
+        if (charValue(*p) == '-' || charValue(*p) == '+')
+        {
+            neg = charValue(*p) == '-';
+            ++p;
+        }
+
+        // collect up to 19 significant digits; the rest only count for the exponent
+        uint64_t m = 0;
+        unsigned significants = 0;
+        bool truncated = false;
+        long exp10 = 0;
+        unsigned count = 0;
+
+        for ( ; p != end && digitValue(*p) <= 9; ++p, ++count)
+        {
+            if (significants < 19)
+            {
+                m = m * 10 + digitValue(*p);
+                if (m > 0)
+                    ++significants;
+            }
+            else
+            {
+                ++exp10;
+                truncated = truncated || digitValue(*p) != 0;
+            }
+        }
+
+        if (p != end && charValue(*p) == '.')
+        {
+            for (++p; p != end && digitValue(*p) <= 9; ++p, ++count)
+            {
+                if (significants < 19)
+                {
+                    m = m * 10 + digitValue(*p);
+                    if (m > 0)
+                        ++significants;
+                    --exp10;
+                }
+                else
+                    truncated = truncated || digitValue(*p) != 0;
+            }
+        }
+
+        if (count == 0)
+            return false;
+
+        if (p != end && (charValue(*p) == 'e' || charValue(*p) == 'E'))
+        {
+            ++p;
+            bool negExp = false;
+            if (p != end && (charValue(*p) == '-' || charValue(*p) == '+'))
+            {
+                negExp = charValue(*p) == '-';
+                ++p;
+            }
+
+            if (p == end || digitValue(*p) > 9)
+                return false;
+
+            long e = 0;
+            for ( ; p != end && digitValue(*p) <= 9; ++p)
+            {
+                if (e < 100000)
+                    e = e * 10 + digitValue(*p);
+            }
+
+            exp10 += negExp ? -e : e;
+        }
+
+        const CharT* numberEnd = p;
+        if (skipSpace(p, end) != end)
+            return false;
+
+        // Clinger's fast path: mantissa and power of ten are exact, so the
+        // single multiplication or division is correctly rounded
+        if (!truncated
+            && m <= (uint64_t(1) << std::numeric_limits<T>::digits)
+            && exp10 >= -FastFloat<T>::maxExp10
+            && exp10 <= FastFloat<T>::maxExp10)
+        {
+            T v = static_cast<T>(m);
+            if (exp10 < 0)
+                v /= exactPow10<T>(static_cast<int>(-exp10));
+            else
+                v *= exactPow10<T>(static_cast<int>(exp10));
+            n = neg ? -v : v;
+            return true;
+        }
+
+        if (m == 0 && !truncated)
+        {
+            n = neg ? -T(0) : T(0);
+            return true;
+        }
+
+        // Let the C library round the remaining cases correctly. It uses the
+        // decimal point of the current locale, so it is only usable when this
+        // is a '.'.
+        const char* point = std::localeconv()->decimal_point;
+        if (point[0] != '.' || point[1] != '\0')
+            return false;
+
+        char buffer[64];
+        std::string str;
+        const char* s = buffer;
+        std::size_t len = numberEnd - begin;
+        if (len < sizeof(buffer))
+        {
+            for (std::size_t i = 0; i < len; ++i)
+                buffer[i] = static_cast<char>(charValue(begin[i]));
+            buffer[len] = '\0';
+        }
+        else
+        {
+            str.reserve(len);
+            for (p = begin; p != numberEnd; ++p)
+                str += static_cast<char>(charValue(*p));
+            s = str.c_str();
+        }
+
+        n = StrToFloat<T>::convert(s);
+        return true;
+    }
+
+    template <typename CharT>
+    bool parseFloat(const CharT*, const CharT*, long double&)
+    {
+        return false;
+    }
+}
+
 template <typename T>
 void convertInt(T& n, const String& str, const char* typeto)
 {
+    if (parseInt(str.data(), str.data() + str.size(), n))
+        return;
+
     bool ok = false;
     String::const_iterator r = getInt( str.begin(), str.end(), ok, n, DecimalFormat<Char>() );
 
@@ -114,6 +398,9 @@ void convertInt(T& n, const String& str, const char* typeto)
 template <typename T>
 void convertInt(T& n, const std::string& str, const char* typeto)
 {
+    if (parseInt(str.data(), str.data() + str.size(), n))
+        return;
+
     bool ok = false;
     std::string::const_iterator r = getInt( str.begin(), str.end(), ok, n );
 
@@ -128,6 +415,9 @@ void convertInt(T& n, const std::string& str, const char* typeto)
 template <typename T>
 void convertInt(T& n, const char* str, const char* typeto)
 {
+    if (parseInt(str, str + std::strlen(str), n))
+        return;
+
     bool ok = false;
     nullterm_array_iterator<char> it(str);
     nullterm_array_iterator<char> end;
@@ -143,6 +433,9 @@ void convertInt(T& n, const char* str, const char* typeto)
 template <typename T>
 void convertFloat(T& n, const String& str, const char* typeto)
 {
+    if (parseFloat(str.data(), str.data() + str.size(), n))
+        return;
+
     bool ok = false;
     String::const_iterator r = getFloat(str.begin(), str.end(), ok, n, FloatFormat<Char>() );
 
@@ -157,6 +450,9 @@ void convertFloat(T& n, const String& str, const char* typeto)
 template <typename T>
 void convertFloat(T& n, const std::string& str, const char* typeto)
 {
+    if (parseFloat(str.data(), str.data() + str.size(), n))
+        return;
+
     bool ok = false;
     std::string::const_iterator r = getFloat(str.begin(), str.end(), ok, n);
 
@@ -171,6 +467,9 @@ void convertFloat(T& n, const std::string& str, const char* typeto)
 template <typename T>
 void convertFloat(T& n, const char* str, const char* typeto)
 {
+    if (parseFloat(str, str + std::strlen(str), n))
+        return;
+
     bool ok = false;
     nullterm_array_iterator<char> it(str);
     nullterm_array_iterator<char> end;
@@ -183,6 +482,347 @@ void convertFloat(T& n, const char* str, const char* typeto)
         ConversionError::doThrow(typeto, "char*", str);
 }
 
+//
+// Shortest representation of floating point values
+//
+// This is the Grisu2 algorithm of Florian Loitsch ("Printing Floating-Point
+// Numbers Quickly and Accurately with Integers"). It finds digits within the
+// rounding interval of the value, so reading them back gives the same value.
+// The digits are the shortest ones for about 99.9% of the values; for the
+// others a digit more than needed is generated.
+//
+
+namespace
+{
+    struct DiyFp
+    {
+        uint64_t f;
+        int e;
+
+        DiyFp(uint64_t f_, int e_)
+            : f(f_), e(e_)
+        { }
+    };
+
+    // returns x * y rounded to the upper 64 bits
+    DiyFp mul(const DiyFp& x, const DiyFp& y)
+    {
+        const uint64_t mask = 0xFFFFFFFFu;
+
+        const uint64_t xLo = x.f & mask;
+        const uint64_t xHi = x.f >> 32;
+        const uint64_t yLo = y.f & mask;
+        const uint64_t yHi = y.f >> 32;
+
+        const uint64_t p0 = xLo * yLo;
+        const uint64_t p1 = xLo * yHi;
+        const uint64_t p2 = xHi * yLo;
+        const uint64_t p3 = xHi * yHi;
+
+        uint64_t q = (p0 >> 32) + (p1 & mask) + (p2 & mask);
+        q += uint64_t(1) << 31;  // round
+
+        return DiyFp(p3 + (p1 >> 32) + (p2 >> 32) + (q >> 32), x.e + y.e + 64);
+    }
+
+    DiyFp normalize(DiyFp x)
+    {
+        static const int shifts[] = { 32, 16, 8, 4, 2, 1 };
+        for (unsigned n = 0; n < sizeof(shifts) / sizeof(shifts[0]); ++n)
+        {
+            if ((x.f >> (64 - shifts[n])) == 0)
+            {
+                x.f <<= shifts[n];
+                x.e -= shifts[n];
+            }
+        }
+
+        return x;
+    }
+
+    DiyFp normalizeTo(const DiyFp& x, int e)
+    {
+        return DiyFp(x.f << (x.e - e), e);
+    }
+
+    // Computes the value and its boundaries m- and m+ (the middle to the
+    // neighbouring values) for double or float.
+    template <typename T, typename Bits>
+    void computeBoundaries(T value, DiyFp& v, DiyFp& mMinus, DiyFp& mPlus)
+    {
+        const int precision = std::numeric_limits<T>::digits;
+        const int bias = std::numeric_limits<T>::max_exponent - 1 + (precision - 1);
+        const int minExp = 1 - bias;
+        const uint64_t hiddenBit = uint64_t(1) << (precision - 1);
+
+        Bits bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+
+        const uint64_t fraction = bits & (hiddenBit - 1);
+        const int exponent = static_cast<int>(bits >> (precision - 1));
+
+        DiyFp w = exponent == 0 ? DiyFp(fraction, minExp)
+                                : DiyFp(fraction + hiddenBit, exponent - bias);
+
+        // The lower boundary is closer, when the fraction is 0 since the
+        // exponent of the next smaller value is one less.
+        bool lowerIsCloser = fraction == 0 && exponent > 1;
+
+        DiyFp plus(2 * w.f + 1, w.e - 1);
+        DiyFp minus = lowerIsCloser ? DiyFp(4 * w.f - 1, w.e - 2)
+                                    : DiyFp(2 * w.f - 1, w.e - 1);
+
+        mPlus = normalize(plus);
+        mMinus = normalizeTo(minus, mPlus.e);
+        v = normalize(w);
+    }
+
+    struct CachedPower
+    {
+        uint64_t f;
+        int e;
+        int k;
+    };
+
+    // normalized 10^k for k = -300, -292, ..., 324
+    const CachedPower cachedPowers[] = {
+    { 0xAB70FE17C79AC6CA, -1060, -300 },
+    { 0xFF77B1FCBEBCDC4F, -1034, -292 },
+    { 0xBE5691EF416BD60C, -1007, -284 },
+    { 0x8DD01FAD907FFC3C,  -980, -276 },
+    { 0xD3515C2831559A83,  -954, -268 },
+    { 0x9D71AC8FADA6C9B5,  -927, -260 },
+    { 0xEA9C227723EE8BCB,  -901, -252 },
+    { 0xAECC49914078536D,  -874, -244 },
+    { 0x823C12795DB6CE57,  -847, -236 },
+    { 0xC21094364DFB5637,  -821, -228 },
+    { 0x9096EA6F3848984F,  -794, -220 },
+    { 0xD77485CB25823AC7,  -768, -212 },
+    { 0xA086CFCD97BF97F4,  -741, -204 },
+    { 0xEF340A98172AACE5,  -715, -196 },
+    { 0xB23867FB2A35B28E,  -688, -188 },
+    { 0x84C8D4DFD2C63F3B,  -661, -180 },
+    { 0xC5DD44271AD3CDBA,  -635, -172 },
+    { 0x936B9FCEBB25C996,  -608, -164 },
+    { 0xDBAC6C247D62A584,  -582, -156 },
+    { 0xA3AB66580D5FDAF6,  -555, -148 },
+    { 0xF3E2F893DEC3F126,  -529, -140 },
+    { 0xB5B5ADA8AAFF80B8,  -502, -132 },
+    { 0x87625F056C7C4A8B,  -475, -124 },
+    { 0xC9BCFF6034C13053,  -449, -116 },
+    { 0x964E858C91BA2655,  -422, -108 },
+    { 0xDFF9772470297EBD,  -396, -100 },
+    { 0xA6DFBD9FB8E5B88F,  -369,  -92 },
+    { 0xF8A95FCF88747D94,  -343,  -84 },
+    { 0xB94470938FA89BCF,  -316,  -76 },
+    { 0x8A08F0F8BF0F156B,  -289,  -68 },
+    { 0xCDB02555653131B6,  -263,  -60 },
+    { 0x993FE2C6D07B7FAC,  -236,  -52 },
+    { 0xE45C10C42A2B3B06,  -210,  -44 },
+    { 0xAA242499697392D3,  -183,  -36 },
+    { 0xFD87B5F28300CA0E,  -157,  -28 },
+    { 0xBCE5086492111AEB,  -130,  -20 },
+    { 0x8CBCCC096F5088CC,  -103,  -12 },
+    { 0xD1B71758E219652C,   -77,   -4 },
+    { 0x9C40000000000000,   -50,    4 },
+    { 0xE8D4A51000000000,   -24,   12 },
+    { 0xAD78EBC5AC620000,     3,   20 },
+    { 0x813F3978F8940984,    30,   28 },
+    { 0xC097CE7BC90715B3,    56,   36 },
+    { 0x8F7E32CE7BEA5C70,    83,   44 },
+    { 0xD5D238A4ABE98068,   109,   52 },
+    { 0x9F4F2726179A2245,   136,   60 },
+    { 0xED63A231D4C4FB27,   162,   68 },
+    { 0xB0DE65388CC8ADA8,   189,   76 },
+    { 0x83C7088E1AAB65DB,   216,   84 },
+    { 0xC45D1DF942711D9A,   242,   92 },
+    { 0x924D692CA61BE758,   269,  100 },
+    { 0xDA01EE641A708DEA,   295,  108 },
+    { 0xA26DA3999AEF774A,   322,  116 },
+    { 0xF209787BB47D6B85,   348,  124 },
+    { 0xB454E4A179DD1877,   375,  132 },
+    { 0x865B86925B9BC5C2,   402,  140 },
+    { 0xC83553C5C8965D3D,   428,  148 },
+    { 0x952AB45CFA97A0B3,   455,  156 },
+    { 0xDE469FBD99A05FE3,   481,  164 },
+    { 0xA59BC234DB398C25,   508,  172 },
+    { 0xF6C69A72A3989F5C,   534,  180 },
+    { 0xB7DCBF5354E9BECE,   561,  188 },
+    { 0x88FCF317F22241E2,   588,  196 },
+    { 0xCC20CE9BD35C78A5,   614,  204 },
+    { 0x98165AF37B2153DF,   641,  212 },
+    { 0xE2A0B5DC971F303A,   667,  220 },
+    { 0xA8D9D1535CE3B396,   694,  228 },
+    { 0xFB9B7CD9A4A7443C,   720,  236 },
+    { 0xBB764C4CA7A44410,   747,  244 },
+    { 0x8BAB8EEFB6409C1A,   774,  252 },
+    { 0xD01FEF10A657842C,   800,  260 },
+    { 0x9B10A4E5E9913129,   827,  268 },
+    { 0xE7109BFBA19C0C9D,   853,  276 },
+    { 0xAC2820D9623BF429,   880,  284 },
+    { 0x80444B5E7AA7CF85,   907,  292 },
+    { 0xBF21E44003ACDD2D,   933,  300 },
+    { 0x8E679C2F5E44FF8F,   960,  308 },
+    { 0xD433179D9C8CB841,   986,  316 },
+    { 0x9E19DB92B4E31BA9,  1013,  324 },
+    };
+
+    const int cachedPowersMinDecExp = -300;
+    const int cachedPowersDecStep = 8;
+
+    // the binary exponent of the scaled value is in [alpha, gamma]
+    const int alpha = -60;
+    const int gamma = -32;
+
+    // Returns a cached power c = f * 2^e, so that alpha <= c.e + e + 64 <= gamma.
+    const CachedPower& cachedPowerForBinaryExponent(int e)
+    {
+        const int f = alpha - e - 1;
+        const int k = (f * 78913) / (1 << 18) + (f > 0 ? 1 : 0);  // ceil(f * log10(2))
+        const int index = (-cachedPowersMinDecExp + k + (cachedPowersDecStep - 1)) / cachedPowersDecStep;
+        return cachedPowers[index];
+    }
+
+    // returns the number of decimal digits of n and sets pow10 to 10^(digits-1)
+    int largestPow10(uint32_t n, uint32_t& pow10)
+    {
+        static const uint32_t pow10s[] = {
+            1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000
+        };
+
+        int digits = 10;
+        while (digits > 1 && n < pow10s[digits - 1])
+            --digits;
+
+        pow10 = pow10s[digits - 1];
+        return digits;
+    }
+
+    // moves the last digit towards the value, while it stays in the interval
+    void round(char* digits, unsigned len, uint64_t dist, uint64_t delta,
+               uint64_t rest, uint64_t tenK)
+    {
+        while (rest < dist
+            && delta - rest >= tenK
+            && (rest + tenK < dist || dist - rest > rest + tenK - dist))
+        {
+            --digits[len - 1];
+            rest += tenK;
+        }
+    }
+
+    // generates the digits of w in the interval [mMinus, mPlus]
+    unsigned generateDigits(char* digits, int& decimalExponent,
+        const DiyFp& mMinus, const DiyFp& w, const DiyFp& mPlus)
+    {
+        uint64_t delta = mPlus.f - mMinus.f;
+        uint64_t dist = mPlus.f - w.f;
+
+        const int shift = -mPlus.e;
+        const uint64_t one = uint64_t(1) << shift;
+
+        uint32_t p1 = static_cast<uint32_t>(mPlus.f >> shift);
+        uint64_t p2 = mPlus.f & (one - 1);
+
+        unsigned len = 0;
+
+        // integral part
+        uint32_t pow10;
+        int n = largestPow10(p1, pow10);
+        while (n > 0)
+        {
+            // constant divisors let the compiler avoid the division
+            uint32_t d;
+            switch (n)
+            {
+                case 10: d = p1 / 1000000000u; p1 %= 1000000000u; break;
+                case  9: d = p1 /  100000000u; p1 %=  100000000u; break;
+                case  8: d = p1 /   10000000u; p1 %=   10000000u; break;
+                case  7: d = p1 /    1000000u; p1 %=    1000000u; break;
+                case  6: d = p1 /     100000u; p1 %=     100000u; break;
+                case  5: d = p1 /      10000u; p1 %=      10000u; break;
+                case  4: d = p1 /       1000u; p1 %=       1000u; break;
+                case  3: d = p1 /        100u; p1 %=        100u; break;
+                case  2: d = p1 /         10u; p1 %=         10u; break;
+                default: d = p1;               p1 = 0;           break;
+            }
+
+            digits[len++] = static_cast<char>('0' + d);
+            --n;
+
+            uint64_t rest = (uint64_t(p1) << shift) + p2;
+            if (rest <= delta)
+            {
+                decimalExponent += n;
+                round(digits, len, dist, delta, rest, uint64_t(pow10) << shift);
+                return len;
+            }
+
+            pow10 /= 10;
+        }
+
+        // fractional part
+        int m = 0;
+        while (true)
+        {
+            p2 *= 10;
+            digits[len++] = static_cast<char>('0' + (p2 >> shift));
+            p2 &= one - 1;
+            ++m;
+
+            delta *= 10;
+            dist *= 10;
+
+            if (p2 <= delta)
+                break;
+        }
+
+        decimalExponent -= m;
+        round(digits, len, dist, delta, p2, one);
+        return len;
+    }
+
+    template <typename T, typename Bits>
+    unsigned grisu2(T value, char* digits, int& exp)
+    {
+        DiyFp v(0, 0), mMinus(0, 0), mPlus(0, 0);
+        computeBoundaries<T, Bits>(value, v, mMinus, mPlus);
+
+        const CachedPower& cached = cachedPowerForBinaryExponent(mPlus.e);
+        const DiyFp c(cached.f, cached.e);
+
+        const DiyFp w = mul(v, c);
+        const DiyFp wMinus = mul(mMinus, c);
+        const DiyFp wPlus = mul(mPlus, c);
+
+        // the products may be off by one; use the safe interval
+        const DiyFp lower(wMinus.f + 1, wMinus.e);
+        const DiyFp upper(wPlus.f - 1, wPlus.e);
+
+        int decimalExponent = -cached.k;
+        unsigned len = generateDigits(digits, decimalExponent, lower, w, upper);
+
+        while (len > 1 && digits[len - 1] == '0')
+        {
+            --len;
+            ++decimalExponent;
+        }
+
+        exp = static_cast<int>(len) + decimalExponent;
+        return len;
+    }
+}
+
+unsigned shortestDigits(double value, char* digits, int& exp)
+{
+    return grisu2<double, uint64_t>(value, digits, exp);
+}
+
+unsigned shortestDigits(float value, char* digits, int& exp)
+{
+    return grisu2<float, uint32_t>(value, digits, exp);
+}
+
 //
 // Conversions to cxxtools::String
 //
@@ -41,7 +41,11 @@ namespace cxxtools
     {
         while (!_current.empty())
             _current.pop();
-        _si.clear();
+
+        if (_reuseStorage)
+            _si.reset();
+        else
+            _si.clear();
     }
 
     void Deserializer::beginMember(const std::string& name, const std::string& type, SerializationInfo::Category category)
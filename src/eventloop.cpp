@@ -28,7 +28,7 @@
  */
 #include "selectorimpl.h"
 #include "cxxtools/eventloop.h"
-#include "cxxtools/mutex.h"
+#include "cxxtools/atomicity.h"
 #include "cxxtools/log.h"
 #include <deque>
 
@@ -54,15 +54,32 @@ namespace
 class EventLoop::Impl
 {
 public:
+    // Events are pushed from any thread to a lock free stack and moved to
+    // the event queues by the thread, which processes the events.
+    struct QueuedEvent
+    {
+        Event* ev;
+        bool priority;
+        QueuedEvent* next;
+    };
+
     Impl()
-        : _exitLoop(false),
+        : _exitLoop(0),
           _selector(new SelectorImpl()),
+          _incoming(0),
           _eventsPerLoop(16)
         { }
     ~Impl();
 
+    void push(Event* ev, bool priority);
+
+    void fetchEvents();
+
     bool eventQueueEmpty()
-    { return _eventQueue.empty() && _priorityEventQueue.empty() && _activeEventQueue.empty(); }
+    {
+        fetchEvents();
+        return _eventQueue.empty() && _priorityEventQueue.empty() && _activeEventQueue.empty();
+    }
 
     Event* front()
     {
@@ -80,13 +97,13 @@ public:
             _priorityEventQueue.pop_front();
     }
 
-    bool _exitLoop;
+    volatile atomic_t _exitLoop;
     SelectorImpl* _selector;
+    void* volatile _incoming;
     std::deque<Event*> _eventQueue;
     std::deque<Event*> _priorityEventQueue;
     std::deque<Event*> _activeEventQueue;
     bool _activeEventQueueIsPriority;
-    Mutex _queueMutex;
     unsigned _eventsPerLoop;
 };
 
@@ -94,6 +111,8 @@ EventLoop::Impl::~Impl()
 {
     try
     {
+        fetchEvents();
+
         while ( ! _eventQueue.empty() )
         {
             Event* ev = _eventQueue.front();
@@ -123,6 +142,48 @@ EventLoop::Impl::~Impl()
     delete _selector;
 }
 
+void EventLoop::Impl::push(Event* ev, bool priority)
+{
+    QueuedEvent* qe = new QueuedEvent();
+    qe->ev = ev;
+    qe->priority = priority;
+
+    void* head;
+    do
+    {
+        head = _incoming;
+        qe->next = static_cast<QueuedEvent*>(head);
+    } while (atomicCompareExchange(_incoming, qe, head) != head);
+}
+
+void EventLoop::Impl::fetchEvents()
+{
+    QueuedEvent* head = static_cast<QueuedEvent*>(atomicExchange(_incoming, 0));
+
+    // the stack has the latest event on top
+    QueuedEvent* list = 0;
+    while (head)
+    {
+        QueuedEvent* next = head->next;
+        head->next = list;
+        list = head;
+        head = next;
+    }
+
+    while (list)
+    {
+        QueuedEvent* qe = list;
+        list = list->next;
+
+        if (qe->priority)
+            _priorityEventQueue.push_back(qe->ev);
+        else
+            _eventQueue.push_back(qe->ev);
+
+        delete qe;
+    }
+}
+
 EventLoop::EventLoop()
 : _impl(new Impl())
 {
@@ -157,8 +218,9 @@ void EventLoop::onRemove( Selectable& s )
 }
 
 
-void EventLoop::onReinit(Selectable& /*s*/)
+void EventLoop::onReinit(Selectable& s)
 {
+    _impl->_selector->reinit(s);
 }
 
 
@@ -174,24 +236,16 @@ void EventLoop::onRun()
 
     while (true)
     {
-        MutexLock lock(_impl->_queueMutex);
-
-        if (_impl->_exitLoop)
-        {
-            _impl->_exitLoop = false;
+        if (atomicCompareExchange(_impl->_exitLoop, 0, 1) != 0)
             break;
-        }
 
         bool eventQueueEmpty = _impl->eventQueueEmpty();
         if (!eventQueueEmpty)
         {
-            lock.unlock();
             processEvents(_impl->_eventsPerLoop);
             eventQueueEmpty = _impl->eventQueueEmpty();
         }
 
-        lock.unlock();
-
         if (eventQueueEmpty)
         {
             idle();
@@ -215,13 +269,8 @@ bool EventLoop::onWaitUntil(Timespan timeout)
 {
     if (_impl->_selector->waitUntil(timeout))
     {
-        MutexLock lock(_impl->_queueMutex);
-
         if (!_impl->eventQueueEmpty())
-        {
-            lock.unlock();
             processEvents(_impl->_eventsPerLoop);
-        }
 
         return true;
     }
@@ -240,10 +289,7 @@ void EventLoop::onExit()
 {
     log_debug("exit loop");
 
-    {
-        MutexLock lock(_impl->_queueMutex);
-        _impl->_exitLoop = true;
-    }
+    atomicSet(_impl->_exitLoop, 1);
 
     wake();
 }
@@ -252,14 +298,9 @@ void EventLoop::onQueueEvent(const Event& ev, bool priority)
 {
     log_debug("queue event");
 
-    MutexLock lock( _impl->_queueMutex );
-
     EvPtr cloned(ev.clone());
 
-    if (priority)
-        _impl->_priorityEventQueue.push_back(cloned.ev);
-    else
-        _impl->_eventQueue.push_back(cloned.ev);
+    _impl->push(cloned.ev, priority);
 
     cloned.ev = 0;
 }
@@ -276,18 +317,18 @@ void EventLoop::onProcessEvents(unsigned max)
 {
     unsigned count = 0;
 
-    bool& exitLoop = _impl->_exitLoop;
+    volatile atomic_t& exitLoop = _impl->_exitLoop;
     std::deque<Event*>& eventQueue = _impl->_eventQueue;
     std::deque<Event*>& priorityEventQueue = _impl->_priorityEventQueue;
     std::deque<Event*>& activeEventQueue = _impl->_activeEventQueue;
     bool& activeEventQueueIsPriority = _impl->_activeEventQueueIsPriority;
-    Mutex& queueMutex = _impl->_queueMutex;
+
+    _impl->fetchEvents();
 
     log_debug("processEvents(max:" << max << ") normal/priority/active(priority): " << eventQueue.size() << '/' << priorityEventQueue.size() << '/' << activeEventQueue.size() << '(' << activeEventQueueIsPriority << ')');
 
     if (!activeEventQueue.empty() && !activeEventQueueIsPriority)
     {
-        MutexLock lock(queueMutex);
         if (!priorityEventQueue.empty())
         {
             log_debug("priority events bypass active events");
@@ -307,11 +348,11 @@ void EventLoop::onProcessEvents(unsigned max)
         }
     }
 
-    while (!exitLoop)
+    while (!atomicGet(exitLoop))
     {
         if (activeEventQueue.empty())
         {
-            MutexLock lock(queueMutex);
+            _impl->fetchEvents();
             if (!priorityEventQueue.empty())
             {
                 log_debug("move " << priorityEventQueue.size() << " priority events to active event queue");
@@ -326,7 +367,7 @@ void EventLoop::onProcessEvents(unsigned max)
             }
         }
 
-        if (exitLoop || activeEventQueue.empty())
+        if (atomicGet(exitLoop) || activeEventQueue.empty())
         {
             log_debug_if(activeEventQueue.empty(), "no events to process");
             break;
@@ -0,0 +1,236 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#include <cxxtools/http/bodystream.h>
+#include <cxxtools/iostream.h>
+#include <cxxtools/ioerror.h>
+#include <cxxtools/log.h>
+#include <algorithm>
+#include <cstring>
+
+log_define("cxxtools.http.bodystream")
+
+namespace cxxtools {
+
+namespace http {
+
+namespace
+{
+    const std::size_t firstBlockSize = 4096;
+    const std::size_t maxBlockSize = 1024 * 1024;
+
+    // blocks of at least this size are written to the device directly
+    const std::size_t directWriteSize = 8192;
+}
+
+BodyBuffer::BodyBuffer()
+    : _size(0),
+      _readBlock(0),
+      _consumed(0)
+{ }
+
+BodyBuffer::~BodyBuffer()
+{
+    for (std::vector<Block>::iterator it = _blocks.begin(); it != _blocks.end(); ++it)
+        delete[] it->data;
+}
+
+void BodyBuffer::commit()
+{
+    if (pptr() == 0)
+        return;
+
+    std::size_t n = pptr() - pbase();
+    _blocks.back().size += n;
+    _size += n;
+    setp(pptr(), epptr());
+}
+
+void BodyBuffer::addBlock(std::size_t minCapacity)
+{
+    commit();
+
+    // double the block size, so that the number of blocks stays small
+    std::size_t capacity = _blocks.empty() ? firstBlockSize
+                         : std::min(_blocks.back().capacity * 2, maxBlockSize);
+    if (capacity < minCapacity)
+        capacity = minCapacity;
+
+    log_debug("add block of " << capacity << " bytes");
+
+    Block block;
+    block.data = new char[capacity];
+    block.size = 0;
+    block.capacity = capacity;
+    _blocks.push_back(block);
+
+    setp(block.data, block.data + capacity);
+}
+
+std::string BodyBuffer::str() const
+{
+    std::string ret;
+    ret.reserve(size());
+    for (std::size_t n = 0; n < _blocks.size(); ++n)
+        ret.append(blockData(n), blockSize(n));
+    return ret;
+}
+
+void BodyBuffer::str(const std::string& s)
+{
+    clear();
+    sputn(s.data(), s.size());
+}
+
+void BodyBuffer::clear()
+{
+    if (!_blocks.empty())
+    {
+        for (std::size_t n = 1; n < _blocks.size(); ++n)
+            delete[] _blocks[n].data;
+        _blocks.resize(1);
+        _blocks[0].size = 0;
+        setp(_blocks[0].data, _blocks[0].data + _blocks[0].capacity);
+    }
+
+    setg(0, 0, 0);
+    _size = 0;
+    _readBlock = 0;
+    _consumed = 0;
+}
+
+void BodyBuffer::sendTo(std::ostream& out) const
+{
+    for (std::size_t n = 0; n < _blocks.size() && out; ++n)
+        out.write(blockData(n), blockSize(n));
+}
+
+void BodyBuffer::sendTo(IOStream& out) const
+{
+    IODevice* device = out.attachedDevice();
+
+    for (std::size_t n = 0; n < _blocks.size() && out; ++n)
+    {
+        const char* data = blockData(n);
+        std::size_t count = blockSize(n);
+
+        if (device == 0 || count < directWriteSize)
+        {
+            out.write(data, count);
+            continue;
+        }
+
+        log_debug("write block of " << count << " bytes directly");
+
+        if (!out.flush())
+            break;
+
+        try
+        {
+            while (count > 0)
+            {
+                std::size_t c = device->write(data, count);
+                data += c;
+                count -= c;
+            }
+        }
+        catch (const IOError& e)
+        {
+            log_debug("write failed: " << e.what());
+            out.setstate(std::ios::badbit);
+        }
+    }
+}
+
+BodyBuffer::int_type BodyBuffer::overflow(int_type ch)
+{
+    addBlock(0);
+
+    if (!traits_type::eq_int_type(ch, traits_type::eof()))
+    {
+        *pptr() = traits_type::to_char_type(ch);
+        pbump(1);
+    }
+
+    return traits_type::not_eof(ch);
+}
+
+std::streamsize BodyBuffer::xsputn(const char* s, std::streamsize n)
+{
+    std::streamsize left = n;
+    while (left > 0)
+    {
+        if (pptr() == epptr())
+            addBlock(static_cast<std::size_t>(left));
+
+        std::streamsize count = std::min(left, static_cast<std::streamsize>(epptr() - pptr()));
+        std::memcpy(pptr(), s, count);
+        pbump(static_cast<int>(count));
+        s += count;
+        left -= count;
+    }
+
+    return n;
+}
+
+BodyBuffer::int_type BodyBuffer::underflow()
+{
+    commit();
+
+    while (_readBlock < _blocks.size())
+    {
+        const Block& block = _blocks[_readBlock];
+        char* pos = eback() == block.data ? gptr() : block.data;
+
+        if (pos < block.data + block.size)
+        {
+            setg(block.data, pos, block.data + block.size);
+            return traits_type::to_int_type(*pos);
+        }
+
+        // more data may be written to the last block
+        if (_readBlock + 1 == _blocks.size())
+            break;
+
+        _consumed += block.size;
+        ++_readBlock;
+    }
+
+    return traits_type::eof();
+}
+
+std::streamsize BodyBuffer::showmanyc()
+{
+    std::size_t read = _consumed + (gptr() - eback());
+    return static_cast<std::streamsize>(size() - read);
+}
+
+} // namespace http
+
+} // namespace cxxtools
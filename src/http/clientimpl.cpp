@@ -113,7 +113,7 @@ void ClientImpl::reexecute(const Request& request)
     }
 #endif
 
-    sendRequest(request);
+    sendRequest(request, true);
     _stream.flush();
 }
 
@@ -179,7 +179,7 @@ const ReplyHeader& ClientImpl::execute(const Request& request, Timespan timeout,
     _socket.setTimeout(timeout);
 
     log_debug("send request");
-    sendRequest(request);
+    sendRequest(request, true);
     _stream.flush();
 
     if (!_stream && shouldReconnect)
@@ -338,7 +338,7 @@ SelectorBase* ClientImpl::selector()
 }
 
 
-void ClientImpl::sendRequest(const Request& request)
+void ClientImpl::sendRequest(const Request& request, bool directBody)
 {
     log_debug("send request " << request.url());
 
@@ -411,7 +411,10 @@ void ClientImpl::sendRequest(const Request& request)
 
     log_debug("send body; " << request.bodySize() << " bytes");
 
-    request.sendBody(_stream);
+    if (directBody)
+        request.sendBody(_stream);
+    else
+        request.sendBody(static_cast<std::ostream&>(_stream));
 }
 
 void ClientImpl::onConnect(net::TcpSocket& socket)
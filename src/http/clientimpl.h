@@ -104,7 +104,10 @@ class ClientImpl : public RefCounted, public Connectable
         bool _reconnectOnError;
         bool _errorPending;
 
-        void sendRequest(const Request& request);
+        // Writes the request to the stream. With directBody large parts of
+        // the body are written to the socket synchronously without copying
+        // them to the stream buffer.
+        void sendRequest(const Request& request, bool directBody = false);
         void processHeaderAvailable(StreamBuffer& sb);
         void processBodyAvailable(StreamBuffer& sb);
 
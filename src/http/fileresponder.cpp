@@ -0,0 +1,329 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "fileresponder.h"
+#include <cxxtools/http/fileservice.h>
+#include <cxxtools/http/request.h>
+#include <cxxtools/http/reply.h>
+#include <cxxtools/datetime.h>
+#include <cxxtools/log.h>
+#include <cstring>
+#include <stdio.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+
+log_define("cxxtools.http.fileresponder")
+
+namespace cxxtools
+{
+namespace http
+{
+
+namespace
+{
+    // closes the file unless ownership is passed to the reply
+    class FileGuard
+    {
+            int _fd;
+
+        public:
+            explicit FileGuard(int fd)
+                : _fd(fd)
+                { }
+
+            ~FileGuard()
+            {
+                if (_fd >= 0)
+                    ::close(_fd);
+            }
+
+            int release()
+            {
+                int fd = _fd;
+                _fd = -1;
+                return fd;
+            }
+    };
+
+    // Checks whether the list of entity tags in an If-None-Match or
+    // If-Range header contains the tag.
+    bool etagMatches(const char* header, const std::string& etag)
+    {
+        while (*header)
+        {
+            while (*header == ' ' || *header == ',')
+                ++header;
+
+            if (*header == '*')
+                return true;
+
+            if (header[0] == 'W' && header[1] == '/')
+                header += 2;
+
+            const char* end = std::strchr(header, ',');
+            std::size_t len = end ? static_cast<std::size_t>(end - header) : std::strlen(header);
+            while (len > 0 && header[len - 1] == ' ')
+                --len;
+
+            if (len == etag.size() && etag.compare(0, len, header, len) == 0)
+                return true;
+
+            if (end == 0)
+                break;
+
+            header = end;
+        }
+
+        return false;
+    }
+
+    bool parseHtdate(const char* s, DateTime& dt)
+    {
+        try
+        {
+            dt = DateTime(s, "???, %d %O %Y %H:%M:%S GMT");
+            return true;
+        }
+        catch (const std::exception&)
+        {
+            return false;
+        }
+    }
+
+    bool parseUnsigned(const char*& s, std::size_t& value)
+    {
+        if (*s < '0' || *s > '9')
+            return false;
+
+        value = 0;
+        while (*s >= '0' && *s <= '9')
+            value = value * 10 + (*s++ - '0');
+
+        return true;
+    }
+
+    enum RangeResult
+    {
+        RangeIgnore,        // send the whole file
+        RangeOk,
+        RangeUnsatisfiable
+    };
+
+    // Parses a single byte range "bytes=first-last", "bytes=first-" or
+    // "bytes=-suffix". Multiple ranges are ignored.
+    RangeResult parseRange(const char* s, std::size_t size, std::size_t& first, std::size_t& last)
+    {
+        if (std::strncmp(s, "bytes=", 6) != 0)
+            return RangeIgnore;
+        s += 6;
+
+        if (*s == '-')
+        {
+            std::size_t suffix;
+            ++s;
+            if (!parseUnsigned(s, suffix) || *s != '\0')
+                return RangeIgnore;
+            if (suffix == 0 || size == 0)
+                return RangeUnsatisfiable;
+
+            first = suffix < size ? size - suffix : 0;
+            last = size - 1;
+            return RangeOk;
+        }
+
+        if (!parseUnsigned(s, first) || *s++ != '-')
+            return RangeIgnore;
+
+        if (*s == '\0')
+            last = size - 1;
+        else if (!parseUnsigned(s, last) || *s != '\0' || last < first)
+            return RangeIgnore;
+
+        if (first >= size)
+            return RangeUnsatisfiable;
+
+        if (last >= size)
+            last = size - 1;
+
+        return RangeOk;
+    }
+}
+
+FileResponder::FileResponder(FileService& service)
+    : Responder(service),
+      _service(service)
+{ }
+
+bool FileResponder::translateUrl(const std::string& url, std::string& fileName) const
+{
+    // the url is already decoded by the parser
+    const std::string& prefix = _service.urlPrefix();
+    std::string path = url.compare(0, prefix.size(), prefix) == 0 ? url.substr(prefix.size()) : url;
+
+    // reject any ".." component, so that the path stays in the document root
+    std::string::size_type b = 0;
+    while (b <= path.size())
+    {
+        std::string::size_type e = path.find('/', b);
+        if (e == std::string::npos)
+            e = path.size();
+        if (path.compare(b, e - b, "..") == 0)
+            return false;
+        b = e + 1;
+    }
+
+    fileName = _service.documentRoot();
+    if (!fileName.empty() && fileName[fileName.size() - 1] != '/'
+        && (path.empty() || path[0] != '/'))
+        fileName += '/';
+    fileName += path;
+
+    return true;
+}
+
+void FileResponder::reply(std::ostream& /*out*/, Request& request, Reply& reply)
+{
+    bool head = request.method() == "HEAD";
+    if (!head && request.method() != "GET")
+    {
+        reply.httpReturn(405, "Method Not Allowed");
+        reply.setHeader("Allow", "GET, HEAD");
+        return;
+    }
+
+    std::string fileName;
+    if (!translateUrl(request.url(), fileName))
+    {
+        log_info("invalid url <" << request.url() << '>');
+        reply.httpReturn(404, "Not found");
+        return;
+    }
+
+    log_debug("open file \"" << fileName << '"');
+
+    int fd = ::open(fileName.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        log_debug("open failed: " << std::strerror(errno));
+        if (errno == EACCES)
+            reply.httpReturn(403, "Forbidden");
+        else
+            reply.httpReturn(404, "Not found");
+        return;
+    }
+
+    FileGuard guard(fd);
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || !S_ISREG(st.st_mode))
+    {
+        reply.httpReturn(404, "Not found");
+        return;
+    }
+
+    std::size_t size = static_cast<std::size_t>(st.st_size);
+
+    char etag[64];
+    sprintf(etag, "\"%lx-%lx\"", static_cast<unsigned long>(st.st_mtime),
+        static_cast<unsigned long>(st.st_size));
+
+    DateTime mtime = DateTime::fromMSecsSinceEpoch(Seconds(st.st_mtime));
+    char lastModified[30];
+    MessageHeader::htdate(mtime, lastModified);
+
+    reply.setHeader("ETag", etag);
+    reply.setHeader("Last-Modified", lastModified);
+    reply.setHeader("Accept-Ranges", "bytes");
+
+    const char* ifNoneMatch = request.getHeader("If-None-Match");
+    const char* ifModifiedSince = request.getHeader("If-Modified-Since");
+    DateTime since;
+    if (ifNoneMatch ? etagMatches(ifNoneMatch, etag)
+                    : ifModifiedSince && parseHtdate(ifModifiedSince, since) && mtime <= since)
+    {
+        log_debug("file \"" << fileName << "\" not modified");
+        reply.httpReturn(304, "Not Modified");
+        return;
+    }
+
+    reply.setHeader("Content-Type", _service.mimeType(fileName).c_str());
+
+    std::size_t first = 0;
+    std::size_t count = size;
+
+    const char* range = request.getHeader("Range");
+    const char* ifRange = request.getHeader("If-Range");
+    if (range && (ifRange == 0 || std::strcmp(ifRange, lastModified) == 0 || etagMatches(ifRange, etag)))
+    {
+        std::size_t last;
+        switch (parseRange(range, size, first, last))
+        {
+            case RangeIgnore:
+                first = 0;
+                break;
+
+            case RangeOk:
+            {
+                char contentRange[80];
+                sprintf(contentRange, "bytes %lu-%lu/%lu", static_cast<unsigned long>(first),
+                    static_cast<unsigned long>(last), static_cast<unsigned long>(size));
+                reply.httpReturn(206, "Partial Content");
+                reply.setHeader("Content-Range", contentRange);
+                count = last - first + 1;
+                break;
+            }
+
+            case RangeUnsatisfiable:
+            {
+                char contentRange[40];
+                sprintf(contentRange, "bytes */%lu", static_cast<unsigned long>(size));
+                reply.httpReturn(416, "Range Not Satisfiable");
+                reply.setHeader("Content-Range", contentRange);
+                return;
+            }
+        }
+    }
+
+    log_debug("send " << count << " bytes from offset " << first << " of file \"" << fileName << '"');
+
+    if (head)
+    {
+        char contentLength[24];
+        sprintf(contentLength, "%lu", static_cast<unsigned long>(count));
+        reply.setHeader("Content-Length", contentLength);
+        return;
+    }
+
+    reply.setFile(guard.release(), first, count);
+}
+
+}
+}
@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <cxxtools/http/fileservice.h>
+#include "fileresponder.h"
+
+namespace cxxtools
+{
+namespace http
+{
+
+FileService::FileService(const std::string& documentRoot, const std::string& urlPrefix)
+    : _documentRoot(documentRoot),
+      _urlPrefix(urlPrefix),
+      _defaultMimeType("application/octet-stream")
+{
+    static const char* defaultTypes[][2] = {
+        { "html", "text/html" },
+        { "htm", "text/html" },
+        { "css", "text/css" },
+        { "js", "application/javascript" },
+        { "json", "application/json" },
+        { "txt", "text/plain" },
+        { "xml", "application/xml" },
+        { "svg", "image/svg+xml" },
+        { "png", "image/png" },
+        { "jpg", "image/jpeg" },
+        { "jpeg", "image/jpeg" },
+        { "gif", "image/gif" },
+        { "ico", "image/x-icon" },
+        { "webp", "image/webp" },
+        { "pdf", "application/pdf" },
+        { "zip", "application/zip" },
+        { "gz", "application/gzip" },
+        { "wasm", "application/wasm" },
+        { "woff", "font/woff" },
+        { "woff2", "font/woff2" },
+        { "mp4", "video/mp4" },
+        { "mp3", "audio/mpeg" }
+    };
+
+    for (unsigned n = 0; n < sizeof(defaultTypes) / sizeof(defaultTypes[0]); ++n)
+        _mimeTypes[defaultTypes[n][0]] = defaultTypes[n][1];
+}
+
+const std::string& FileService::mimeType(const std::string& fileName) const
+{
+    std::string::size_type slash = fileName.rfind('/');
+    std::string::size_type dot = fileName.rfind('.');
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash))
+        return _defaultMimeType;
+
+    std::string ext = fileName.substr(dot + 1);
+    for (std::string::iterator it = ext.begin(); it != ext.end(); ++it)
+        if (*it >= 'A' && *it <= 'Z')
+            *it = static_cast<char>(*it - 'A' + 'a');
+
+    MimeTypes::const_iterator it = _mimeTypes.find(ext);
+    return it == _mimeTypes.end() ? _defaultMimeType : it->second;
+}
+
+Responder* FileService::newResponder()
+{
+    return new FileResponder(*this);
+}
+
+}
+}
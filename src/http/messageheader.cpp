@@ -108,20 +108,28 @@ void MessageHeader::setHeader(const char* key, const char* value, bool replace)
     if (replace)
         removeHeader(key);
 
-    char* p = eptr();
+    addHeader(key, strlen(key), value, strlen(value));
+}
 
-    size_t lk = strlen(key);     // length of key
-    size_t lv = strlen(value);   // length of value
+void MessageHeader::addHeader(const char* key, std::size_t keySize,
+                              const char* value, std::size_t valueSize)
+{
+    if (keySize == 0)
+        throw std::runtime_error("empty key not allowed in messageheader");
 
-    if (p - _rawdata + lk + lv + 2 > MAXHEADERSIZE)
+    char* p = eptr();
+
+    if (p - _rawdata + keySize + valueSize + 3 > MAXHEADERSIZE)
         throw std::runtime_error("message header too big");
 
-    std::strcpy(p, key);   // copy key
-    p += lk + 1;
-    std::strcpy(p, value); // copy value
-    p[lv + 1] = '\0';      // put new message end marker in place
+    std::memcpy(p, key, keySize);       // copy key
+    p[keySize] = '\0';
+    p += keySize + 1;
+    std::memcpy(p, value, valueSize);   // copy value
+    p[valueSize] = '\0';
+    p[valueSize + 1] = '\0';            // put new message end marker in place
 
-    _endOffset = (p + lv + 1) - _rawdata;
+    _endOffset = (p + valueSize + 1) - _rawdata;
 }
 
 void MessageHeader::removeHeader(const char* key)
@@ -184,6 +192,11 @@ bool MessageHeader::keepAlive() const
 }
 
 char* MessageHeader::htdateCurrent(char* buffer)
+{
+    return htdate(Clock::getSystemTime(), buffer);
+}
+
+char* MessageHeader::htdate(const DateTime& dt, char* buffer)
 {
     int year = 0;
     unsigned month = 0;
@@ -193,7 +206,6 @@ char* MessageHeader::htdateCurrent(char* buffer)
     unsigned sec = 0;
     unsigned msec = 0;
 
-    DateTime dt = Clock::getSystemTime();
     dt.get(year, month, day, hour, min, sec, msec);
     unsigned dayOfWeek = dt.date().dayOfWeek();
 
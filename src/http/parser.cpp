@@ -27,11 +27,12 @@
  */
 
 #include "parser.h"
+#include "streampeek.h"
 #include <cxxtools/http/messageheader.h>
 #include <cxxtools/log.h>
 #include <cctype>
 #include <algorithm>
-#include <string.h>
+#include <cstring>
 
 log_define("cxxtools.http.parser")
 
@@ -88,11 +89,11 @@ namespace http {
     {
     }
 
-    void HeaderParser::Event::onKey(const std::string& /*key*/)
+    void HeaderParser::Event::onKey(const char* /*key*/, std::size_t /*size*/)
     {
     }
 
-    void HeaderParser::Event::onValue(const std::string& /*value*/)
+    void HeaderParser::Event::onValue(const char* /*value*/, std::size_t /*size*/)
     {
     }
 
@@ -109,30 +110,155 @@ namespace http {
          _header.httpVersion(major, minor);
     }
 
-    void HeaderParser::MessageHeaderEvent::onKey(const std::string& key)
+    void HeaderParser::MessageHeaderEvent::onKey(const char* key, std::size_t size)
     {
-        strncpy(_key, key.c_str(), MessageHeader::MAXHEADERSIZE);
+        _keySize = std::min(size, sizeof(_key));
+        std::memcpy(_key, key, _keySize);
     }
 
-    void HeaderParser::MessageHeaderEvent::onValue(const std::string& value)
+    void HeaderParser::MessageHeaderEvent::onValue(const char* value, std::size_t size)
     {
-        _header.addHeader(_key, value.c_str());
+        _header.addHeader(_key, _keySize, value, size);
     }
 
     std::size_t HeaderParser::advance(std::streambuf& sb)
     {
         std::size_t ret = 0;
+        char buffer[8192];
 
-        while (sb.in_avail() > 0)
+        while (!end() && sb.in_avail() > 0)
         {
-            ++ret;
-            if (parse(sb.sbumpc()))
-                return ret;
+            // parse a copy of the input and consume only what the parser
+            // took, so that what follows the header stays in the buffer
+            std::streamsize n = peekInput(sb, buffer, sizeof(buffer));
+            if (n <= 0)
+                break;
+
+            const char* p = parse(buffer, buffer + n);
+            skipInput(sb, p - buffer);
+            ret += p - buffer;
         }
 
         return ret;
     }
 
+    // Runs of characters in the url, the query string and the header
+    // lines are scanned in one go instead of passing each character
+    // through the state machine. Header keys and values, which are
+    // complete in the passed data, are passed to the event without
+    // copying them to the token.
+    const char* HeaderParser::parse(const char* b, const char* e)
+    {
+        while (b != e && !end())
+        {
+            if (state == &HeaderParser::state_h0)
+            {
+                if (*b > 32 && *b < 127 && *b != ':')
+                {
+                    token.clear();
+                    state = &HeaderParser::state_hfieldname;
+                    continue;
+                }
+            }
+            else if (state == &HeaderParser::state_hfieldname)
+            {
+                const char* p = b;
+                while (p != e && *p > 32 && *p < 127 && *p != ':')
+                    ++p;
+
+                if (p == e)
+                {
+                    token.append(b, p);
+                    return e;
+                }
+
+                if (token.empty() && p != b && *p == ':')
+                {
+                    ev.onKey(b, p - b);
+                    state = &HeaderParser::state_hfieldbody0;
+                    b = p + 1;
+                    continue;
+                }
+
+                token.append(b, p);
+                b = p;
+            }
+            else if (state == &HeaderParser::state_hfieldbody0)
+            {
+                if (*b != '\r' && *b != '\n' && !std::isspace(static_cast<unsigned char>(*b)))
+                {
+                    token.clear();
+                    state = &HeaderParser::state_hfieldbody;
+                    continue;
+                }
+            }
+            else if (state == &HeaderParser::state_hfieldbody)
+            {
+                const char* nl = static_cast<const char*>(std::memchr(b, '\n', e - b));
+                const char* p = nl ? nl : e;
+                if (p != b && p[-1] == '\r')
+                    --p;
+
+                // a carriage return within the value is handled (and
+                // rejected) by the state machine
+                const char* cr = static_cast<const char*>(std::memchr(b, '\r', p - b));
+                if (cr)
+                {
+                    token.append(b, cr);
+                    b = cr;
+                }
+                else if (nl && nl + 1 != e && nl[1] != ' ' && nl[1] != '\t')
+                {
+                    // the value is complete, since the next line is no continuation
+                    if (token.empty())
+                        ev.onValue(b, p - b);
+                    else
+                    {
+                        token.append(b, p);
+                        ev.onValue(token.data(), token.size());
+                    }
+
+                    state = &HeaderParser::state_h0;
+                    b = nl + 1;
+                    continue;
+                }
+                else
+                {
+                    token.append(b, p);
+                    b = p;
+                    if (b == e)
+                        return e;
+                }
+            }
+            else if (state == &HeaderParser::state_url)
+            {
+                const char* p = b;
+                while (p != e && *p > ' ' && *p != '?' && *p != '+' && *p != '%')
+                    ++p;
+
+                token.append(b, p);
+                b = p;
+                if (b == e)
+                    return e;
+            }
+            else if (state == &HeaderParser::state_qparam)
+            {
+                const char* p = b;
+                while (p != e && *p != ' ' && *p != '\t')
+                    ++p;
+
+                token.append(b, p);
+                b = p;
+                if (b == e)
+                    return e;
+            }
+
+            (this->*state)(*b++);
+        }
+
+        return b;
+    }
+
     void HeaderParser::state_cmd0(char ch)
     {
         if (istokenchar(ch))
@@ -551,13 +677,15 @@ namespace http {
     {
         if (ch == ':')
         {
-            ev.onKey(token);
+            ev.onKey(token.data(), token.size());
+            token.clear();
             state = &HeaderParser::state_hfieldbody0;
             return;
         }
         else if (ch == ' ' || ch == '\t')
         {
-            ev.onKey(token);
+            ev.onKey(token.data(), token.size());
+            token.clear();
             state = &HeaderParser::state_hfieldnamespace;
             return;
         }
@@ -605,11 +733,11 @@ namespace http {
             state = &HeaderParser::state_hfieldbody_crlf;
             return;
         }
-        else if (std::isspace(ch))
+        else if (std::isspace(static_cast<unsigned char>(ch)))
         {
             return;
         }
-        else if (!std::isspace(ch))
+        else if (!std::isspace(static_cast<unsigned char>(ch)))
         {
             token.reserve(32);
             token = ch;
@@ -657,13 +785,13 @@ namespace http {
     {
         if (ch == '\r')
         {
-            ev.onValue(token);
+            ev.onValue(token.data(), token.size());
             state = &HeaderParser::state_hend_cr;
             return;
         }
         else if (ch == '\n')
         {
-            ev.onValue(token);
+            ev.onValue(token.data(), token.size());
             ev.onEnd();
             state = &HeaderParser::state_end;
             return;
@@ -676,7 +804,7 @@ namespace http {
         }
         else if (ch > 32 && ch < 127)
         {
-            ev.onValue(token);
+            ev.onValue(token.data(), token.size());
             token.reserve(32);
             token = ch;
             state = &HeaderParser::state_hfieldname;
@@ -50,8 +50,10 @@ class HeaderParser
                 virtual void onUrl(const std::string& url);
                 virtual void onUrlParam(const std::string& q);
                 virtual void onHttpVersion(unsigned major, unsigned minor);
-                virtual void onKey(const std::string& key);
-                virtual void onValue(const std::string& value);
+                // key and value point into the parsed data or a token and
+                // are valid only during the call
+                virtual void onKey(const char* key, std::size_t size);
+                virtual void onValue(const char* value, std::size_t size);
                 virtual void onHttpReturn(unsigned ret, const std::string& text);
                 virtual void onEnd();
         };
@@ -60,15 +62,17 @@ class HeaderParser
         {
                 MessageHeader& _header;
                 char _key[MessageHeader::MAXHEADERSIZE];
+                std::size_t _keySize;
 
             public:
                 explicit MessageHeaderEvent(MessageHeader& header)
-                    : _header(header)
+                    : _header(header),
+                      _keySize(0)
                     { }
 
                 virtual void onHttpVersion(unsigned major, unsigned minor);
-                virtual void onKey(const std::string& key);
-                virtual void onValue(const std::string& value);
+                virtual void onKey(const char* key, std::size_t size);
+                virtual void onValue(const char* value, std::size_t size);
         };
 
     private:
@@ -129,6 +133,10 @@ class HeaderParser
         /// parse as many characters as available in buffer without blocking
         std::size_t advance(std::streambuf& sb);
 
+        /// Parses the characters until the message is finished and returns
+        /// a pointer to the first character not consumed.
+        const char* parse(const char* begin, const char* end);
+
         std::size_t advance(std::istream& is)
         { return advance(*is.rdbuf()); }
 
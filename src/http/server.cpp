@@ -125,6 +125,16 @@ void Server::maxThreads(unsigned m)
     _impl->maxThreads(m);
 }
 
+unsigned Server::reactors() const
+{
+    return _impl->reactors();
+}
+
+void Server::reactors(unsigned n)
+{
+    _impl->reactors(n);
+}
+
 Delegate<bool, const SslCertificate&>& Server::acceptSslCertificate()
 {
     return _impl->acceptSslCertificate;
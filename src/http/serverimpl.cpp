@@ -33,6 +33,9 @@
 #include <cxxtools/eventloop.h>
 #include <cxxtools/log.h>
 #include <cxxtools/net/tcpserver.h>
+#include <cxxtools/thread.h>
+#include <stdexcept>
+#include <sys/socket.h>
 
 log_define("cxxtools.http.server.impl")
 
@@ -43,26 +46,32 @@ namespace http
 
 class IdleSocketEvent : public BasicEvent<IdleSocketEvent>
 {
+        const Reactor* _reactor;
         Socket* _socket;
 
     public:
-        explicit IdleSocketEvent(Socket* socket)
-            : _socket(socket)
+        IdleSocketEvent(const Reactor* reactor, Socket* socket)
+            : _reactor(reactor),
+              _socket(socket)
             { }
 
+        const Reactor* reactor() const   { return _reactor; }
         Socket* socket() const   { return _socket; }
 
 };
 
 class KeepAliveTimeoutEvent : public BasicEvent<KeepAliveTimeoutEvent>
 {
+        const Reactor* _reactor;
         Socket* _socket;
 
     public:
-        explicit KeepAliveTimeoutEvent(Socket* socket)
-            : _socket(socket)
+        KeepAliveTimeoutEvent(const Reactor* reactor, Socket* socket)
+            : _reactor(reactor),
+              _socket(socket)
             { }
 
+        const Reactor* reactor() const   { return _reactor; }
         Socket* socket() const   { return _socket; }
 
 };
@@ -82,92 +91,137 @@ class ServerStartEvent : public BasicEvent<ServerStartEvent>
 
 class NoWaitingThreadsEvent : public BasicEvent<NoWaitingThreadsEvent>
 {
+        const Reactor* _reactor;
+
+    public:
+        explicit NoWaitingThreadsEvent(const Reactor* reactor)
+            : _reactor(reactor)
+            { }
+
+        const Reactor* reactor() const   { return _reactor; }
 };
 
 class ThreadTerminatedEvent : public BasicEvent<ThreadTerminatedEvent>
 {
+        const Reactor* _reactor;
         Worker* _worker;
 
     public:
-        explicit ThreadTerminatedEvent(Worker* worker)
-            : _worker(worker)
+        ThreadTerminatedEvent(const Reactor* reactor, Worker* worker)
+            : _reactor(reactor),
+              _worker(worker)
             { }
 
+        const Reactor* reactor() const   { return _reactor; }
         Worker* worker() const   { return _worker; }
 };
 
 class ActiveSocketEvent : public BasicEvent<ActiveSocketEvent>
 {
+        const Reactor* _reactor;
         Socket* _socket;
 
     public:
-        explicit ActiveSocketEvent(Socket* socket)
-            : _socket(socket)
+        ActiveSocketEvent(const Reactor* reactor, Socket* socket)
+            : _reactor(reactor),
+              _socket(socket)
             { }
 
+        const Reactor* reactor() const   { return _reactor; }
         Socket* socket() const   { return _socket; }
 
 };
 
+////////////////////////////////////////////////////////////////////////
+// Reactor
+//
+Reactor::Reactor(ServerImpl& server, EventLoopBase& eventLoop)
+    : _server(server),
+      _ownEventLoop(0),
+      _eventLoopThread(0),
+      _eventLoop(eventLoop),
+      inputSlot(slot(*this, &Reactor::onInput)),
+      timeoutSlot(slot(*this, &Reactor::onTimeout))
+{
+    init();
+}
 
-ServerImpl::ServerImpl(EventLoopBase& eventLoop, Signal<Server::Runmode>& runmodeChanged)
-    : ServerImplBase(eventLoop, runmodeChanged),
-      inputSlot(slot(*this, &ServerImpl::onInput)),
-      timeoutSlot(slot(*this, &ServerImpl::onTimeout))
-{
-    _eventLoop.event.subscribe(slot(*this, &ServerImpl::onIdleSocket));
-    _eventLoop.event.subscribe(slot(*this, &ServerImpl::onActiveSocket));
-    _eventLoop.event.subscribe(slot(*this, &ServerImpl::onKeepAliveTimeout));
-    _eventLoop.event.subscribe(slot(*this, &ServerImpl::onNoWaitingThreads));
-    _eventLoop.event.subscribe(slot(*this, &ServerImpl::onThreadTerminated));
-    _eventLoop.event.subscribe(slot(*this, &ServerImpl::onServerStart));
-
-    connect(_eventLoop.exited, *this, &ServerImpl::terminate);
+Reactor::Reactor(ServerImpl& server)
+    : _server(server),
+      _ownEventLoop(new EventLoop()),
+      _eventLoopThread(0),
+      _eventLoop(*_ownEventLoop),
+      inputSlot(slot(*this, &Reactor::onInput)),
+      timeoutSlot(slot(*this, &Reactor::onTimeout))
+{
+    init();
+}
 
-    _eventLoop.commitEvent(ServerStartEvent(this));
+void Reactor::init()
+{
+    _eventLoop.event.subscribe(slot(*this, &Reactor::onIdleSocket));
+    _eventLoop.event.subscribe(slot(*this, &Reactor::onActiveSocket));
+    _eventLoop.event.subscribe(slot(*this, &Reactor::onKeepAliveTimeout));
+    _eventLoop.event.subscribe(slot(*this, &Reactor::onNoWaitingThreads));
+    _eventLoop.event.subscribe(slot(*this, &Reactor::onThreadTerminated));
 }
 
-ServerImpl::~ServerImpl()
+Reactor::~Reactor()
 {
-    if (runmode() == Server::Running)
+    if (_eventLoopThread)
     {
-        try
-        {
-            terminate();
-        }
-        catch (const std::exception& e)
-        {
-            log_fatal("exception in http-server termination occured: " << e.what());
-        }
+        _ownEventLoop->exit();
+        _eventLoopThread->join();
+        delete _eventLoopThread;
     }
+
+    for (ListenerType::iterator it = _listener.begin(); it != _listener.end(); ++it)
+        delete *it;
+
+    while (!_queue.empty())
+        delete _queue.get();
+
+    for (std::set<Socket*>::iterator it = _idleSockets.begin(); it != _idleSockets.end(); ++it)
+        delete *it;
+
+    // close our connections before the event loop they refer to is gone
+    clear();
+    delete _ownEventLoop;
 }
 
-void ServerImpl::listen(const std::string& ip, unsigned short int port, const std::string& certificateFile, const std::string& privateKeyFile, int sslVerifyLevel, const std::string& sslCa)
+bool Reactor::isTerminating() const
 {
-    log_debug("listen on " << ip << " port " << port << " certificate \"" << certificateFile << "\" private key \"" << privateKeyFile << '"');
-    net::TcpServer* listener = new net::TcpServer(ip, port, 64,
-        net::TcpServer::DEFER_ACCEPT|net::TcpServer::REUSEADDR);
+    return _server.isTerminating();
+}
+
+unsigned Reactor::minThreads() const
+{
+    return _server.minThreads();
+}
+
+void Reactor::listen(const std::string& ip, unsigned short int port, unsigned flags, const std::string& certificateFile, const std::string& privateKeyFile, int sslVerifyLevel, const std::string& sslCa)
+{
+    net::TcpServer* listener = new net::TcpServer(ip, port, 64, flags);
     Socket* socket = 0;
 
     try
     {
         _listener.push_back(listener);
-        socket = new Socket(*this, *listener, certificateFile, privateKeyFile, sslVerifyLevel, sslCa);
+        socket = new Socket(_server, *listener, certificateFile, privateKeyFile, sslVerifyLevel, sslCa);
         _queue.put(socket);
     }
     catch (...)
     {
+        if (!_listener.empty() && _listener.back() == listener)
+            _listener.pop_back();
         delete socket;
         delete listener;
         throw;
     }
 }
 
-void ServerImpl::start()
+void Reactor::start()
 {
-    log_trace("start server");
-    runmode(Server::Starting);
-
     MutexLock lock(_threadMutex);
     while (_threads.size() < minThreads())
     {
@@ -176,81 +230,89 @@ void ServerImpl::start()
         worker->start();
     }
 
-    runmode(Server::Running);
+    if (_ownEventLoop && !_eventLoopThread)
+    {
+        _eventLoopThread = new AttachedThread(callable(*_ownEventLoop, &EventLoop::run));
+        _eventLoopThread->start();
+    }
 }
 
-void ServerImpl::terminate()
+void Reactor::stop()
 {
-    log_trace("terminate");
+    if (_eventLoopThread)
+    {
+        log_debug("stop reactor event loop");
+        _ownEventLoop->exit();
+        _eventLoopThread->join();
+        delete _eventLoopThread;
+        _eventLoopThread = 0;
+    }
 
     _eventLoop.processEvents();
+}
 
+void Reactor::terminate()
+{
     MutexLock lock(_threadMutex);
 
-    runmode(Server::Terminating);
+    log_debug("wake " << _listener.size() << " listeners");
+    for (ListenerType::iterator it = _listener.begin(); it != _listener.end(); ++it)
+        (*it)->terminateAccept();
+    _queue.put(0);
 
-    try
+    log_debug("terminate " << _threads.size() << " threads");
+    while (!_threads.empty() || !_terminatedThreads.empty())
     {
-        log_debug("wake " << _listener.size() << " listeners");
-        for (ServerImpl::ListenerType::iterator it = _listener.begin(); it != _listener.end(); ++it)
-            (*it)->terminateAccept();
-        _queue.put(0);
-
-        log_debug("terminate " << _threads.size() << " threads");
-        while (!_threads.empty() || !_terminatedThreads.empty())
+        if (!_threads.empty())
         {
-            if (!_threads.empty())
-            {
-                log_debug("wait for terminated thread");
-                _threadTerminated.wait(lock);
-            }
-
-            for (Threads::iterator it = _terminatedThreads.begin();
-                it != _terminatedThreads.end(); ++it)
-            {
-                log_debug("join thread");
-                (*it)->join();
-                delete *it;
-            }
-
-            _terminatedThreads.clear();
+            log_debug("wait for terminated thread");
+            _threadTerminated.wait(lock);
         }
 
-        log_debug("delete " << _listener.size() << " listeners");
-        for (ServerImpl::ListenerType::iterator it = _listener.begin(); it != _listener.end(); ++it)
+        for (Threads::iterator it = _terminatedThreads.begin();
+            it != _terminatedThreads.end(); ++it)
+        {
+            log_debug("join thread");
+            (*it)->join();
             delete *it;
-        _listener.clear();
+        }
 
-        while (!_queue.empty())
-            delete _queue.get();
+        _terminatedThreads.clear();
+    }
 
-        for (std::set<Socket*>::iterator it = _idleSockets.begin(); it != _idleSockets.end(); ++it)
-            delete *it;
-        _idleSockets.clear();
+    lock.unlock();
 
-        runmode(Server::Stopped);
-    }
-    catch (const std::exception& e)
-    {
-        runmode(Server::Failed);
-    }
+    // process events committed by the workers while terminating
+    _eventLoop.processEvents();
+
+    log_debug("delete " << _listener.size() << " listeners");
+    for (ListenerType::iterator it = _listener.begin(); it != _listener.end(); ++it)
+        delete *it;
+    _listener.clear();
+
+    while (!_queue.empty())
+        delete _queue.get();
+
+    for (std::set<Socket*>::iterator it = _idleSockets.begin(); it != _idleSockets.end(); ++it)
+        delete *it;
+    _idleSockets.clear();
 }
 
-void ServerImpl::noWaitingThreads()
+void Reactor::noWaitingThreads()
 {
     MutexLock lock(_threadMutex);
-    if (runmode() == Server::Running)
-        _eventLoop.commitEvent(NoWaitingThreadsEvent());
+    if (_server.runmode() == Server::Running)
+        _eventLoop.commitEvent(NoWaitingThreadsEvent(this));
 }
 
-void ServerImpl::threadTerminated(Worker* worker)
+void Reactor::threadTerminated(Worker* worker)
 {
     MutexLock lock(_threadMutex);
 
     _threads.erase(worker);
-    if (runmode() == Server::Running)
+    if (_server.runmode() == Server::Running)
     {
-        _eventLoop.commitEvent(ThreadTerminatedEvent(worker));
+        _eventLoop.commitEvent(ThreadTerminatedEvent(this, worker));
     }
     else
     {
@@ -259,13 +321,13 @@ void ServerImpl::threadTerminated(Worker* worker)
     }
 }
 
-void ServerImpl::addIdleSocket(Socket* socket)
+void Reactor::addIdleSocket(Socket* socket)
 {
     log_debug("add idle socket " << static_cast<void*>(socket));
 
-    if (runmode() == Server::Running)
+    if (_server.runmode() == Server::Running)
     {
-        _eventLoop.commitEvent(IdleSocketEvent(socket));
+        _eventLoop.commitEvent(IdleSocketEvent(this, socket));
     }
     else
     {
@@ -274,8 +336,11 @@ void ServerImpl::addIdleSocket(Socket* socket)
     }
 }
 
-void ServerImpl::onIdleSocket(const IdleSocketEvent& event)
+void Reactor::onIdleSocket(const IdleSocketEvent& event)
 {
+    if (event.reactor() != this)
+        return;
+
     Socket* socket = event.socket();
 
     log_debug("add idle socket " << static_cast<void*>(socket) << " to selector");
@@ -286,18 +351,24 @@ void ServerImpl::onIdleSocket(const IdleSocketEvent& event)
     socket->timeoutConnection = connect(socket->timeout, timeoutSlot);
 }
 
-void ServerImpl::onActiveSocket(const ActiveSocketEvent& event)
+void Reactor::onActiveSocket(const ActiveSocketEvent& event)
 {
+    if (event.reactor() != this)
+        return;
+
     _queue.put(event.socket());
 }
 
-void ServerImpl::onNoWaitingThreads(const NoWaitingThreadsEvent& /*event*/)
+void Reactor::onNoWaitingThreads(const NoWaitingThreadsEvent& event)
 {
+    if (event.reactor() != this)
+        return;
+
     MutexLock lock(_threadMutex);
 
-    if (_threads.size() >= maxThreads())
+    if (_threads.size() >= _server.maxThreads())
     {
-        log_warn("thread limit " << maxThreads() << " reached");
+        log_warn("thread limit " << _server.maxThreads() << " reached");
         return;
     }
 
@@ -324,8 +395,11 @@ void ServerImpl::onNoWaitingThreads(const NoWaitingThreadsEvent& /*event*/)
     }
 }
 
-void ServerImpl::onThreadTerminated(const ThreadTerminatedEvent& event)
+void Reactor::onThreadTerminated(const ThreadTerminatedEvent& event)
 {
+    if (event.reactor() != this)
+        return;
+
     MutexLock lock(_threadMutex);
     log_debug("thread terminated (" << static_cast<void*>(event.worker()) << ") " << _threads.size() << " threads left");
     try
@@ -340,15 +414,7 @@ void ServerImpl::onThreadTerminated(const ThreadTerminatedEvent& event)
     delete event.worker();
 }
 
-void ServerImpl::onServerStart(const ServerStartEvent& event)
-{
-    if (event.server() == this)
-    {
-        start();
-    }
-}
-
-void ServerImpl::onInput(Socket& socket)
+void Reactor::onInput(Socket& socket)
 {
     socket.removeSelector();
     log_debug("search socket " << static_cast<void*>(&socket) << " in idle sockets");
@@ -358,7 +424,7 @@ void ServerImpl::onInput(Socket& socket)
     {
         socket.inputConnection.close();
         socket.timeoutConnection.close();
-        _eventLoop.commitEvent(ActiveSocketEvent(&socket));
+        _eventLoop.commitEvent(ActiveSocketEvent(this, &socket));
     }
     else
     {
@@ -367,21 +433,160 @@ void ServerImpl::onInput(Socket& socket)
     }
 }
 
-void ServerImpl::onTimeout(Socket& socket)
+void Reactor::onTimeout(Socket& socket)
 {
     log_debug("timeout; socket " << static_cast<void*>(&socket));
 
-    _eventLoop.commitEvent(KeepAliveTimeoutEvent(&socket));
+    _eventLoop.commitEvent(KeepAliveTimeoutEvent(this, &socket));
 }
 
-void ServerImpl::onKeepAliveTimeout(const KeepAliveTimeoutEvent& event)
+void Reactor::onKeepAliveTimeout(const KeepAliveTimeoutEvent& event)
 {
+    if (event.reactor() != this)
+        return;
+
     Socket* socket = event.socket();
     _idleSockets.erase(socket);
     log_debug("onKeepAliveTimeout; delete " << static_cast<void*>(&socket));
     delete socket;
 }
 
+////////////////////////////////////////////////////////////////////////
+// ServerImpl
+//
+ServerImpl::ServerImpl(EventLoopBase& eventLoop, Signal<Server::Runmode>& runmodeChanged)
+    : ServerImplBase(eventLoop, runmodeChanged)
+{
+    _reactors.push_back(new Reactor(*this, _eventLoop));
+
+    _eventLoop.event.subscribe(slot(*this, &ServerImpl::onServerStart));
+
+    connect(_eventLoop.exited, *this, &ServerImpl::terminate);
+
+    _eventLoop.commitEvent(ServerStartEvent(this));
+}
+
+ServerImpl::~ServerImpl()
+{
+    if (runmode() == Server::Running)
+    {
+        try
+        {
+            terminate();
+        }
+        catch (const std::exception& e)
+        {
+            log_fatal("exception in http-server termination occured: " << e.what());
+        }
+    }
+
+    for (Reactors::iterator it = _reactors.begin(); it != _reactors.end(); ++it)
+        delete *it;
+}
+
+void ServerImpl::reactors(unsigned n)
+{
+    // the reactors of a running server have their threads already
+    if (runmode() != Server::Stopped)
+        throw std::logic_error("number of reactors must be set before the server runs");
+
+    for (Reactors::iterator it = _reactors.begin(); it != _reactors.end(); ++it)
+        if ((*it)->isListening())
+            throw std::logic_error("number of reactors must be set before listen");
+
+    ServerImplBase::reactors(n);
+}
+
+void ServerImpl::setupReactors()
+{
+    if (_reactors.size() == reactors())
+        return;
+
+    for (Reactors::iterator it = _reactors.begin(); it != _reactors.end(); ++it)
+        if ((*it)->isListening())
+            throw std::logic_error("number of reactors must be set before listen");
+
+    log_debug("setup " << reactors() << " reactors");
+
+    while (_reactors.size() > reactors())
+    {
+        delete _reactors.back();
+        _reactors.pop_back();
+    }
+
+    while (_reactors.size() < reactors())
+        _reactors.push_back(new Reactor(*this));
+}
+
+void ServerImpl::listen(const std::string& ip, unsigned short int port, const std::string& certificateFile, const std::string& privateKeyFile, int sslVerifyLevel, const std::string& sslCa)
+{
+    log_debug("listen on " << ip << " port " << port << " certificate \"" << certificateFile << "\" private key \"" << privateKeyFile << '"');
+
+    setupReactors();
+
+    unsigned flags = net::TcpServer::DEFER_ACCEPT|net::TcpServer::REUSEADDR;
+    if (_reactors.size() > 1)
+        flags |= net::TcpServer::REUSEPORT;
+
+    for (Reactors::iterator it = _reactors.begin(); it != _reactors.end(); ++it)
+    {
+        (*it)->listen(ip, port, flags, certificateFile, privateKeyFile, sslVerifyLevel, sslCa);
+#ifndef SO_REUSEPORT
+        log_warn_if(_reactors.size() > 1, "SO_REUSEPORT not supported; all connections are accepted by the first reactor");
+        break;
+#endif
+    }
+}
+
+void ServerImpl::start()
+{
+    log_trace("start server");
+    runmode(Server::Starting);
+
+    try
+    {
+        setupReactors();
+    }
+    catch (const std::exception& e)
+    {
+        log_warn(e.what() << "; run " << _reactors.size() << " reactors");
+    }
+
+    for (Reactors::iterator it = _reactors.begin(); it != _reactors.end(); ++it)
+        (*it)->start();
+
+    runmode(Server::Running);
+}
+
+void ServerImpl::terminate()
+{
+    log_trace("terminate");
+
+    for (Reactors::iterator it = _reactors.begin(); it != _reactors.end(); ++it)
+        (*it)->stop();
+
+    runmode(Server::Terminating);
+
+    try
+    {
+        for (Reactors::iterator it = _reactors.begin(); it != _reactors.end(); ++it)
+            (*it)->terminate();
+
+        runmode(Server::Stopped);
+    }
+    catch (const std::exception& e)
+    {
+        runmode(Server::Failed);
+    }
+}
+
+void ServerImpl::onServerStart(const ServerStartEvent& event)
+{
+    if (event.server() == this)
+    {
+        start();
+    }
+}
 
 }
 }
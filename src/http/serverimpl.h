@@ -40,6 +40,8 @@ namespace cxxtools
 {
 
 class EventLoopBase;
+class EventLoop;
+class AttachedThread;
 
 namespace net
 {
@@ -59,22 +61,36 @@ class NoWaitingThreadsEvent;
 class ThreadTerminatedEvent;
 class ActiveSocketEvent;
 
-class ServerImpl : public ServerImplBase, public Connectable
+/// A reactor is an event loop with its listeners, idle sockets and workers.
+class Reactor : public Connectable
 {
     public:
-        ServerImpl(EventLoopBase& eventLoop, Signal<Server::Runmode>& runmodeChanged);
-        ~ServerImpl();
+        /// Creates a reactor running on the passed event loop.
+        Reactor(ServerImpl& server, EventLoopBase& eventLoop);
 
-        // override from ServerImplBase
-        void listen(const std::string& ip, unsigned short int port, const std::string& certificateFile, const std::string& privateKeyFile, int sslVerifyLevel, const std::string& sslCa);
+        /// Creates a reactor with its own event loop running in a separate thread.
+        explicit Reactor(ServerImpl& server);
 
-        bool isTerminating() const
-        { return runmode() == Server::Terminating; }
+        ~Reactor();
+
+        void listen(const std::string& ip, unsigned short int port, unsigned flags, const std::string& certificateFile, const std::string& privateKeyFile, int sslVerifyLevel, const std::string& sslCa);
+
+        bool isListening() const
+        { return !_listener.empty(); }
+
+        bool isTerminating() const;
+        unsigned minThreads() const;
+
+        void start();
+
+        /// Stops the own event loop thread and processes pending events.
+        void stop();
 
-        // override from ServerImplBase
         void terminate();
 
     private:
+        void init();
+
         void noWaitingThreads();
         void onInput(Socket& _socket);
         void onTimeout(Socket& _socket);
@@ -85,15 +101,18 @@ class ServerImpl : public ServerImplBase, public Connectable
         void onKeepAliveTimeout(const KeepAliveTimeoutEvent& event);
         void onNoWaitingThreads(const NoWaitingThreadsEvent& event);
         void onThreadTerminated(const ThreadTerminatedEvent& event);
-        void onServerStart(const ServerStartEvent& event);
-        void start();
 
         friend class Worker;
 
         ////////////////////////////////////////////////////
 
-        MethodSlot<void, ServerImpl, Socket&> inputSlot;
-        MethodSlot<void, ServerImpl, Socket&> timeoutSlot;
+        ServerImpl& _server;
+        EventLoop* _ownEventLoop;
+        AttachedThread* _eventLoopThread;
+        EventLoopBase& _eventLoop;
+
+        MethodSlot<void, Reactor, Socket&> inputSlot;
+        MethodSlot<void, Reactor, Socket&> timeoutSlot;
 
         Queue<Socket*> _queue;
         std::set<Socket*> _idleSockets;
@@ -111,6 +130,35 @@ class ServerImpl : public ServerImplBase, public Connectable
         void threadTerminated(Worker* worker);
 };
 
+class ServerImpl : public ServerImplBase, public Connectable
+{
+    public:
+        ServerImpl(EventLoopBase& eventLoop, Signal<Server::Runmode>& runmodeChanged);
+        ~ServerImpl();
+
+        // override from ServerImplBase
+        void listen(const std::string& ip, unsigned short int port, const std::string& certificateFile, const std::string& privateKeyFile, int sslVerifyLevel, const std::string& sslCa);
+
+        bool isTerminating() const
+        { return runmode() == Server::Terminating; }
+
+        // override from ServerImplBase
+        void terminate();
+
+        using ServerImplBase::reactors;
+
+        // override from ServerImplBase
+        void reactors(unsigned n);
+
+    private:
+        void setupReactors();
+        void onServerStart(const ServerStartEvent& event);
+        void start();
+
+        typedef std::vector<Reactor*> Reactors;
+        Reactors _reactors;
+};
+
 }
 }
 
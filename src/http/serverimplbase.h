@@ -59,6 +59,7 @@ class ServerImplBase
               _keepAliveTimeout(Seconds(30)),
               _minThreads(5),
               _maxThreads(200),
+              _reactors(1),
               _runmodeChanged(runmodeChanged),
               _runmode(Server::Stopped)
         { }
@@ -93,6 +94,9 @@ class ServerImplBase
         unsigned maxThreads() const           { return _maxThreads; }
         void maxThreads(unsigned m)           { _maxThreads = m; }
 
+        unsigned reactors() const             { return _reactors; }
+        virtual void reactors(unsigned n)     { _reactors = n > 0 ? n : 1; }
+
         virtual void terminate()              { }
         Server::Runmode runmode() const
         { return _runmode; }
@@ -115,6 +119,7 @@ class ServerImplBase
 
         unsigned _minThreads;
         unsigned _maxThreads;
+        unsigned _reactors;
 
         Signal<Server::Runmode>& _runmodeChanged;
         Server::Runmode _runmode;
@@ -29,9 +29,19 @@
 #include "socket.h"
 #include "serverimpl.h"
 #include <cxxtools/log.h>
+#include <cxxtools/ioerror.h>
+#include <cxxtools/systemerror.h>
+#include <cxxtools/limitstream.h>
+#include <algorithm>
 #include <cassert>
+#include <errno.h>
+#include <unistd.h>
 #include "config.h"
 
+#if defined(HAVE_SENDFILE) && defined(HAVE_SYS_SENDFILE_H)
+#include <sys/sendfile.h>
+#endif
+
 log_define("cxxtools.http.socket")
 
 namespace cxxtools
@@ -64,6 +74,11 @@ Socket::Socket(ServerImpl& server, net::TcpServer& tcpServer, const std::string&
       _parseEvent(_request),
       _parser(_parseEvent, false),
       _responder(0),
+      _fileOffset(0),
+      _fileRemaining(0),
+      _useSendfile(false),
+      _keepAlive(false),
+      _replyPending(false),
       _sslVerifyLevel(sslVerifyLevel),
       _sslCa(sslCa),
       _accepted(false)
@@ -86,6 +101,11 @@ Socket::Socket(Socket& socket)
       _parseEvent(_request),
       _parser(_parseEvent, false),
       _responder(0),
+      _fileOffset(0),
+      _fileRemaining(0),
+      _useSendfile(false),
+      _keepAlive(false),
+      _replyPending(false),
       _sslVerifyLevel(socket._sslVerifyLevel),
       _sslCa(socket._sslCa),
       _accepted(false)
@@ -166,6 +186,26 @@ void Socket::onInput(StreamBuffer& sb)
     }
 
     _timer.start(_server.readTimeout());
+
+    // Process all requests, which are already received. Pipelined replies
+    // are collected in the output buffer and sent with a single write.
+    while (processRequest(sb))
+    {
+        if (!_keepAlive || _fileRemaining > 0 || sb.in_avail() == 0)
+            break;
+
+        log_debug("process pipelined request");
+        nextRequest();
+    }
+
+    if (_replyPending || sb.out_avail() > 0)
+        onOutput(sb);
+    else
+        sb.beginRead();
+}
+
+bool Socket::processRequest(StreamBuffer& sb)
+{
     if ( _responder == 0 )
     {
         _parser.advance(sb);
@@ -173,90 +213,80 @@ void Socket::onInput(StreamBuffer& sb)
         if (_parser.fail())
         {
             _responder = _server.getDefaultResponder(_request);
+            _reply.setHeader("Connection", "close");
             _responder->replyError(_reply.bodyStream(), _request, _reply,
                 std::runtime_error("invalid http header"));
             _responder->release();
             _responder = 0;
 
             sendReply();
-
-            onOutput(sb);
-            return;
+            return true;
         }
 
-        if (_parser.end())
-        {
-            log_info("request " << _request.method() << ' ' << _request.header().query()
-                << " from client " << getPeerAddr());
-            _responder = _server.getResponder(_request);
-            try
-            {
-                _responder->beginRequest(*this, _stream, _request);
-            }
-            catch (const std::exception& e)
-            {
-                _reply.setHeader("Connection", "close");
-                _responder->replyError(_reply.bodyStream(), _request, _reply, e);
-                _responder->release();
-                _responder = 0;
-                sendReply();
-
-                onOutput(sb);
-                return;
-            }
-
-            _contentLength = _request.header().contentLength();
-            log_debug("content length of request is " << _contentLength);
-            if (_contentLength == 0)
-            {
-                _timer.stop();
-                doReply();
-                return;
-            }
+        if (!_parser.end())
+            return false;
 
+        log_info("request " << _request.method() << ' ' << _request.header().query()
+            << " from client " << getPeerAddr());
+        _responder = _server.getResponder(_request);
+        try
+        {
+            _responder->beginRequest(*this, _stream, _request);
         }
-        else
+        catch (const std::exception& e)
         {
-            sb.beginRead();
+            _reply.setHeader("Connection", "close");
+            _responder->replyError(_reply.bodyStream(), _request, _reply, e);
+            _responder->release();
+            _responder = 0;
+            sendReply();
+            return true;
         }
+
+        _contentLength = _request.header().contentLength();
+        log_debug("content length of request is " << _contentLength);
     }
 
-    if (_responder)
+    if (_contentLength > 0 && sb.in_avail() > 0)
     {
-        if (sb.in_avail() > 0)
+        try
         {
-            try
-            {
-                std::size_t s = _responder->readBody(_stream);
-                assert(s > 0);
-                _contentLength -= s;
-            }
-            catch (const std::exception& e)
+            std::size_t s;
+            if (sb.in_avail() > _contentLength)
             {
-                _reply.setHeader("Connection", "close");
-                _responder->replyError(_reply.bodyStream(), _request, _reply, e);
-                _responder->release();
-                _responder = 0;
-                sendReply();
-
-                onOutput(sb);
-                return;
+                // the next request follows the body; do not let the
+                // responder read past it
+                std::streamsize avail = sb.in_avail();
+                LimitIStream body(_stream, _contentLength);
+                _responder->readBody(body);
+                s = avail - sb.in_avail();
             }
-        }
+            else
+                s = _responder->readBody(_stream);
 
-        if (_contentLength <= 0)
-        {
-            _timer.stop();
-            doReply();
+            assert(s > 0);
+            _contentLength -= s;
         }
-        else
+        catch (const std::exception& e)
         {
-            sb.beginRead();
+            _reply.setHeader("Connection", "close");
+            _responder->replyError(_reply.bodyStream(), _request, _reply, e);
+            _responder->release();
+            _responder = 0;
+            sendReply();
+            return true;
         }
     }
+
+    if (_contentLength > 0)
+        return false;
+
+    _timer.stop();
+    doReply();
+    return true;
 }
 
-bool Socket::doReply()
+void Socket::doReply()
 {
     log_trace("http::Socket::doReply");
     try
@@ -274,8 +304,14 @@ bool Socket::doReply()
     _responder = 0;
 
     sendReply();
+}
 
-    return onOutput(_stream.buffer());
+void Socket::nextRequest()
+{
+    _request.clear();
+    _reply.clear();
+    _parser.reset(false);
+    _replyPending = false;
 }
 
 bool Socket::onOutput(StreamBuffer& sb)
@@ -288,6 +324,9 @@ bool Socket::onOutput(StreamBuffer& sb)
     {
         sb.endWrite();
 
+        if ( !sb.out_avail() && _fileRemaining > 0 )
+            sendFile();
+
         if ( sb.out_avail() )
         {
             sb.beginWrite();
@@ -295,27 +334,35 @@ bool Socket::onOutput(StreamBuffer& sb)
         }
         else
         {
-            bool keepAlive = _request.header().keepAlive()
-                          && _reply.header().keepAlive();
-
-            if (keepAlive)
+            if (_replyPending)
             {
+                if (!_keepAlive)
+                {
+                    log_debug("don't do keep alive");
+                    close();
+                    return false;
+                }
+
                 log_debug("do keep alive");
+                nextRequest();
                 _timer.start(_server.keepAliveTimeout());
-                _request.clear();
-                _reply.clear();
-                _parser.reset(false);
-                if (sb.in_avail())
-                    onInput(sb);
-                else
-                    _stream.buffer().beginRead();
             }
             else
             {
-                log_debug("don't do keep alive");
-                close();
-                return false;
+                // a pipelined request is not yet received completely
+                _timer.start(_server.readTimeout());
             }
+
+            if (sb.in_avail() == 0)
+                _stream.buffer().beginRead();
+            else if (inputConnection.valid())
+            {
+                // The socket is idle and the reply was finished by the
+                // reactor; pass the pipelined requests to a worker thread.
+                inputReady(*this);
+            }
+            else
+                onInput(sb);
         }
     }
     catch (const std::exception& e)
@@ -383,8 +430,67 @@ void Socket::sendReply()
 
     _stream << "\r\n";
 
-    _reply.sendBody(_stream);
+    // The socket is written asynchronously through its stream buffer, so the
+    // body blocks are copied to it once. They are not written with writev;
+    // only a file range set with Reply::setFile is sent without copying.
+    _reply.sendBody(static_cast<std::ostream&>(_stream));
+
+    _fileOffset = _reply.fileOffset();
+    _fileRemaining = _reply.fileSize();
+    _useSendfile = !isSslConnected();
+
+    _keepAlive = _request.header().keepAlive()
+              && _reply.header().keepAlive();
+    _replyPending = true;
+}
+
+void Socket::sendFile()
+{
+#if defined(HAVE_SENDFILE) && defined(HAVE_SYS_SENDFILE_H)
+    while (_useSendfile && _fileRemaining > 0)
+    {
+        off_t offset = _fileOffset;
+        ssize_t n = ::sendfile(getFd(), _reply.fileFd(), &offset, _fileRemaining);
+        if (n > 0)
+        {
+            log_debug("sendfile wrote " << n << " bytes");
+            _fileOffset += n;
+            _fileRemaining -= n;
+        }
+        else if (n == 0)
+            throw IOError("file truncated while sending");
+        else if (errno == EAGAIN)
+            break;
+        else if (errno == EINVAL || errno == ENOSYS)
+        {
+            log_debug("sendfile not supported for file; use buffered writes");
+            _useSendfile = false;
+        }
+        else if (errno != EINTR)
+            throwSystemError("sendfile");
+    }
 
+    if (_fileRemaining == 0)
+        return;
+#endif
+
+    // Copy the next part of the file to the stream buffer. With sendfile
+    // this happens only when the socket is full and the completion of the
+    // buffered write tells us, when the socket is writable again.
+    char buffer[8192];
+    std::size_t count = std::min(_fileRemaining, sizeof(buffer));
+    ssize_t n;
+    while ((n = ::pread(_reply.fileFd(), buffer, count, _fileOffset)) < 0 && errno == EINTR)
+        ;
+
+    if (n < 0)
+        throwSystemError("pread");
+    if (n == 0)
+        throw IOError("file truncated while sending");
+
+    _stream.write(buffer, n);
+    _fileOffset += n;
+    _fileRemaining -= n;
 }
 
 bool Socket::onAcceptSslCertificate(const SslCertificate& cert)
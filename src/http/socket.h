@@ -81,8 +81,11 @@ class Socket : public net::TcpSocket, public Connectable
         void onTimeout();
         bool onAcceptSslCertificate(const SslCertificate& cert);
 
-        bool doReply();
+        bool processRequest(StreamBuffer& sb);
+        void doReply();
         void sendReply();
+        void nextRequest();
+        void sendFile();
         bool isReady() const
         { return _parser.end() && _contentLength == 0; }
 
@@ -115,6 +118,16 @@ class Socket : public net::TcpSocket, public Connectable
         Responder* _responder;
         IOStream _stream;
 
+        // part of the reply file not yet sent
+        std::streamoff _fileOffset;
+        std::size_t _fileRemaining;
+        bool _useSendfile;
+
+        // set when a reply is sent; the request and reply objects are
+        // cleared for the next request once it is written
+        bool _keepAlive;
+        bool _replyPending;
+
         int _sslVerifyLevel;
         std::string _sslCa;
         bool _accepted;
@@ -42,19 +42,19 @@ namespace http
 void Worker::run()
 {
     log_info("new thread running");
-    while (!_server.isTerminating() && _server._queue.numWaiting() < _server.minThreads())
+    while (!_reactor.isTerminating() && _reactor._queue.numWaiting() < _reactor.minThreads())
     {
-        Socket* socket = _server._queue.get();
+        Socket* socket = _reactor._queue.get();
 
-        if (_server.isTerminating())
+        if (_reactor.isTerminating())
         {
             log_debug("server is terminating - quit thread");
-            _server._queue.put(socket);
+            _reactor._queue.put(socket);
             break;
         }
 
-        if (_server._queue.numWaiting() == 0)
-            _server.noWaitingThreads();
+        if (_reactor._queue.numWaiting() == 0)
+            _reactor.noWaitingThreads();
 
         try
         {
@@ -66,22 +66,22 @@ void Worker::run()
                     socket->accept();
                     log_debug("connection accepted from " << socket->getPeerAddr());
 
-                    if (_server.isTerminating())
+                    if (_reactor.isTerminating())
                     {
                         log_debug("server is terminating - quit thread");
-                        _server._queue.put(socket);
+                        _reactor._queue.put(socket);
                         break;
                     }
 
                     // new connection arrived - create new accept socket
                     log_info("new connection accepted from " << socket->getPeerAddr());
-                    _server._queue.put(new Socket(*socket));
+                    _reactor._queue.put(new Socket(*socket));
 
                     socket->postAccept();
                 }
                 catch (const std::exception&)
                 {
-                    _server._queue.put(new Socket(*socket));
+                    _reactor._queue.put(new Socket(*socket));
                     throw;
                 }
             }
@@ -108,11 +108,11 @@ void Worker::run()
             {
                 log_debug("timeout processing socket");
                 inputConnection.close();
-                _server.addIdleSocket(socket);
+                _reactor.addIdleSocket(socket);
             }
-            else if (_server.isTerminating())
+            else if (_reactor.isTerminating())
             {
-                _server._queue.put(socket);
+                _reactor._queue.put(socket);
             }
             else
             {
@@ -133,7 +133,7 @@ void Worker::run()
     }
 
     log_info("thread terminated");
-    _server.threadTerminated(this);
+    _reactor.threadTerminated(this);
 }
 
 
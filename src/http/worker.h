@@ -36,21 +36,21 @@ namespace cxxtools
 namespace http
 {
 
-class ServerImpl;
+class Reactor;
 
 class Worker : public AttachedThread
 {
     public:
-        explicit Worker(ServerImpl& server)
+        explicit Worker(Reactor& reactor)
             : AttachedThread(callable(*this, &Worker::run)),
-              _server(server)
+              _reactor(reactor)
         {
         }
 
         void run();
 
     private:
-        ServerImpl& _server;
+        Reactor& _reactor;
 };
 
 }
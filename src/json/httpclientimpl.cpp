@@ -115,11 +115,10 @@ void HttpClientImpl::call(IComposer& r, IRemoteProcedure& method, IDecomposer**
 
     _scanner.begin(_deserializer, r);
 
-    char ch;
-    std::istream& is = _client.in();
-    while (is.get(ch))
+    std::streambuf& sb = *_client.in().rdbuf();
+    while (sb.sgetc() != std::streambuf::traits_type::eof())
     {
-        if (_deserializer.advance(ch) != 0)
+        if (_deserializer.advance(sb))
         {
             log_debug("scanner finished");
             _proc = 0;
@@ -183,12 +182,13 @@ void HttpClientImpl::onReplyHeader(http::Client& client)
 std::size_t HttpClientImpl::onReplyBody(http::Client& client)
 {
     std::size_t count = 0;
-    char ch;
-    std::istream& is = client.in();
-    while (is.rdbuf()->in_avail() && is.get(ch))
+    std::streambuf& sb = *client.in().rdbuf();
+    while (sb.in_avail() > 0)
     {
-        ++count;
-        if (_deserializer.advance(ch))
+        std::size_t n;
+        bool finished = _deserializer.advance(sb, n);
+        count += n;
+        if (finished)
         {
             log_debug("scanner finished");
             try
@@ -59,11 +59,13 @@ std::size_t HttpResponder::readBody(std::istream& is)
     log_debug("begin request");
     std::size_t n = 0;
 
-    char ch;
-    while (is.get(ch))
+    std::streambuf& sb = *is.rdbuf();
+    while (sb.sgetc() != std::streambuf::traits_type::eof())
     {
-        ++n;
-        if (_responder.advance(ch))
+        std::size_t count;
+        bool finished = _responder.advance(sb, count);
+        n += count;
+        if (finished)
             break;
     }
 
@@ -181,5 +181,28 @@ bool Responder::advance(char ch)
     }
 }
 
+bool Responder::advance(std::streambuf& in)
+{
+    std::size_t count;
+    return advance(in, count);
+}
+
+bool Responder::advance(std::streambuf& in, std::size_t& count)
+{
+    count = 0;
+
+    try
+    {
+        return _deserializer.advance(in, count);
+    }
+    catch (const JsonParserError& e)
+    {
+        _failed = true;
+        _errorCode = ParseError;
+        _errorMessage = e.what();
+        return true;
+    }
+}
+
 }
 }
@@ -61,6 +61,8 @@ class Responder
 
         void begin();
         bool advance(char ch);
+        bool advance(std::streambuf& in);
+        bool advance(std::streambuf& in, std::size_t& count);
         void finalize(std::ostream& out);
         bool failed() const
         { return _failed; }
@@ -190,14 +190,13 @@ void RpcClientImpl::call(IComposer& r, IRemoteProcedure& method, IDecomposer** a
 
         while (true)
         {
-            int ch = sb.sbumpc();
-            if (ch == StreamBuffer::traits_type::eof())
+            if (sb.sgetc() == StreamBuffer::traits_type::eof())
             {
                 cancel();
                 throw std::runtime_error("reading result failed");
             }
 
-            if (_deserializer.advance(ch))
+            if (_deserializer.advance(sb))
             {
                 _proc = 0;
                 _scanner.finalizeReply();
@@ -378,8 +377,7 @@ void RpcClientImpl::onInput(StreamBuffer& sb)
 
         while (_stream.buffer().in_avail())
         {
-            char ch = StreamBuffer::traits_type::to_char_type(_stream.buffer().sbumpc());
-            if (_deserializer.advance(ch))
+            if (_deserializer.advance(_stream.buffer()))
             {
                 _scanner.finalizeReply();
                 IRemoteProcedure* proc = _proc;
@@ -136,7 +136,7 @@ void Socket::onInput(StreamBuffer& sb)
 
     while (sb.in_avail() > 0)
     {
-        if (_responder.advance(sb.sbumpc()))
+        if (_responder.advance(sb))
         {
             _responder.finalize(_stream);
             buffer().beginWrite();
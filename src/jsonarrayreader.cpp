@@ -0,0 +1,237 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#include <cxxtools/jsonarrayreader.h>
+#include <cxxtools/log.h>
+
+#include <algorithm>
+#include <cctype>
+#include <istream>
+
+log_define("cxxtools.json.arrayreader")
+
+namespace cxxtools
+{
+
+JsonArrayReader::JsonArrayReader(std::istream& in)
+    : _in(in.rdbuf())
+{
+    init();
+}
+
+JsonArrayReader::JsonArrayReader(std::streambuf& in)
+    : _in(&in)
+{
+    init();
+}
+
+void JsonArrayReader::init()
+{
+    _buffer.resize(8192);
+    _begin = _end = &_buffer[0];
+    _lineNo = 1;
+    _count = 0;
+    _state = state_0;
+    _nextState = state_0;
+    _deserializer.reuseStorage(true);
+}
+
+bool JsonArrayReader::fill()
+{
+    std::streamsize n = _in->in_avail();
+    if (n <= 0)
+    {
+        if (_in->sgetc() == std::streambuf::traits_type::eof())
+            return false;
+        n = std::max(_in->in_avail(), static_cast<std::streamsize>(1));
+    }
+
+    n = _in->sgetn(&_buffer[0], std::min(n, static_cast<std::streamsize>(_buffer.size())));
+    _begin = &_buffer[0];
+    _end = _begin + n;
+    return n > 0;
+}
+
+void JsonArrayReader::doThrow(const std::string& msg)
+{
+    throw JsonParserError(msg, _lineNo);
+}
+
+void JsonArrayReader::readElement()
+{
+    // The parser counts the lines of the element only. Errors are reported
+    // with the line in the whole input.
+
+    _deserializer.begin();
+
+    while (true)
+    {
+        const char* b = _begin;
+        bool finished;
+
+        try
+        {
+            finished = _deserializer.advance(_begin, _end);
+        }
+        catch (const JsonParserError& e)
+        {
+            _lineNo += std::count(b, _begin, '\n');
+            doThrow(e.std::runtime_error::what());
+        }
+
+        _lineNo += std::count(b, _begin, '\n');
+
+        if (finished || !fill())
+            break;
+    }
+
+    try
+    {
+        _deserializer.finish();
+    }
+    catch (const JsonParserError& e)
+    {
+        doThrow(e.std::runtime_error::what());
+    }
+
+    ++_count;
+}
+
+bool JsonArrayReader::next()
+{
+    while (_state != state_end)
+    {
+        if (_begin == _end && !fill())
+        {
+            log_warn("unexpected end of json array; state=" << _state);
+            doThrow("unexpected end of json");
+        }
+
+        char ch = *_begin;
+
+        switch (_state)
+        {
+            case state_0:
+                if (ch == '[')
+                    _state = state_array;
+                else if (ch == '/')
+                {
+                    _nextState = _state;
+                    _state = state_comment0;
+                }
+                else if (!std::isspace(static_cast<unsigned char>(ch)))
+                    doThrow(std::string("json array expected; found character '") + ch + '\'');
+                break;
+
+            case state_array:
+                if (ch == ']')
+                    _state = state_end;
+                else if (ch == '/')
+                {
+                    _nextState = _state;
+                    _state = state_comment0;
+                }
+                else if (!std::isspace(static_cast<unsigned char>(ch)))
+                {
+                    readElement();
+                    _state = state_next;
+                    return true;
+                }
+                break;
+
+            case state_element:
+                // an element must follow the comma
+                if (ch == ']')
+                    doThrow("unexpected ']' after ',' in json array");
+                else if (ch == '/')
+                {
+                    _nextState = _state;
+                    _state = state_comment0;
+                }
+                else if (!std::isspace(static_cast<unsigned char>(ch)))
+                {
+                    readElement();
+                    _state = state_next;
+                    return true;
+                }
+                break;
+
+            case state_next:
+                if (ch == ',')
+                    _state = state_element;
+                else if (ch == ']')
+                    _state = state_end;
+                else if (ch == '/')
+                {
+                    _nextState = _state;
+                    _state = state_comment0;
+                }
+                else if (!std::isspace(static_cast<unsigned char>(ch)))
+                    doThrow(std::string("invalid character '") + ch + "' in json array");
+                break;
+
+            case state_comment0:
+                if (ch == '/')
+                    _state = state_commentline;
+                else if (ch == '*')
+                    _state = state_comment;
+                else
+                    doThrow(std::string("invalid character '") + ch + '\'');
+                break;
+
+            case state_commentline:
+                if (ch == '\n')
+                    _state = _nextState;
+                break;
+
+            case state_comment:
+                if (ch == '*')
+                    _state = state_comment_e;
+                break;
+
+            case state_comment_e:
+                if (ch == '/')
+                    _state = _nextState;
+                else if (ch != '*')
+                    _state = state_comment;
+                break;
+
+            case state_end:
+                break;
+        }
+
+        if (ch == '\n')
+            ++_lineNo;
+        ++_begin;
+    }
+
+    return false;
+}
+
+}
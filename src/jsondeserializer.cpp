@@ -27,6 +27,7 @@
  */
 
 #include <cxxtools/jsondeserializer.h>
+#include "streampeek.h"
 
 namespace cxxtools
 {
@@ -125,6 +126,52 @@ JsonDeserializer::JsonDeserializer(std::basic_istream<Char>& in)
     finish();
 }
 
+JsonDeserializer::JsonDeserializer(std::streambuf& in)
+{
+    begin();
+
+    while (in.sgetc() != std::streambuf::traits_type::eof())
+    {
+        if (advance(in))
+            break;
+    }
+
+    finish();
+}
+
+bool JsonDeserializer::advance(std::streambuf& in)
+{
+    std::size_t count;
+    return advance(in, count);
+}
+
+bool JsonDeserializer::advance(std::streambuf& in, std::size_t& count)
+{
+    count = 0;
+
+    // parse a copy of the input and consume only what the parser took, so
+    // that the bytes following the json value stay in the buffer
+    char buffer[8192];
+    std::streamsize n = peekInput(in, buffer, sizeof(buffer));
+    while (n > 0)
+    {
+        const char* p = buffer;
+        bool finished = advance(p, buffer + n);
+        skipInput(in, p - buffer);
+        count += p - buffer;
+
+        if (finished)
+            return true;
+
+        if (in.in_avail() <= 0)
+            break;
+
+        n = peekInput(in, buffer, sizeof(buffer));
+    }
+
+    return false;
+}
+
 void JsonDeserializer::begin()
 {
     Deserializer::begin();
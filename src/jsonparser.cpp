@@ -32,6 +32,7 @@
 #include <cxxtools/utf8codec.h>
 #include <cxxtools/log.h>
 
+#include <algorithm>
 #include <cctype>
 #include <sstream>
 
@@ -70,6 +71,36 @@ void JsonParser::throwInvalidCharacter(Char ch)
   doThrow((std::string("invalid character '") + ch.narrow() + '\''));
 }
 
+void JsonParser::JsonStringParser::append(Char ch)
+{
+    if (!_jsonParser->_byteMode)
+        _str += ch;
+    else if (!_wide && ch.value() < 0x80)
+        _bytes += static_cast<char>(ch.value());
+    else
+    {
+        if (!_wide)
+        {
+            // A non ascii character was escaped. Continue with a unicode string
+            // so that its value is kept.
+            _str.assign(_bytes);
+            _bytes.clear();
+            _wide = true;
+        }
+
+        _str += ch;
+    }
+}
+
+void JsonParser::JsonStringParser::str(const std::string& s)
+{
+    _wide = false;
+    if (_jsonParser->_byteMode)
+        _bytes = s;
+    else
+        _str.assign(s);
+}
+
 bool JsonParser::JsonStringParser::advance(Char ch)
 {
     switch (_state)
@@ -80,23 +111,23 @@ bool JsonParser::JsonStringParser::advance(Char ch)
             else if (ch == '"')
                 return true;
             else
-                _str += ch;
+                append(ch);
             break;
 
         case state_esc:
             _state = state_0;
             if (ch == '"' || ch == '\\' || ch == '/')
-                _str += ch;
+                append(ch);
             else if (ch == 'b')
-                _str += '\b';
+                append('\b');
             else if (ch == 'f')
-                _str += '\f';
+                append('\f');
             else if (ch == 'n')
-                _str += '\n';
+                append('\n');
             else if (ch == 'r')
-                _str += '\r';
+                append('\r');
             else if (ch == 't')
-                _str += '\t';
+                append('\t');
             else if (ch == 'u')
             {
                 _value = 0;
@@ -119,7 +150,7 @@ bool JsonParser::JsonStringParser::advance(Char ch)
 
             if (--_count == 0)
             {
-                _str += Char(static_cast<wchar_t>(_value));
+                append(Char(static_cast<wchar_t>(_value)));
                 _state = state_0;
             }
 
@@ -134,7 +165,8 @@ JsonParser::JsonParser()
     : _deserializer(0),
       _stringParser(this),
       _next(0),
-      _lineNo(1)
+      _lineNo(1),
+      _byteMode(false)
 { }
 
 JsonParser::~JsonParser()
@@ -142,6 +174,52 @@ JsonParser::~JsonParser()
     delete _next;
 }
 
+void JsonParser::beginNext()
+{
+    if (_next == 0)
+        _next = new JsonParser();
+
+    _next->begin(*_deserializer);
+    _next->_byteMode = _byteMode;
+}
+
+void JsonParser::beginObjectMember()
+{
+    if (_stringParser.wide())
+    {
+        log_debug("begin object member " << _stringParser.str());
+        _deserializer->beginMember(Utf8Codec::encode(_stringParser.str()),
+                std::string(), SerializationInfo::Void);
+    }
+    else
+    {
+        log_debug("begin object member " << _stringParser.bytes());
+        _deserializer->beginMember(_stringParser.bytes(),
+                std::string(), SerializationInfo::Void);
+    }
+
+    beginNext();
+    _stringParser.clear();
+    _state = state_object_value;
+}
+
+void JsonParser::setStringValue()
+{
+    if (_stringParser.wide())
+    {
+        log_debug("set string value \"" << _stringParser.str() << '"');
+        _deserializer->setValue(_stringParser.str());
+    }
+    else
+    {
+        log_debug("set string value \"" << _stringParser.bytes() << '"');
+        _deserializer->setValue(_stringParser.bytes());
+    }
+
+    _deserializer->setTypeName("string");
+    _stringParser.clear();
+}
+
 int JsonParser::advance(Char ch)
 {
     int ret;
@@ -171,7 +249,7 @@ int JsonParser::advance(Char ch)
                 }
                 else if ((ch >= '0' && ch <= '9') || ch == '+' || ch == '-')
                 {
-                    _token = ch;
+                    _token = ch.narrow();
                     _state = state_number;
                     _deserializer->setCategory(SerializationInfo::Value);
                 }
@@ -182,7 +260,7 @@ int JsonParser::advance(Char ch)
                 }
                 else if (!std::isspace(ch.value()))
                 {
-                    _token = ch;
+                    _token = ch.narrow();
                     _state = state_token;
                 }
                 break;
@@ -205,7 +283,7 @@ int JsonParser::advance(Char ch)
                 }
                 else if (std::isalpha(ch.value()))
                 {
-                    _token = ch;
+                    _token = ch.narrow();
                     _state = state_object_plainname;
                 }
                 else if (!std::isspace(ch.value()))
@@ -214,7 +292,7 @@ int JsonParser::advance(Char ch)
 
             case state_object_plainname:
                 if (std::isalnum(ch.value()) || ch == 'l')
-                    _token += ch;
+                    _token += ch.narrow();
                 else if (std::isspace(ch.value()))
                 {
                     _stringParser.str(_token);
@@ -223,14 +301,7 @@ int JsonParser::advance(Char ch)
                 else if (ch == ':')
                 {
                     _stringParser.str(_token);
-                    if (_next == 0)
-                        _next = new JsonParser();
-                    log_debug("begin object member " << _stringParser.str());
-                    _deserializer->beginMember(Utf8Codec::encode(_stringParser.str()),
-                            std::string(), SerializationInfo::Void);
-                    _next->begin(*_deserializer);
-                    _stringParser.clear();
-                    _state = state_object_value;
+                    beginObjectMember();
                 }
                 else
                     throwInvalidCharacter(ch);
@@ -245,14 +316,7 @@ int JsonParser::advance(Char ch)
             case state_object_after_name:
                 if (ch == ':')
                 {
-                    if (_next == 0)
-                        _next = new JsonParser();
-                    log_debug("begin object member " << _stringParser.str());
-                    _deserializer->beginMember(Utf8Codec::encode(_stringParser.str()),
-                            std::string(), SerializationInfo::Void);
-                    _next->begin(*_deserializer);
-                    _stringParser.clear();
-                    _state = state_object_value;
+                    beginObjectMember();
                 }
                 else if (ch == '/')
                 {
@@ -321,7 +385,7 @@ int JsonParser::advance(Char ch)
                 }
                 else if (std::isalpha(ch.value()))
                 {
-                    _token = ch;
+                    _token = ch.narrow();
                     _state = state_object_plainname;
                 }
                 else if (!std::isspace(ch.value()))
@@ -341,13 +405,10 @@ int JsonParser::advance(Char ch)
                 }
                 else if (!std::isspace(ch.value()))
                 {
-                    if (_next == 0)
-                        _next = new JsonParser();
-
                     log_debug("begin array member");
                     _deserializer->beginMember(std::string(),
                             std::string(), SerializationInfo::Void);
-                    _next->begin(*_deserializer);
+                    beginNext();
                     _next->advance(ch);
                     _state = state_array_value;
                 }
@@ -367,7 +428,7 @@ int JsonParser::advance(Char ch)
                 log_debug("begin array member");
                 _deserializer->beginMember(std::string(),
                         std::string(), SerializationInfo::Void);
-                _next->begin(*_deserializer);
+                beginNext();
                 _state = state_array_value;
 
                 // no break
@@ -406,10 +467,7 @@ int JsonParser::advance(Char ch)
             case state_string:
                 if (_stringParser.advance(ch))
                 {
-                    log_debug("set string value \"" << _stringParser.str() << '"');
-                    _deserializer->setValue(_stringParser.str());
-                    _deserializer->setTypeName("string");
-                    _stringParser.clear();
+                    setStringValue();
                     _state = state_end;
                     return 1;
                 }
@@ -422,16 +480,17 @@ int JsonParser::advance(Char ch)
                     _deserializer->setValue(_token);
                     _deserializer->setTypeName("int");
                     _token.clear();
+                    _state = state_end;
                     return 1;
                 }
                 else if (ch == '.' || ch == 'e' || ch == 'E')
                 {
-                    _token += ch;
+                    _token += ch.narrow();
                     _state = state_float;
                 }
                 else if (ch >= '0' && ch <= '9')
                 {
-                    _token += ch;
+                    _token += ch.narrow();
                 }
                 else
                 {
@@ -439,6 +498,7 @@ int JsonParser::advance(Char ch)
                     _deserializer->setValue(_token);
                     _deserializer->setTypeName("int");
                     _token.clear();
+                    _state = state_end;
                     return -1;
                 }
                 break;
@@ -450,24 +510,26 @@ int JsonParser::advance(Char ch)
                     _deserializer->setValue(_token);
                     _deserializer->setTypeName("double");
                     _token.clear();
+                    _state = state_end;
                     return 1;
                 }
                 else if ((ch >= '0' && ch <= '9') || ch == '+' || ch == '-'
                         || ch == '.' || ch == 'e' || ch == 'E')
-                    _token += ch;
+                    _token += ch.narrow();
                 else
                 {
                     log_debug("set double value \"" << _token << '"');
                     _deserializer->setValue(_token);
                     _deserializer->setTypeName("double");
                     _token.clear();
+                    _state = state_end;
                     return -1;
                 }
                 break;
 
             case state_token:
                 if (std::isalpha(ch.value()))
-                    _token += Char(std::tolower(ch));
+                    _token += static_cast<char>(std::tolower(ch.value()));
                 else
                 {
                     if (_token == "true" || _token == "false")
@@ -485,6 +547,7 @@ int JsonParser::advance(Char ch)
                         _token.clear();
                     }
 
+                    _state = state_end;
                     return -1;
                 }
 
@@ -536,6 +599,117 @@ int JsonParser::advance(Char ch)
     return 0;
 }
 
+namespace
+{
+    inline bool isDigit(char ch)
+    {
+        return ch >= '0' && ch <= '9';
+    }
+
+    inline bool isFloatChar(char ch)
+    {
+        return (ch >= '0' && ch <= '9') || ch == '+' || ch == '-'
+            || ch == '.' || ch == 'e' || ch == 'E';
+    }
+}
+
+bool JsonParser::advance(const char*& begin, const char* end)
+{
+    _byteMode = true;
+
+    try
+    {
+        while (begin != end)
+        {
+            switch (_state)
+            {
+                case state_object_value:
+                case state_array_value:
+                {
+                    // pass the input to the parser of the member value
+                    const char* b = begin;
+                    bool ret;
+                    try
+                    {
+                        ret = _next->advance(begin, end);
+                    }
+                    catch (const JsonParserError&)
+                    {
+                        _lineNo += std::count(b, begin, '\n');
+                        throw;
+                    }
+
+                    _lineNo += std::count(b, begin, '\n');
+
+                    if (!ret)
+                        return false;
+
+                    if (_state == state_object_value)
+                    {
+                        log_debug("leave object member");
+                        _deserializer->leaveMember();
+                        _state = state_object_e;
+                    }
+                    else
+                        _state = state_array_e;
+
+                    continue;
+                }
+
+                case state_object_name:
+                case state_string:
+                    if (_stringParser.plain())
+                    {
+                        const char* p = begin;
+                        while (p != end && *p != '"' && *p != '\\')
+                            ++p;
+
+                        _lineNo += std::count(begin, p, '\n');
+                        _stringParser.append(begin, p);
+                        begin = p;
+                        if (begin == end)
+                            return false;
+                    }
+                    break;
+
+                case state_number:
+                case state_float:
+                {
+                    const char* p = begin;
+                    if (_state == state_number)
+                        while (p != end && isDigit(*p))
+                            ++p;
+                    else
+                        while (p != end && isFloatChar(*p))
+                            ++p;
+
+                    _token.append(begin, p);
+                    begin = p;
+                    if (begin == end)
+                        return false;
+                    break;
+                }
+
+                default:
+                    break;
+            }
+
+            int ret = advance(Char(*begin));
+            if (ret != -1)
+                ++begin;
+            if (ret != 0)
+                return true;
+        }
+    }
+    catch (JsonParserError& e)
+    {
+        e._lineNo = _lineNo;
+        throw;
+    }
+
+    return false;
+}
+
 void JsonParser::finish()
 {
     if (_state == state_commentline)
@@ -32,6 +32,9 @@
 #include <cxxtools/convert.h>
 #include <cxxtools/mutex.h>
 #include <cxxtools/atomicity.h>
+#include <cxxtools/condition.h>
+#include <cxxtools/thread.h>
+#include <cxxtools/systemerror.h>
 #include <cxxtools/serializationinfo.h>
 #include <cxxtools/xml/xmldeserializer.h>
 #include <cxxtools/propertiesdeserializer.h>
@@ -43,6 +46,7 @@
 #include <cxxtools/datetime.h>
 
 #include "dateutils.h"
+#include "config.h"
 
 #include <iterator>
 #include <vector>
@@ -50,15 +54,21 @@
 #include <fstream>
 #include <sstream>
 #include <cctype>
+#include <cstring>
+#include <cerrno>
+#include <iostream>
 
 #include <unistd.h>
 #include <stdio.h>
 #include <string.h>
+#include <time.h>
 #include <fcntl.h>
 #include <sys/time.h>
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <sys/mman.h>
 #include <pthread.h>
+#include <stdint.h>
 
 log_define("cxxtools.log")
 
@@ -70,6 +80,7 @@ namespace cxxtools
     Mutex logMutex;
     Mutex poolMutex;
     atomic_t mutexWaitCount = 0;
+    atomic_t asyncProducers = 0;
 
     template <typename T, unsigned MaxPoolSize = 8>
     class LPool
@@ -149,61 +160,140 @@ namespace cxxtools
         }
     };
 
+#ifdef HAVE_CLOCK_GETTIME
+    // Clock used for the timestamps of log entries. A coarse clock is
+    // cheaper to read but has just the resolution of the kernel tick. It is
+    // set on configuration while other threads log.
+    atomic_t logClock = CLOCK_REALTIME;
+
+    inline clockid_t getLogClock()
+    {
+      return static_cast<clockid_t>(atomicGet(logClock));
+    }
+
+    void setLogClock(bool coarse)
+    {
+#ifdef CLOCK_REALTIME_COARSE
+      atomicSet(logClock, coarse ? CLOCK_REALTIME_COARSE : CLOCK_REALTIME);
+#endif
+    }
+#else
+    void setLogClock(bool)
+    { }
+#endif
+
+    // incremented in the child process after fork, so that the cached
+    // process id is renewed
+    atomic_t forkGeneration = 0;
+    pthread_once_t forkHandlerOnce = PTHREAD_ONCE_INIT;
+
+    void onFork()
+    {
+      atomicIncrement(forkGeneration);
+    }
+
+    void registerForkHandler()
+    {
+      pthread_atfork(0, 0, onFork);
+    }
+
+    // Per thread cache of the beginning of log entries. The date is
+    // formatted once per second and the process and thread id once per
+    // thread.
+    struct EntryPrefix
+    {
+      char date[20];
+      time_t sec;
+      bool dateValid;
+      char id[48];
+      unsigned idSize;
+      atomic_t generation;
+    };
+
+    thread_local EntryPrefix entryPrefix;
+
+    void formatDate(char* date, time_t sec)
+    {
+      struct tm tt;
+      localtime_r(&sec, &tt);
+      int year = 1900 + tt.tm_year;
+      int mon = tt.tm_mon + 1;
+      date[0] = static_cast<char>('0' + year / 1000 % 10);
+      date[1] = static_cast<char>('0' + year / 100 % 10);
+      date[2] = static_cast<char>('0' + year / 10 % 10);
+      date[3] = static_cast<char>('0' + year % 10);
+      date[4] = '-';
+      date[5] = static_cast<char>('0' + mon / 10);
+      date[6] = static_cast<char>('0' + mon % 10);
+      date[7] = '-';
+      date[8] = static_cast<char>('0' + tt.tm_mday / 10);
+      date[9] = static_cast<char>('0' + tt.tm_mday % 10);
+      date[10] = ' ';
+      date[11] = static_cast<char>('0' + tt.tm_hour / 10);
+      date[12] = static_cast<char>('0' + tt.tm_hour % 10);
+      date[13] = ':';
+      date[14] = static_cast<char>('0' + tt.tm_min / 10);
+      date[15] = static_cast<char>('0' + tt.tm_min % 10);
+      date[16] = ':';
+      date[17] = static_cast<char>('0' + tt.tm_sec / 10);
+      date[18] = static_cast<char>('0' + tt.tm_sec % 10);
+      date[19] = '.';
+    }
+
+    void formatId(EntryPrefix& prefix)
+    {
+      char* p = prefix.id;
+      *p++ = ' ';
+      *p++ = '[';
+      p = putInt(p, getpid());
+      *p++ = '.';
+      p = putInt(p, (unsigned long)pthread_self());
+      *p++ = ']';
+      *p++ = ' ';
+      prefix.idSize = p - prefix.id;
+    }
+
     void logentry(std::string& entry, const char* level, const std::string& category)
     {
-      struct timeval t;
-      gettimeofday(&t, 0);
+      EntryPrefix& prefix = entryPrefix;
+
+#ifdef HAVE_CLOCK_GETTIME
+      struct timespec ts;
+      clock_gettime(getLogClock(), &ts);
+      time_t sec = ts.tv_sec;
+      unsigned long usec = ts.tv_nsec / 1000;
+#else
+      struct timeval tv;
+      gettimeofday(&tv, 0);
+      time_t sec = tv.tv_sec;
+      unsigned long usec = tv.tv_usec;
+#endif
 
       // format date only once per second:
-      static char date[20];
-      static time_t psec = 0;
-      time_t sec = static_cast<time_t>(t.tv_sec);
-      if (sec != psec)
+      if (!prefix.dateValid || sec != prefix.sec)
       {
-        struct tm tt;
-        localtime_r(&sec, &tt);
-        int year = 1900 + tt.tm_year;
-        int mon = tt.tm_mon + 1;
-        date[0] = static_cast<char>('0' + year / 1000 % 10);
-        date[1] = static_cast<char>('0' + year / 100 % 10);
-        date[2] = static_cast<char>('0' + year / 10 % 10);
-        date[3] = static_cast<char>('0' + year % 10);
-        date[4] = '-';
-        date[5] = static_cast<char>('0' + mon / 10);
-        date[6] = static_cast<char>('0' + mon % 10);
-        date[7] = '-';
-        date[8] = static_cast<char>('0' + tt.tm_mday / 10);
-        date[9] = static_cast<char>('0' + tt.tm_mday % 10);
-        date[10] = ' ';
-        date[11] = static_cast<char>('0' + tt.tm_hour / 10);
-        date[12] = static_cast<char>('0' + tt.tm_hour % 10);
-        date[13] = ':';
-        date[14] = static_cast<char>('0' + tt.tm_min / 10);
-        date[15] = static_cast<char>('0' + tt.tm_min % 10);
-        date[16] = ':';
-        date[17] = static_cast<char>('0' + tt.tm_sec / 10);
-        date[18] = static_cast<char>('0' + tt.tm_sec % 10);
-        date[19] = '.';
-
-        psec = sec;
+        formatDate(prefix.date, sec);
+        prefix.sec = sec;
+        prefix.dateValid = true;
       }
 
-      entry.append(date, 20);
+      atomic_t generation = atomicGet(forkGeneration);
+      if (prefix.idSize == 0 || prefix.generation != generation)
+      {
+        pthread_once(&forkHandlerOnce, registerForkHandler);
+        formatId(prefix);
+        prefix.generation = generation;
+      }
 
-      entry += static_cast<char>('0' + t.tv_usec / 100000 % 10);
-      entry += static_cast<char>('0' + t.tv_usec / 10000 % 10);
-      entry += static_cast<char>('0' + t.tv_usec / 1000 % 10);
-      entry += static_cast<char>('0' + t.tv_usec / 100 % 10);
-      entry += static_cast<char>('0' + t.tv_usec / 10 % 10);
-      entry += ' ';
-      entry += '[';
-      char str[64];
-      char* p = putInt(str, getpid());
-      entry.append(str, p - str);
-      entry += '.';
-      p = putInt(str, (unsigned long)pthread_self());
-      entry.append(str, p - str);
-      entry += "] ";
+      char buffer[32];
+      std::memcpy(buffer, prefix.date, 20);
+      unsigned long t = usec / 10;
+      for (char* p = buffer + 24; p >= buffer + 20; --p, t /= 10)
+        *p = static_cast<char>('0' + t % 10);
+
+      entry.reserve(entry.size() + 25 + prefix.idSize + 8 + category.size() + 3);
+      entry.append(buffer, 25);
+      entry.append(prefix.id, prefix.idSize);
       entry += level;
       entry += ' ';
       entry += category;
@@ -216,6 +306,18 @@ namespace cxxtools
         virtual ~LogAppender() { }
         virtual void putMessage(const std::string& msg) = 0;
         virtual void finish(bool flush) = 0;
+
+        // Returns true, when putMessage and finish may be called without
+        // holding the log mutex.
+        virtual bool async() const  { return false; }
+
+        // Returns true, when the appender writes structured records. It
+        // gets the parts of the entry with putRecord instead of a
+        // formatted line with putMessage.
+        virtual bool structured() const  { return false; }
+        virtual void putRecord(const char* /*level*/, const std::string& /*category*/,
+                               const char* /*state*/, const std::string& /*msg*/)
+        { }
     };
 
     //////////////////////////////////////////////////////////////////////
@@ -550,6 +652,279 @@ namespace cxxtools
       _fsize += msg.size() + 1;  // FileAppender adds line feed to the message
     }
 
+    //////////////////////////////////////////////////////////////////////
+    // BinaryFileAppender - appends structured records to a memory mapped
+    // file without formatting the entries
+    //
+    // The file starts with the magic "CXXLOG1\n" followed by records in
+    // host byte order. Each record starts with a type byte:
+    //
+    //   'C'  category: uint32 id, uint16 size, name
+    //   'M'  message:  int64 seconds, uint32 microseconds, uint32 pid,
+    //                  uint64 thread id, uint32 category id,
+    //                  uint8 size, level, uint32 size, message
+    //
+    // A zero type byte or the end of the file terminates the log. The tool
+    // cxxtools-logformat renders the file as text or json.
+    //
+    class BinaryFileAppender : public LogAppender
+    {
+        typedef std::map<std::string, uint32_t> Categories;
+
+        std::string _fname;
+        int _fd;
+        char* _map;
+        off_t _mapOffset;   // file offset of the mapping
+        size_t _mapSize;
+        off_t _end;         // end of the records in the file
+        Categories _categories;
+
+        BinaryFileAppender(const BinaryFileAppender&);
+        BinaryFileAppender& operator=(const BinaryFileAppender&);
+
+        void openFile();
+        void readCategories();
+        char* reserve(size_t size);
+
+        template <typename T>
+        static char* put(char* p, T value)
+        {
+          std::memcpy(p, &value, sizeof(T));
+          return p + sizeof(T);
+        }
+
+      public:
+        explicit BinaryFileAppender(const std::string& fname);
+        ~BinaryFileAppender();
+
+        virtual void putMessage(const std::string& /*msg*/)
+        { }
+
+        virtual void finish(bool /*flush*/)
+        { }
+
+        virtual bool structured() const  { return true; }
+        virtual void putRecord(const char* level, const std::string& category,
+                               const char* state, const std::string& msg);
+    };
+
+    BinaryFileAppender::BinaryFileAppender(const std::string& fname)
+      : _fname(fname),
+        _fd(-1),
+        _map(0),
+        _mapOffset(0),
+        _mapSize(0),
+        _end(0)
+    {
+    }
+
+    BinaryFileAppender::~BinaryFileAppender()
+    {
+      if (_map)
+        ::munmap(_map, _mapSize);
+
+      if (_fd >= 0)
+      {
+        // remove the unused part of the last mapping
+        if (::ftruncate(_fd, _end) != 0)
+          std::cerr << "failed to truncate binary log file \"" << _fname
+                    << "\": " << std::strerror(errno) << std::endl;
+        ::close(_fd);
+      }
+    }
+
+    void BinaryFileAppender::openFile()
+    {
+#ifdef O_CLOEXEC
+      _fd = ::open(_fname.c_str(), O_RDWR | O_CLOEXEC | O_CREAT, 0666);
+#else
+      _fd = ::open(_fname.c_str(), O_RDWR | O_CREAT, 0666);
+      if (_fd >= 0)
+        ::fcntl(_fd, F_SETFD, ::fcntl(_fd, F_GETFD) | FD_CLOEXEC);
+#endif
+      if (_fd < 0)
+        throwSystemError("open");
+
+      readCategories();
+
+      if (_end == 0)
+      {
+        char* p;
+        try
+        {
+          p = reserve(8);
+        }
+        catch (...)
+        {
+          // try again with the next record
+          ::close(_fd);
+          _fd = -1;
+          throw;
+        }
+
+        std::memcpy(p, "CXXLOG1\n", 8);
+        _end = 8;
+      }
+    }
+
+    // Reads the categories of an existing file and finds its end.
+    void BinaryFileAppender::readCategories()
+    {
+      std::ifstream in(_fname.c_str(), std::ios::binary);
+      char magic[8];
+      if (!in.read(magic, 8))
+      {
+        if (in.gcount() > 0)
+          throw std::runtime_error("file \"" + _fname + "\" is not a binary log file");
+        return;
+      }
+
+      if (std::memcmp(magic, "CXXLOG1\n", 8) != 0)
+        throw std::runtime_error("file \"" + _fname + "\" is not a binary log file");
+
+      off_t end = 8;
+      while (true)
+      {
+        char type;
+        if (!in.get(type) || type == '\0')
+          break;
+
+        if (type == 'C')
+        {
+          uint32_t id;
+          uint16_t size;
+          if (!in.read(reinterpret_cast<char*>(&id), 4) || !in.read(reinterpret_cast<char*>(&size), 2))
+            break;
+          std::string name(size, '\0');
+          if (size > 0 && !in.read(&name[0], size))
+            break;
+          _categories[name] = id;
+          end += 1 + 4 + 2 + size;
+        }
+        else if (type == 'M')
+        {
+          char head[8 + 4 + 4 + 8 + 4];
+          uint8_t levelSize;
+          uint32_t size;
+          if (!in.read(head, sizeof(head)) || !in.read(reinterpret_cast<char*>(&levelSize), 1))
+            break;
+          in.ignore(levelSize);
+          if (!in.read(reinterpret_cast<char*>(&size), 4) || !in.ignore(size) || in.gcount() != size)
+            break;
+          end += 1 + sizeof(head) + 1 + levelSize + 4 + size;
+        }
+        else
+          break;
+      }
+
+      _end = end;
+    }
+
+    // Returns a pointer to size bytes at the end of the records. Throws
+    // when the file can't grow, so that the caller drops the record.
+    char* BinaryFileAppender::reserve(size_t size)
+    {
+      if (_map == 0 || _end + static_cast<off_t>(size) > _mapOffset + static_cast<off_t>(_mapSize))
+      {
+        static const size_t chunkSize = 1024 * 1024;
+        off_t pageSize = ::sysconf(_SC_PAGESIZE);
+
+        off_t offset = _end - _end % pageSize;
+        size_t mapSize = std::max(chunkSize, static_cast<size_t>(_end - offset) + size);
+        mapSize += pageSize - mapSize % pageSize;
+
+        // Writing to a page of a shared mapping, which has no disk space,
+        // raises SIGBUS, so the blocks are allocated before they are mapped.
+        // ftruncate just leaves a hole in the file and is used only when the
+        // file system can't allocate.
+#if defined(_POSIX_ADVISORY_INFO) && _POSIX_ADVISORY_INFO >= 0
+        int ret = ::posix_fallocate(_fd, offset, mapSize);
+        if (ret == EINVAL || ret == EOPNOTSUPP || ret == ENOSYS)
+        {
+          if (::ftruncate(_fd, offset + mapSize) != 0)
+            throwSystemError("ftruncate");
+        }
+        else if (ret != 0)
+          throwSystemError(ret, "posix_fallocate");
+#else
+        if (::ftruncate(_fd, offset + mapSize) != 0)
+          throwSystemError("ftruncate");
+#endif
+
+        if (_map)
+        {
+          ::munmap(_map, _mapSize);
+          _map = 0;
+        }
+
+        void* m = ::mmap(0, mapSize, PROT_READ | PROT_WRITE, MAP_SHARED, _fd, offset);
+        if (m == MAP_FAILED)
+          throwSystemError("mmap");
+
+        _map = static_cast<char*>(m);
+        _mapOffset = offset;
+        _mapSize = mapSize;
+      }
+
+      return _map + (_end - _mapOffset);
+    }
+
+    void BinaryFileAppender::putRecord(const char* level, const std::string& category,
+                                       const char* state, const std::string& msg)
+    {
+      if (_fd < 0)
+        openFile();
+
+      Categories::const_iterator it = _categories.find(category);
+      uint32_t categoryId;
+      if (it == _categories.end())
+      {
+        categoryId = _categories.size();
+        uint16_t size = std::min(category.size(), size_t(0xffff));
+        char* p = reserve(1 + 4 + 2 + size);
+        *p++ = 'C';
+        p = put(p, categoryId);
+        p = put(p, size);
+        std::memcpy(p, category.data(), size);
+        _end += 1 + 4 + 2 + size;
+        _categories.insert(Categories::value_type(category, categoryId));
+      }
+      else
+        categoryId = it->second;
+
+#ifdef HAVE_CLOCK_GETTIME
+      struct timespec ts;
+      clock_gettime(getLogClock(), &ts);
+      int64_t sec = ts.tv_sec;
+      uint32_t usec = ts.tv_nsec / 1000;
+#else
+      struct timeval tv;
+      gettimeofday(&tv, 0);
+      int64_t sec = tv.tv_sec;
+      uint32_t usec = tv.tv_usec;
+#endif
+
+      uint8_t levelSize = std::min(std::strlen(level), size_t(0xff));
+      std::size_t stateSize = std::strlen(state);
+      uint32_t size = stateSize + msg.size();
+
+      std::size_t recordSize = 1 + 8 + 4 + 4 + 8 + 4 + 1 + levelSize + 4 + size;
+      char* p = reserve(recordSize);
+      *p++ = 'M';
+      p = put(p, sec);
+      p = put(p, usec);
+      p = put(p, static_cast<uint32_t>(getpid()));
+      p = put(p, static_cast<uint64_t>(pthread_self()));
+      p = put(p, categoryId);
+      p = put(p, levelSize);
+      std::memcpy(p, level, levelSize);
+      p += levelSize;
+      p = put(p, size);
+      std::memcpy(p, state, stateSize);
+      std::memcpy(p + stateSize, msg.data(), msg.size());
+      _end += recordSize;
+    }
+
     //////////////////////////////////////////////////////////////////////
     // UdpAppender
     //
@@ -584,6 +959,243 @@ namespace cxxtools
       _msg.clear();
     }
 
+    //////////////////////////////////////////////////////////////////////
+    // AsyncAppender - passes messages through a bounded lock free queue
+    // to a writer thread, which writes them to the actual appender
+    //
+    class AsyncAppender : public LogAppender
+    {
+        struct Entry
+        {
+          volatile atomic_t seq;
+          std::string msg;
+        };
+
+        SmartPtr<LogAppender> _appender;
+        Entry* _queue;
+        atomic_t _mask;
+        bool _block;
+
+        volatile atomic_t _head;      // next entry to fill by producers
+        atomic_t _tail;               // next entry to write; used by the writer only
+        volatile atomic_t _flushed;   // all entries before are written and flushed
+        volatile atomic_t _sleeping;  // the writer waits for messages
+        volatile atomic_t _waiting;   // producers wait for free entries
+        volatile atomic_t _flushWaiting;  // producers wait for a flush
+        volatile atomic_t _dropped;
+        bool _stop;
+
+        Mutex _mutex;
+        Condition _notEmpty;
+        Condition _progress;
+        AttachedThread _thread;
+
+        AsyncAppender(const AsyncAppender&);
+        AsyncAppender& operator=(const AsyncAppender&);
+
+        bool available() const
+        { return atomicGet(_queue[_tail & _mask].seq) == _tail + 1; }
+
+        void wakeWriter();
+        void notifyProgress();
+        void run();
+
+      public:
+        AsyncAppender(LogAppender* appender, unsigned queueSize, bool block);
+        ~AsyncAppender();
+
+        virtual void putMessage(const std::string& msg);
+        virtual void finish(bool flush);
+        virtual bool async() const  { return true; }
+    };
+
+    AsyncAppender::AsyncAppender(LogAppender* appender, unsigned queueSize, bool block)
+      : _appender(appender),
+        _queue(0),
+        _mask(0),
+        _block(block),
+        _head(0),
+        _tail(0),
+        _flushed(0),
+        _sleeping(0),
+        _waiting(0),
+        _flushWaiting(0),
+        _dropped(0),
+        _stop(false),
+        _thread(callable(*this, &AsyncAppender::run))
+    {
+      atomic_t size = 2;
+      while (size < static_cast<atomic_t>(queueSize))
+        size <<= 1;
+
+      _queue = new Entry[size];
+      _mask = size - 1;
+      for (atomic_t n = 0; n < size; ++n)
+        _queue[n].seq = n;
+
+      _thread.start();
+    }
+
+    AsyncAppender::~AsyncAppender()
+    {
+      {
+        MutexLock lock(_mutex);
+        _stop = true;
+        _notEmpty.signal();
+      }
+
+      _thread.join();
+      delete[] _queue;
+    }
+
+    void AsyncAppender::putMessage(const std::string& msg)
+    {
+      atomic_t pos = atomicGet(_head);
+      Entry* entry;
+
+      while (true)
+      {
+        entry = &_queue[pos & _mask];
+        atomic_t dif = atomicGet(entry->seq) - pos;
+        if (dif == 0)
+        {
+          if (atomicCompareExchange(_head, pos + 1, pos) == pos)
+            break;
+          pos = atomicGet(_head);
+        }
+        else if (dif > 0)
+        {
+          // another producer took the entry
+          pos = atomicGet(_head);
+        }
+        else if (!_block)
+        {
+          atomicIncrement(_dropped);
+          return;
+        }
+        else
+        {
+          // the queue is full; wait for the writer
+          atomicIncrement(_waiting);
+          wakeWriter();
+          {
+            MutexLock lock(_mutex);
+            if (atomicGet(entry->seq) - pos < 0)
+              _progress.wait(lock);
+          }
+          atomicDecrement(_waiting);
+          pos = atomicGet(_head);
+        }
+      }
+
+      entry->msg.assign(msg);
+      atomicSet(entry->seq, pos + 1);
+
+      if (atomicGet(_sleeping))
+        wakeWriter();
+    }
+
+    void AsyncAppender::finish(bool flush)
+    {
+      if (!flush)
+        return;
+
+      // wait until all messages passed so far are written
+      atomic_t head = atomicGet(_head);
+      atomicIncrement(_flushWaiting);
+      wakeWriter();
+
+      {
+        MutexLock lock(_mutex);
+        while (atomicGet(_flushed) - head < 0 && !_stop)
+          _progress.wait(lock);
+      }
+
+      atomicDecrement(_flushWaiting);
+    }
+
+    void AsyncAppender::wakeWriter()
+    {
+      MutexLock lock(_mutex);
+      _notEmpty.signal();
+    }
+
+    void AsyncAppender::notifyProgress()
+    {
+      if (atomicGet(_waiting) || atomicGet(_flushWaiting))
+      {
+        MutexLock lock(_mutex);
+        _progress.broadcast();
+      }
+    }
+
+    void AsyncAppender::run()
+    {
+      while (true)
+      {
+        while (available())
+        {
+          Entry& entry = _queue[_tail & _mask];
+
+          try
+          {
+            _appender->putMessage(entry.msg);
+          }
+          catch (const std::exception&)
+          {
+          }
+
+          atomicSet(entry.seq, _tail + _mask + 1);
+          ++_tail;
+
+          // flush when the queue is empty or someone waits for a flush
+          bool flush = !available() || atomicGet(_flushWaiting) != 0;
+          try
+          {
+            _appender->finish(flush);
+          }
+          catch (const std::exception&)
+          {
+          }
+
+          if (flush)
+            atomicSet(_flushed, _tail);
+
+          notifyProgress();
+        }
+
+        atomic_t dropped = atomicExchange(_dropped, 0);
+        if (dropped > 0)
+        {
+          try
+          {
+            std::string msg;
+            logentry(msg, "WARN", "cxxtools.log");
+            msg += convert<std::string>(dropped);
+            msg += " log messages dropped";
+            _appender->putMessage(msg);
+            _appender->finish(true);
+          }
+          catch (const std::exception&)
+          {
+          }
+        }
+
+        atomicSet(_flushed, _tail);
+        notifyProgress();
+
+        MutexLock lock(_mutex);
+        atomicSet(_sleeping, 1);
+        if (!available())
+        {
+          if (_stop)
+            break;
+          _notEmpty.wait(lock);
+        }
+        atomicSet(_sleeping, 0);
+      }
+    }
+
     //////////////////////////////////////////////////////////////////////
     int throwInvalidLogLevel(const std::string& level, const std::string& category)
     {
@@ -780,6 +1392,10 @@ namespace cxxtools
       unsigned short _logport;
       bool _broadcast;
       bool _tostdout;  // flag for console output: true=stdout, false=stderr
+      bool _binary;
+      unsigned _asyncQueueSize;  // 0 = write synchronously
+      bool _asyncBlock;
+      bool _coarseClock;
 
       int _rootFlags;
       LogFlags _logFlags;
@@ -793,6 +1409,10 @@ namespace cxxtools
           _logport(0),
           _broadcast(true),
           _tostdout(false),
+          _binary(false),
+          _asyncQueueSize(0),
+          _asyncBlock(false),
+          _coarseClock(false),
           _rootFlags(rootFlags)
       { }
 
@@ -803,6 +1423,10 @@ namespace cxxtools
       unsigned short logport() const            { return _logport; }
       bool broadcast() const                    { return _broadcast; }
       bool tostdout() const                     { return _tostdout; }
+      bool binary() const                       { return _binary; }
+      unsigned asyncQueueSize() const           { return _asyncQueueSize; }
+      bool asyncBlock() const                   { return _asyncBlock; }
+      bool coarseClock() const                  { return _coarseClock; }
 
       int rootFlags() const                     { return _rootFlags; }
       int logFlags(const std::string& category) const;
@@ -828,6 +1452,7 @@ namespace cxxtools
         _fname = fname;
         _maxfilesize = 0;
         _maxbackupindex = 0;
+        _binary = false;
       }
 
       void setFile(const std::string& fname, unsigned maxfilesize, unsigned maxbackupindex)
@@ -835,6 +1460,13 @@ namespace cxxtools
         _fname = fname;
         _maxfilesize = maxfilesize;
         _maxbackupindex = maxbackupindex;
+        _binary = false;
+      }
+
+      void setBinaryFile(const std::string& fname)
+      {
+        setFile(fname);
+        _binary = true;
       }
 
       void setLoghost(const std::string& host, unsigned short port, bool broadcast)
@@ -859,6 +1491,17 @@ namespace cxxtools
         _tostdout = false;
       }
 
+      void setAsync(unsigned queueSize, bool block)
+      {
+        _asyncQueueSize = queueSize;
+        _asyncBlock = block;
+      }
+
+      void setCoarseClock(bool sw)
+      {
+        _coarseClock = sw;
+      }
+
   };
 
   int LogConfiguration::Impl::logFlags(const std::string& category) const
@@ -922,6 +1565,9 @@ namespace cxxtools
 
         si.getMember("maxbackupindex", impl._maxbackupindex);
       }
+
+      if (!si.getMember("binary", impl._binary))
+        impl._binary = false;
     }
     else if (si.getMember("logport", impl._logport))
     {
@@ -934,6 +1580,19 @@ namespace cxxtools
         impl._tostdout = false;
     }
 
+    bool async = false;
+    if (si.getMember("async", async) && async)
+    {
+      impl._asyncQueueSize = 8192;
+      si.getMember("queuesize", impl._asyncQueueSize);
+      si.getMember("block", impl._asyncBlock);
+    }
+    else
+      impl._asyncQueueSize = 0;
+
+    if (!si.getMember("coarseclock", impl._coarseClock))
+      impl._coarseClock = false;
+
     std::string rootFlags;
     if (!si.getMember("rootlogger", rootFlags))
       impl._rootFlags = Logger::LOG_LEVEL_FATAL;
@@ -1004,6 +1663,8 @@ namespace cxxtools
         si.addMember("maxfilesize") <<= impl._maxfilesize;
         si.addMember("maxbackupindex") <<= impl._maxbackupindex;
       }
+      if (impl._binary)
+        si.addMember("binary") <<= true;
     }
 
     if (impl._logport != 0)
@@ -1017,6 +1678,17 @@ namespace cxxtools
     if (impl._tostdout)
       si.addMember("tostdout") <<= true;
 
+    if (impl._asyncQueueSize != 0)
+    {
+      si.addMember("async") <<= true;
+      si.addMember("queuesize") <<= impl._asyncQueueSize;
+      if (impl._asyncBlock)
+        si.addMember("block") <<= true;
+    }
+
+    if (impl._coarseClock)
+      si.addMember("coarseclock") <<= true;
+
   }
 
   //////////////////////////////////////////////////////////////////////
@@ -1092,6 +1764,11 @@ namespace cxxtools
     _impl->setFile(fname, maxfilesize, maxbackupindex);
   }
 
+  void LogConfiguration::setBinaryFile(const std::string& fname)
+  {
+    _impl->setBinaryFile(fname);
+  }
+
   void LogConfiguration::setLoghost(const std::string& host, unsigned short port, bool broadcast)
   {
     _impl->setLoghost(host, port, broadcast);
@@ -1107,6 +1784,21 @@ namespace cxxtools
     _impl->setStderr();
   }
 
+  void LogConfiguration::setAsync(unsigned queueSize, bool block)
+  {
+    _impl->setAsync(queueSize, block);
+  }
+
+  void LogConfiguration::setSync()
+  {
+    _impl->setAsync(0, false);
+  }
+
+  void LogConfiguration::setCoarseClock(bool sw)
+  {
+    _impl->setCoarseClock(sw);
+  }
+
   void operator>>= (const SerializationInfo& si, LogConfiguration& logConfiguration)
   {
     si >>= *logConfiguration.impl();
@@ -1120,17 +1812,72 @@ namespace cxxtools
   //////////////////////////////////////////////////////////////////////
   // LogManager::Impl
   //
+  namespace
+  {
+    LogAppender* createAppender(const LogConfiguration::Impl& config)
+    {
+      LogAppender* appender;
+
+      if (config.fname().empty())
+      {
+        if (config.logport() != 0)
+          appender = new UdpAppender(config.loghost(), config.logport(), config.broadcast());
+        else
+          appender = new FdAppender(config.tostdout() ? STDOUT_FILENO : STDERR_FILENO);
+      }
+      else if (config.binary())
+      {
+        // the records are just copied to memory, so there is nothing to
+        // gain from a writer thread
+        return new BinaryFileAppender(config.fname());
+      }
+      else if (config.maxfilesize() == 0)
+      {
+        appender = new FileAppender(config.fname());
+      }
+      else
+      {
+        appender = new RollingFileAppender(config.fname(), config.maxfilesize(), config.maxbackupindex());
+      }
+
+      if (config.asyncQueueSize() != 0)
+        appender = new AsyncAppender(appender, config.asyncQueueSize(), config.asyncBlock());
+
+      return appender;
+    }
+  }
+
 
+  // The loggers are kept in a hash table with a fixed number of buckets.
+  // New loggers are prepended to the list of their bucket under the loggers
+  // mutex and are never removed while the log manager exists. So a lookup of
+  // an existing category just reads the lists and does not need any lock.
   class LogManager::Impl
   {
+      struct LoggerNode
+      {
+        Logger logger;
+        LoggerNode* next;
+
+        LoggerNode(const std::string& category, int flags, LoggerNode* next_)
+          : logger(category, flags),
+            next(next_)
+        { }
+      };
+
+      enum { BucketCount = 256 };
+
       SmartPtr<LogAppender> _appender;
       LogConfiguration _config;
-      typedef std::map<std::string, Logger*> Loggers;  // map category => logger
-      Loggers _loggers;
+      void* volatile _buckets[BucketCount];  // LoggerNode*
 
       Impl(const Impl&);
       Impl& operator=(const Impl&);
 
+      static unsigned bucket(const std::string& category);
+      LoggerNode* head(unsigned b)
+      { return static_cast<LoggerNode*>(atomicGet(_buckets[b])); }
+
     public:
       explicit Impl(const LogConfiguration& config);
       ~Impl();
@@ -1152,26 +1899,11 @@ namespace cxxtools
 
   LogManager::Impl::Impl(const LogConfiguration& config)
   {
-    if (config.impl()->fname().empty())
-    {
-      if (config.impl()->logport() != 0)
-      {
-        _appender = new UdpAppender(config.impl()->loghost(), config.impl()->logport(), config.impl()->broadcast());
-      }
-      else
-      {
-        _appender = new FdAppender(config.impl()->tostdout() ? STDOUT_FILENO : STDERR_FILENO);
-      }
-    }
-    else if (config.impl()->maxfilesize() == 0)
-    {
-      _appender = new FileAppender(config.impl()->fname());
-    }
-    else
-    {
-      _appender = new RollingFileAppender(config.impl()->fname(), config.impl()->maxfilesize(), config.impl()->maxbackupindex());
-    }
+    for (unsigned b = 0; b < BucketCount; ++b)
+      _buckets[b] = 0;
 
+    _appender = createAppender(*config.impl());
+    setLogClock(config.impl()->coarseClock());
     _config = config;
   }
 
@@ -1180,36 +1912,106 @@ namespace cxxtools
     if (config.rootFlags() == 0)
       return;
 
-    if (config.impl()->fname().empty())
+    _appender = createAppender(*config.impl());
+    setLogClock(config.impl()->coarseClock());
+
+    // getLogger reads the configuration, when a new logger is created
+    MutexLock lock(loggersMutex);
+
+    _config = config;
+
+    for (unsigned b = 0; b < BucketCount; ++b)
+      for (LoggerNode* node = head(b); node; node = node->next)
+        node->logger.setLogFlags(logFlags(node->logger.getCategory()));
+  }
+
+  LogManager::Impl::~Impl()
+  {
+    for (unsigned b = 0; b < BucketCount; ++b)
     {
-      if (config.impl()->logport() != 0)
+      LoggerNode* node = head(b);
+      while (node)
       {
-        _appender = new UdpAppender(config.impl()->loghost(), config.impl()->logport(), config.impl()->broadcast());
-      }
-      else
-      {
-        _appender = new FdAppender(config.impl()->tostdout() ? STDOUT_FILENO : STDERR_FILENO);
+        LoggerNode* next = node->next;
+        delete node;
+        node = next;
       }
     }
-    else if (config.impl()->maxfilesize() == 0)
+  }
+
+  unsigned LogManager::Impl::bucket(const std::string& category)
+  {
+    // FNV-1a
+    uint32_t h = 2166136261u;
+    for (std::string::const_iterator it = category.begin(); it != category.end(); ++it)
     {
-      _appender = new FileAppender(config.impl()->fname());
+      h ^= static_cast<unsigned char>(*it);
+      h *= 16777619u;
     }
-    else
+    return h % BucketCount;
+  }
+
+  namespace
+  {
+    // Waits until all threads, which pass messages to an asynchronous
+    // appender without holding the log mutex, are done. The log manager
+    // must be disabled, so that no new messages arrive.
+    void waitAsyncProducers()
     {
-      _appender = new RollingFileAppender(config.impl()->fname(), config.impl()->maxfilesize(), config.impl()->maxbackupindex());
+      while (atomicGet(asyncProducers) != 0)
+        Thread::yield();
     }
 
-    _config = config;
+    void putLogEntry(std::string& entry, const char* level, const std::string& category,
+                     const char* state, const std::string& msg)
+    {
+      if (!LogManager::isEnabled())
+        return;
 
-    for (Loggers::iterator it = _loggers.begin(); it != _loggers.end(); ++it)
-      it->second->setLogFlags(logFlags(it->second->getCategory()));
-  }
+      {
+        ScopedAtomicIncrementer producer(asyncProducers);
 
-  LogManager::Impl::~Impl()
-  {
-    for (Loggers::iterator it = _loggers.begin(); it != _loggers.end(); ++it)
-      delete it->second;
+        // check again after announcing ourself, since the appender is
+        // replaced, when the manager is disabled and no producer is active
+        if (!LogManager::isEnabled())
+          return;
+
+        LogAppender& appender = LogManager::getInstance().impl()->appender();
+        if (appender.async())
+        {
+          entry.clear();
+          logentry(entry, level, category);
+          entry += state;
+          entry += msg;
+
+          appender.putMessage(entry);
+
+          // fatal messages are written before the program may terminate
+          if (strcmp(level, "FATAL") == 0)
+            appender.finish(true);
+
+          return;
+        }
+      }
+
+      ScopedAtomicIncrementer inc(mutexWaitCount);
+      MutexLock lock(logMutex);
+
+      LogAppender& appender = LogManager::getInstance().impl()->appender();
+      if (appender.structured())
+      {
+        appender.putRecord(level, category, state, msg);
+        return;
+      }
+
+      entry.clear();
+      logentry(entry, level, category);
+      entry += state;
+      entry += msg;
+
+      appender.putMessage(entry);
+      appender.finish(inc.decrement() == 0);
+    }
   }
 
   //////////////////////////////////////////////////////////////////////
@@ -1226,8 +2028,9 @@ namespace cxxtools
   LogManager::~LogManager()
   {
     MutexLock lock(logMutex);
-    delete _impl;
     _enabled = false;
+    waitAsyncProducers();
+    delete _impl;
   }
 
   LogManager& LogManager::getInstance()
@@ -1312,6 +2115,7 @@ namespace cxxtools
     MutexLock lock(logMutex);
 
     _enabled = false;
+    waitAsyncProducers();
 
     if (_impl == 0)
       _impl = new Impl(config);
@@ -1345,17 +2149,26 @@ namespace cxxtools
 
   Logger* LogManager::Impl::getLogger(const std::string& category)
   {
+    unsigned b = bucket(category);
+
+    // check for existing loggers; the nodes are complete, before they are
+    // published in the bucket
+    for (LoggerNode* node = head(b); node; node = node->next)
+      if (node->logger.getCategory() == category)
+        return &node->logger;
+
     MutexLock lock(loggersMutex);
 
-    // check for existing loggers
-    Loggers::iterator it = _loggers.find(category);
-    if (it != _loggers.end())
-      return it->second;
+    // check again, since another thread may have added it meanwhile
+    LoggerNode* first = head(b);
+    for (LoggerNode* node = first; node; node = node->next)
+      if (node->logger.getCategory() == category)
+        return &node->logger;
 
-    Logger* ret = new Logger(category, logFlags(category));
-    _loggers[category] = ret;
+    LoggerNode* node = new LoggerNode(category, logFlags(category), first);
+    atomicExchange(_buckets[b], node);
 
-    return ret;
+    return &node->logger;
   }
 
   //////////////////////////////////////////////////////////////////////
@@ -1435,19 +2248,7 @@ namespace cxxtools
   {
     try
     {
-      if (!LogManager::isEnabled())
-        return;
-
-      ScopedAtomicIncrementer inc(mutexWaitCount);
-      MutexLock lock(logMutex);
-
-      logentry(_buffer, _level, _logger->getCategory());
-      _buffer += _msg.str();
-
-      LogAppender& appender = LogManager::getInstance().impl()->appender();
-      appender.putMessage(_buffer);
-      appender.finish(inc.decrement() == 0);
-      _buffer.clear();
+      putLogEntry(_buffer, _level, _logger->getCategory(), "", _msg.str());
     }
     catch (const std::exception&)
     {
@@ -1540,20 +2341,8 @@ namespace cxxtools
   {
     try
     {
-      if (!LogManager::isEnabled())
-        return;
-
-      ScopedAtomicIncrementer inc(mutexWaitCount);
-      MutexLock lock(logMutex);
-
       std::string msg;
-      logentry(msg, "TRACE", _logger->getCategory());
-      msg += state;
-      msg += _msg.str();
-
-      LogAppender& appender = LogManager::getInstance().impl()->appender();
-      appender.putMessage(msg);
-      appender.finish(inc.decrement() == 0);
+      putLogEntry(msg, "TRACE", _logger->getCategory(), state, _msg.str());
     }
     catch (const std::exception&)
     {
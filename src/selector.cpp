@@ -39,7 +39,7 @@ SelectorBase::~SelectorBase()
 {
     while( _timers.size() )
     {
-       Timer* timer = _timers.begin()->second;
+       Timer* timer = _timers.back().timer;
        timer->setSelector(0);
     }
 }
@@ -74,40 +74,112 @@ void SelectorBase::remove( Timer& timer )
 void SelectorBase::onAddTimer(Timer& timer)
 {
     if( timer.active() )
-    {
-        TimerMap::value_type elem(timer.finished(), &timer);
-        _timers.insert(elem);
-        //_timers.insert( std::make_pair(timer.finished(), &timer) );
-    }
+        timerHeapPut(timer);
 }
 
 
 void SelectorBase::onRemoveTimer( Timer& timer )
 {
-    std::multimap<Timespan, Timer*>::iterator it;
-    for(it = _timers.begin(); it != _timers.end(); ++it)
-    {
-        if(it->second == &timer)
-        {
-            _timers.erase(it);
-            return;
-        }
-    }
+    timerHeapErase(timer);
 }
 
 
 void SelectorBase::onTimerChanged(Timer& timer)
 {
     if( timer.active() )
+        timerHeapPut(timer);
+    else
+        timerHeapErase(timer);
+}
+
+
+void SelectorBase::timerHeapPut(Timer& timer)
+{
+    TimerEntry entry;
+    entry.finished = timer.finished();
+    entry.serial = _timerSerial++;
+    entry.timer = &timer;
+
+    if (timer._heapIndex == Timer::NoHeapIndex)
     {
-        TimerMap::value_type elem(timer.finished(), &timer);
-        _timers.insert(elem);
-        //_timers.insert( std::make_pair(timer.finished(), &timer) );
+        timer._heapIndex = _timers.size();
+        _timers.push_back(entry);
+        timerHeapUp(timer._heapIndex);
     }
     else
     {
-        SelectorBase::onRemoveTimer(timer);
+        _timers[timer._heapIndex] = entry;
+        timerHeapUp(timer._heapIndex);
+        timerHeapDown(timer._heapIndex);
+    }
+}
+
+
+void SelectorBase::timerHeapErase(Timer& timer)
+{
+    std::size_t n = timer._heapIndex;
+    if (n == Timer::NoHeapIndex)
+        return;
+
+    timer._heapIndex = Timer::NoHeapIndex;
+
+    if (n + 1 == _timers.size())
+    {
+        _timers.pop_back();
+        return;
+    }
+
+    Timer* moved = _timers.back().timer;
+    _timers[n] = _timers.back();
+    _timers.pop_back();
+
+    timerHeapUp(n);
+    timerHeapDown(moved->_heapIndex);
+}
+
+
+void SelectorBase::timerHeapUp(std::size_t n)
+{
+    TimerEntry entry = _timers[n];
+    while (n > 0)
+    {
+        std::size_t parent = (n - 1) / 2;
+        if (!(entry < _timers[parent]))
+            break;
+
+        _timers[n] = _timers[parent];
+        _timers[n].timer->_heapIndex = n;
+        n = parent;
     }
+
+    _timers[n] = entry;
+    entry.timer->_heapIndex = n;
+}
+
+
+void SelectorBase::timerHeapDown(std::size_t n)
+{
+    TimerEntry entry = _timers[n];
+    std::size_t size = _timers.size();
+    while (true)
+    {
+        std::size_t child = 2 * n + 1;
+        if (child >= size)
+            break;
+
+        if (child + 1 < size && _timers[child + 1] < _timers[child])
+            ++child;
+
+        if (!(_timers[child] < entry))
+            break;
+
+        _timers[n] = _timers[child];
+        _timers[n].timer->_heapIndex = n;
+        n = child;
+    }
+
+    _timers[n] = entry;
+    entry.timer->_heapIndex = n;
 }
 
 
@@ -117,30 +189,30 @@ bool SelectorBase::updateTimer(Timespan& lowestTimeout)
         return false;
 
     Timespan now = Timespan::gettimeofday();
-    Timer* timer = _timers.begin()->second;
-    bool timerActive = now >= timer->finished();
+    bool timerActive = now >= _timers.front().finished;
 
     while( ! _timers.empty() )
     {
-        timer = _timers.begin()->second;
+        const TimerEntry& entry = _timers.front();
+        Timer& timer = *entry.timer;
 
-        if ( now < timer->finished() )
+        // When a slot throws, the timer has already advanced but did not
+        // reposition itself, so the entry is out of date.
+        if ( ! timer.active() || timer.finished() != entry.finished )
         {
-            lowestTimeout = timer->finished();
-            log_debug("lowestTimeout => " << lowestTimeout);
-            break;
+            onTimerChanged(timer);
+            continue;
         }
 
-        timer->update(now);
-
-        if( ! _timers.empty() )
+        if ( now < entry.finished )
         {
-            timer = _timers.begin()->second;
-            _timers.erase( _timers.begin() );
-            TimerMap::value_type elem(timer->finished(), timer);
-            _timers.insert(elem);
-            //_timers.insert( std::make_pair(timer->finished(), timer) );
+            lowestTimeout = entry.finished;
+            log_debug("lowestTimeout => " << lowestTimeout);
+            break;
         }
+
+        // the timer repositions itself in the heap or is removed from it
+        timer.update(now);
     }
 
     return timerActive;
@@ -218,6 +290,7 @@ void SelectorBase::wake()
 
 
 SelectorBase::SelectorBase()
+: _timerSerial(0)
 {}
 
 
@@ -252,8 +325,9 @@ void Selector::onChanged(Selectable& s)
 }
 
 
-void Selector::onReinit(Selectable& /*s*/)
+void Selector::onReinit(Selectable& s)
 {
+    _impl->reinit(s);
 }
 
 
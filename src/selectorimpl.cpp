@@ -33,6 +33,8 @@
 #include "cxxtools/selector.h"
 #include "cxxtools/log.h"
 #include <cerrno>
+#include <cstdlib>
+#include <cstring>
 #include <unistd.h>
 #include <fcntl.h>
 #include <cassert>
@@ -41,18 +43,75 @@
 #include "config.h"
 #include "poll.h"
 
+#ifdef HAVE_EVENTFD
+#include <sys/eventfd.h>
+#endif
+
 log_define("cxxtools.selector.impl")
 
 namespace cxxtools
 {
 
+#ifdef WITH_EPOLL
+namespace
+{
+    // The epoll backend is used by default. Setting the environment
+    // variable CXXTOOLS_SELECTOR to "poll" selects the poll backend.
+    bool useEpoll()
+    {
+        const char* selector = ::getenv("CXXTOOLS_SELECTOR");
+        return selector == 0 || std::strcmp(selector, "poll") != 0;
+    }
+
+    uint32_t toEpollEvents(short events)
+    {
+        uint32_t ret = 0;
+        if (events & POLLIN)
+            ret |= EPOLLIN;
+        if (events & POLLPRI)
+            ret |= EPOLLPRI;
+        if (events & POLLOUT)
+            ret |= EPOLLOUT;
+        return ret;
+    }
+
+    short fromEpollEvents(uint32_t events)
+    {
+        short ret = 0;
+        if (events & EPOLLIN)
+            ret |= POLLIN;
+        if (events & EPOLLPRI)
+            ret |= POLLPRI;
+        if (events & EPOLLOUT)
+            ret |= POLLOUT;
+        if (events & EPOLLERR)
+            ret |= POLLERR;
+        if (events & EPOLLHUP)
+            ret |= POLLHUP;
+        return ret;
+    }
+}
+#endif
+
 const short SelectorImpl::POLL_ERROR_MASK= POLLERR | POLLHUP | POLLNVAL;
 
 SelectorImpl::SelectorImpl()
-: _isDirty(true)
+: _wakePending(0),
+  _isDirty(true)
+#ifdef WITH_EPOLL
+, _epollFd(-1)
+#endif
 {
     _current = _devices.end();
 
+#ifdef HAVE_EVENTFD
+    //Open a eventfd to send wake up message.
+    _wakePipe[0] = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (_wakePipe[0] < 0)
+        throwSystemError("eventfd");
+
+    _wakePipe[1] = _wakePipe[0];
+#else
     //Open a pipe to send wake up message.
     if( ::pipe( _wakePipe ) )
         throwSystemError("pipe");
@@ -72,7 +131,29 @@ SelectorImpl::SelectorImpl()
     ret = ::fcntl(_wakePipe[1], F_SETFL, flags|O_NONBLOCK);
     if(-1 == ret)
         throwSystemError("fcntl");
+#endif
 
+#ifdef WITH_EPOLL
+    if (useEpoll())
+    {
+        _epollFd = ::epoll_create1(EPOLL_CLOEXEC);
+        if (_epollFd < 0)
+        {
+            log_warn("epoll_create1 failed with errno " << errno << "; falling back to poll");
+        }
+        else
+        {
+            epoll_event ev;
+            ev.events = EPOLLIN;
+            ev.data.fd = _wakePipe[0];
+            if (::epoll_ctl(_epollFd, EPOLL_CTL_ADD, _wakePipe[0], &ev) != 0)
+                throwSystemError("epoll_ctl");
+
+            _events.resize(64);
+            log_debug("using epoll selector " << _epollFd);
+        }
+    }
+#endif
 }
 
 
@@ -85,10 +166,22 @@ SelectorImpl::~SelectorImpl()
         (*it)->setSelector(0);
     }
 
+#ifdef WITH_EPOLL
+    for (EpollEntries::iterator it = _entries.begin(); it != _entries.end(); ++it)
+        delete it->second;
+
+    for (std::vector<EpollEntry*>::iterator it = _removed.begin(); it != _removed.end(); ++it)
+        delete *it;
+
+    if (_epollFd >= 0)
+        ::close(_epollFd);
+#endif
+
     if( _wakePipe[0] != -1 && _wakePipe[1] != -1 )
     {
         ::close(_wakePipe[0]);
-        ::close(_wakePipe[1]);
+        if (_wakePipe[1] != _wakePipe[0])
+            ::close(_wakePipe[1]);
     }
 }
 
@@ -97,6 +190,23 @@ void SelectorImpl::add(Selectable& dev)
 {
     _devices.insert(&dev);
     _isDirty = true;
+
+#ifdef WITH_EPOLL
+    if (_epollFd >= 0)
+    {
+        EpollEntries::iterator it = _entries.find(&dev);
+        if (it == _entries.end())
+        {
+            EpollEntry* entry = new EpollEntry(&dev);
+            _entries.insert(EpollEntries::value_type(&dev, entry));
+            epollInitialize(entry);
+        }
+        else
+        {
+            epollMarkDirty(it->second);
+        }
+    }
+#endif
 }
 
 
@@ -119,7 +229,28 @@ void SelectorImpl::remove(Selectable& dev)
         _devices.erase(it);
     }
 
+    _avail.erase(&dev);
     _isDirty = true;
+
+#ifdef WITH_EPOLL
+    if (_epollFd >= 0)
+    {
+        EpollEntries::iterator eit = _entries.find(&dev);
+        if (eit != _entries.end())
+        {
+            // the entry may still be referenced by the ready or dirty list,
+            // so it is released on the next wait
+            EpollEntry* entry = eit->second;
+            for (std::vector<EpollSlot>::iterator sit = entry->slots.begin(); sit != entry->slots.end(); ++sit)
+                epollUnregister(entry, *sit);
+
+            _unpolled.erase(entry);
+            entry->removed = true;
+            _removed.push_back(entry);
+            _entries.erase(eit);
+        }
+    }
+#endif
 }
 
 
@@ -133,10 +264,48 @@ void SelectorImpl::changed( Selectable& s )
     {
         _avail.erase(&s);
     }
+
+#ifdef WITH_EPOLL
+    if (_epollFd >= 0)
+    {
+        EpollEntries::iterator it = _entries.find(&s);
+        if (it != _entries.end())
+            epollMarkDirty(it->second);
+    }
+#endif
+}
+
+
+void SelectorImpl::reinit( Selectable& s )
+{
+#ifdef WITH_EPOLL
+    if (_epollFd >= 0)
+    {
+        EpollEntries::iterator it = _entries.find(&s);
+        if (it != _entries.end())
+        {
+            if (it->second->pfds.size() != s.simpl().pollSize())
+                epollInitialize(it->second);
+            else
+                epollMarkDirty(it->second);
+        }
+    }
+#endif
 }
 
 
 bool SelectorImpl::waitUntil(Timespan until)
+{
+#ifdef WITH_EPOLL
+    if (_epollFd >= 0)
+        return epollUntil(until);
+#endif
+
+    return pollUntil(until);
+}
+
+
+bool SelectorImpl::pollUntil(Timespan until)
 {
     if (!_avail.empty())
         until = Timespan(0);
@@ -249,27 +418,8 @@ bool SelectorImpl::waitUntil(Timespan until)
                 throw IOError("poll error on event pipe");
             }
 
-            static char buffer[1024];
-            while(true)
-            {
-                int ret = ::read(_wakePipe[0], buffer, sizeof(buffer));
-                if(ret > 0)
-                {
-                    avail = true;
-                    continue;
-                }
-
-                if (ret == -1)
-                {
-                    if(errno == EINTR)
-                        continue;
-
-                    if(errno == EAGAIN)
-                        break;
-                }
-
-                throw IOError("Could not read from pipe");
-            }
+            if (readWakePipe())
+                avail = true;
         }
 
         for( _current = _devices.begin(); _current != _devices.end(); )
@@ -300,9 +450,370 @@ bool SelectorImpl::waitUntil(Timespan until)
 }
 
 
+bool SelectorImpl::readWakePipe()
+{
+    bool avail = false;
+
+    // wakes after this point must write to the pipe again
+    atomicSet(_wakePending, 0);
+
+    static char buffer[1024];
+    while(true)
+    {
+        int ret = ::read(_wakePipe[0], buffer, sizeof(buffer));
+        if(ret > 0)
+        {
+            avail = true;
+            continue;
+        }
+
+        if (ret == -1)
+        {
+            if(errno == EINTR)
+                continue;
+
+            if(errno == EAGAIN)
+                break;
+        }
+
+        throw IOError("Could not read from pipe");
+    }
+
+    return avail;
+}
+
+
+#ifdef WITH_EPOLL
+
+void SelectorImpl::epollInitialize(EpollEntry* entry)
+{
+    SelectableImpl& simpl = entry->dev->simpl();
+    std::size_t pollSize = simpl.pollSize();
+
+    log_debug("initialize epoll entry with " << pollSize << " fds");
+
+    while (entry->slots.size() > pollSize)
+    {
+        epollUnregister(entry, entry->slots.back());
+        entry->slots.pop_back();
+    }
+
+    EpollSlot slot;
+    slot.fd = -1;
+    slot.events = 0;
+    slot.revents = 0;
+    entry->slots.resize(pollSize, slot);
+
+    pollfd pfd;
+    pfd.fd = -1;
+    pfd.events = 0;
+    pfd.revents = 0;
+    entry->pfds.assign(pollSize, pfd);
+
+    if (pollSize > 0)
+        simpl.initializePoll(&entry->pfds[0], pollSize);
+
+    epollMarkDirty(entry);
+}
+
+
+void SelectorImpl::epollMarkDirty(EpollEntry* entry)
+{
+    if (!entry->dirty)
+    {
+        entry->dirty = true;
+        _dirty.push_back(entry);
+    }
+}
+
+
+void SelectorImpl::epollMarkReady(EpollEntry* entry)
+{
+    if (!entry->ready)
+    {
+        entry->ready = true;
+        _ready.push_back(entry);
+    }
+}
+
+
+void SelectorImpl::epollSync(EpollEntry* entry)
+{
+    bool unpolled = false;
+
+    for (std::size_t n = 0; n < entry->pfds.size(); ++n)
+    {
+        const pollfd& pfd = entry->pfds[n];
+        EpollSlot& slot = entry->slots[n];
+
+        if (slot.fd != pfd.fd)
+            epollUnregister(entry, slot);
+
+        if (pfd.fd < 0)
+            continue;
+
+        short events = pfd.events & (POLLIN | POLLPRI | POLLOUT);
+        if (slot.fd == pfd.fd && slot.events == events)
+        {
+            if (slot.revents)
+            {
+                slot.revents = events;
+                unpolled = true;
+            }
+            continue;
+        }
+
+        epoll_event ev;
+        ev.events = toEpollEvents(events);
+        ev.data.fd = pfd.fd;
+
+        int ret;
+        if (slot.fd == pfd.fd)
+        {
+            ret = ::epoll_ctl(_epollFd, EPOLL_CTL_MOD, pfd.fd, &ev);
+
+            // the descriptor was closed and reopened with the same number
+            if (ret != 0 && errno == ENOENT)
+                ret = ::epoll_ctl(_epollFd, EPOLL_CTL_ADD, pfd.fd, &ev);
+        }
+        else
+        {
+            ret = ::epoll_ctl(_epollFd, EPOLL_CTL_ADD, pfd.fd, &ev);
+
+            // a previous owner of the descriptor number left its registration
+            if (ret != 0 && errno == EEXIST)
+                ret = ::epoll_ctl(_epollFd, EPOLL_CTL_MOD, pfd.fd, &ev);
+        }
+
+        slot.fd = pfd.fd;
+        slot.events = events;
+        slot.revents = 0;
+
+        if (ret != 0)
+        {
+            // poll reports regular files as always ready and closed
+            // descriptors as invalid
+            int errnum = errno;
+            log_debug("epoll_ctl(" << pfd.fd << ") failed with errno " << errnum);
+            slot.revents = errnum == EPERM ? events : POLLNVAL;
+            unpolled = true;
+        }
+
+        if (static_cast<std::size_t>(pfd.fd) >= _fdOwner.size())
+            _fdOwner.resize(pfd.fd + 1);
+        _fdOwner[pfd.fd] = entry;
+    }
+
+    if (unpolled)
+        _unpolled.insert(entry);
+    else
+        _unpolled.erase(entry);
+}
+
+
+void SelectorImpl::epollUnregister(EpollEntry* entry, EpollSlot& slot)
+{
+    if (slot.fd < 0)
+        return;
+
+    if (static_cast<std::size_t>(slot.fd) < _fdOwner.size()
+        && _fdOwner[slot.fd] == entry)
+    {
+        // closing the descriptor already removed it from the epoll set
+        // implicitly, so errors are expected here
+        if (slot.revents == 0)
+        {
+            epoll_event ev;
+            ::epoll_ctl(_epollFd, EPOLL_CTL_DEL, slot.fd, &ev);
+        }
+
+        _fdOwner[slot.fd] = 0;
+    }
+
+    slot.fd = -1;
+    slot.events = 0;
+    slot.revents = 0;
+}
+
+
+bool SelectorImpl::epollUntil(Timespan until)
+{
+    // pass changes of the requested events to the kernel
+    for (std::vector<EpollEntry*>::size_type n = 0; n < _dirty.size(); ++n)
+    {
+        EpollEntry* entry = _dirty[n];
+        entry->dirty = false;
+        if (!entry->removed)
+            epollSync(entry);
+    }
+
+    _dirty.clear();
+
+    for (std::vector<EpollEntry*>::iterator it = _removed.begin(); it != _removed.end(); ++it)
+        delete *it;
+
+    _removed.clear();
+
+    if (!_avail.empty() || !_unpolled.empty())
+        until = Timespan(0);
+
+    int ret = -1;
+    while (true)
+    {
+        int epollTimeout = until == Timespan(0) ? 0 : -1;
+        if (until > Timespan(0))
+        {
+            Timespan remaining = until - Timespan::gettimeofday();
+            if (remaining < Timespan(0))
+                remaining = Timespan(0);
+
+            if (Milliseconds(remaining) >= std::numeric_limits<int>::max())
+                epollTimeout = std::numeric_limits<int>::max();
+            else
+                epollTimeout = Milliseconds(remaining).ceil();
+
+            log_debug("remaining " << remaining);
+        }
+        else
+            log_debug("no timeout");
+
+        log_debug("epoll_wait with " << _entries.size() << " devices, timeout=" << epollTimeout << "ms");
+        ret = ::epoll_wait(_epollFd, &_events[0], _events.size(), epollTimeout);
+        log_debug("epoll_wait returns " << ret);
+
+        if( ret != -1 )
+            break;
+
+        if( errno != EINTR )
+            throw IOError("Could not poll on file descriptors");
+    }
+
+    if( ret == 0 && _avail.empty() && _unpolled.empty() )
+        return false;
+
+    bool avail = false;
+    try
+    {
+        for (int n = 0; n < ret; ++n)
+        {
+            const epoll_event& ev = _events[n];
+            int fd = ev.data.fd;
+
+            if (fd == _wakePipe[0])
+            {
+                if (ev.events & (EPOLLERR | EPOLLHUP))
+                    throw IOError("poll error on event pipe");
+
+                if (readWakePipe())
+                    avail = true;
+
+                continue;
+            }
+
+            if (static_cast<std::size_t>(fd) >= _fdOwner.size() || _fdOwner[fd] == 0)
+                continue;
+
+            EpollEntry* entry = _fdOwner[fd];
+            for (std::size_t i = 0; i < entry->pfds.size(); ++i)
+            {
+                pollfd& pfd = entry->pfds[i];
+                if (pfd.fd == fd)
+                {
+                    pfd.revents = fromEpollEvents(ev.events) & (pfd.events | POLL_ERROR_MASK);
+                    if (pfd.revents)
+                        epollMarkReady(entry);
+                }
+            }
+        }
+
+        // all slots were used; expect more next time
+        if (static_cast<std::size_t>(ret) == _events.size())
+            _events.resize(_events.size() * 2);
+
+        for (std::set<EpollEntry*>::iterator it = _unpolled.begin(); it != _unpolled.end(); ++it)
+        {
+            EpollEntry* entry = *it;
+            for (std::size_t i = 0; i < entry->pfds.size(); ++i)
+            {
+                if (entry->slots[i].revents && entry->slots[i].fd == entry->pfds[i].fd)
+                {
+                    entry->pfds[i].revents = entry->slots[i].revents;
+                    epollMarkReady(entry);
+                }
+            }
+        }
+
+        for (std::set<Selectable*>::iterator it = _avail.begin(); it != _avail.end(); ++it)
+        {
+            EpollEntries::iterator eit = _entries.find(*it);
+            if (eit != _entries.end())
+                epollMarkReady(eit->second);
+        }
+
+        for (std::vector<EpollEntry*>::size_type n = 0; n < _ready.size(); ++n)
+        {
+            EpollEntry* entry = _ready[n];
+            if (entry->removed)
+                continue;
+
+            Selectable* dev = entry->dev;
+            if ( dev->enabled() && dev->simpl().checkPollEvent() )
+            {
+                avail = true;
+            }
+
+            // the device may have changed its events while processing
+            if (!entry->removed)
+            {
+                for (std::size_t i = 0; i < entry->pfds.size(); ++i)
+                    entry->pfds[i].revents = 0;
+
+                epollMarkDirty(entry);
+            }
+        }
+    }
+    catch (...)
+    {
+        for (std::vector<EpollEntry*>::size_type n = 0; n < _ready.size(); ++n)
+        {
+            EpollEntry* entry = _ready[n];
+            entry->ready = false;
+            if (!entry->removed)
+            {
+                for (std::size_t i = 0; i < entry->pfds.size(); ++i)
+                    entry->pfds[i].revents = 0;
+
+                epollMarkDirty(entry);
+            }
+        }
+
+        _ready.clear();
+        throw;
+    }
+
+    for (std::vector<EpollEntry*>::size_type n = 0; n < _ready.size(); ++n)
+        _ready[n]->ready = false;
+
+    _ready.clear();
+
+    return avail;
+}
+
+#endif
+
+
 void SelectorImpl::wake()
 {
+    // the pipe needs to be written only once until the loop drains it
+    if (atomicCompareExchange(_wakePending, 1, 0) != 0)
+        return;
+
+#ifdef HAVE_EVENTFD
+    uint64_t one = 1;
+    ::write( _wakePipe[1], &one, sizeof(one));
+#else
     ::write( _wakePipe[1], "W", 1);
+#endif
 }
 
 } //namespace cxxtools
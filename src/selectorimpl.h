@@ -32,9 +32,16 @@
 #include <cxxtools/selectable.h>
 #include <cxxtools/timespan.h>
 #include <cxxtools/clock.h>
+#include <cxxtools/atomicity.h>
 #include <sys/poll.h>
 #include <vector>
 #include <set>
+#include <map>
+#include "config.h"
+
+#ifdef WITH_EPOLL
+#include <sys/epoll.h>
+#endif
 
 namespace cxxtools {
 
@@ -51,18 +58,82 @@ class SelectorImpl
 
         void changed( Selectable& dev );
 
+        void reinit( Selectable& dev );
+
         bool waitUntil(Timespan timeout);
 
         void wake();
 
     private:
+        bool pollUntil(Timespan until);
+
+        bool readWakePipe();
+
         static const short POLL_ERROR_MASK;
+
+        // With eventfd both ends of the wake pipe are the same descriptor.
         int _wakePipe[2];
+        volatile atomic_t _wakePending;
         bool _isDirty;
         std::vector<pollfd> _pollfds;
         std::set<Selectable*>::iterator _current;
         std::set<Selectable*> _devices;
         std::set<Selectable*> _avail;
+
+#ifdef WITH_EPOLL
+        // Registration of a single descriptor in the epoll set. Descriptors
+        // epoll can't watch (regular files, closed descriptors) get revents
+        // set, which are reported on each wait just like poll would do.
+        struct EpollSlot
+        {
+            int fd;
+            short events;
+            short revents;
+        };
+
+        // A Selectable registered in the epoll backend. The device keeps a
+        // pointer to pfds just like it does to the shared pollfd array of
+        // the poll backend, so it can modify the requested events directly.
+        struct EpollEntry
+        {
+            Selectable* dev;
+            std::vector<pollfd> pfds;
+            std::vector<EpollSlot> slots;
+            bool dirty;
+            bool ready;
+            bool removed;
+
+            explicit EpollEntry(Selectable* dev_)
+                : dev(dev_),
+                  dirty(false),
+                  ready(false),
+                  removed(false)
+                { }
+        };
+
+        typedef std::map<Selectable*, EpollEntry*> EpollEntries;
+
+        bool epollUntil(Timespan until);
+
+        void epollInitialize(EpollEntry* entry);
+
+        void epollMarkDirty(EpollEntry* entry);
+
+        void epollMarkReady(EpollEntry* entry);
+
+        void epollSync(EpollEntry* entry);
+
+        void epollUnregister(EpollEntry* entry, EpollSlot& slot);
+
+        int _epollFd;
+        EpollEntries _entries;
+        std::vector<EpollEntry*> _fdOwner;
+        std::vector<EpollEntry*> _dirty;
+        std::vector<EpollEntry*> _ready;
+        std::vector<EpollEntry*> _removed;
+        std::set<EpollEntry*> _unpolled;
+        std::vector<epoll_event> _events;
+#endif
 };
 
 }//namespace xpr
@@ -35,19 +35,140 @@
 
 #include <stdexcept>
 #include <sstream>
+#include <vector>
 
 log_define("cxxtools.serializationinfo")
 
 namespace cxxtools
 {
 
+namespace
+{
+    // objects with at least that many members get a name index
+    const unsigned memberIndexThreshold = 16;
+
+    std::size_t hashName(const std::string& name)
+    {
+        // FNV-1a
+        uint32_t h = 2166136261u;
+        for (std::string::const_iterator it = name.begin(); it != name.end(); ++it)
+            h = (h ^ static_cast<unsigned char>(*it)) * 16777619u;
+        return h;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////
+// MemberIndex
+//
+// Open addressing hash table of member positions. It covers all members but
+// the last, since deserializers tend to rename a member right after adding it.
+// Renaming an indexed member marks the index dirty. A dirty index is rebuilt
+// on the next non const access; const lookups fall back to a linear search
+// until then, so that concurrent readers never modify the index.
+//
+class SerializationInfo::MemberIndex
+{
+        const Nodes& _nodes;
+        std::vector<unsigned> _slots;   // position + 1; 0 marks an empty slot
+        Nodes::size_type _indexed;
+        bool _dirty;
+
+        void insert(Nodes::size_type pos);
+
+    public:
+        explicit MemberIndex(const Nodes& nodes)
+            : _nodes(nodes),
+              _indexed(0),
+              _dirty(true)
+            { }
+
+        bool dirty() const   { return _dirty; }
+        void reset()         { _dirty = true; }
+
+        void update(Nodes::size_type size);
+        void nameChanged(const SerializationInfo* si);
+        const SerializationInfo* find(const std::string& name, Nodes::size_type size) const;
+};
+
+void SerializationInfo::MemberIndex::insert(Nodes::size_type pos)
+{
+    const std::string& name = _nodes[pos].name();
+    std::size_t mask = _slots.size() - 1;
+    for (std::size_t i = hashName(name) & mask; ; i = (i + 1) & mask)
+    {
+        if (_slots[i] == 0)
+        {
+            _slots[i] = pos + 1;
+            return;
+        }
+
+        // keep the first member with that name
+        if (_nodes[_slots[i] - 1].name() == name)
+            return;
+    }
+}
+
+void SerializationInfo::MemberIndex::update(Nodes::size_type size)
+{
+    Nodes::size_type count = size == 0 ? 0 : size - 1;
+
+    if (_dirty || count * 2 > _slots.size())
+    {
+        std::size_t size = 32;
+        while (size < count * 2)
+            size <<= 1;
+
+        log_debug("rebuild member index with " << size << " slots for " << count << " members");
+
+        _slots.assign(size, 0);
+        _indexed = 0;
+        _dirty = false;
+    }
+
+    for ( ; _indexed < count; ++_indexed)
+        insert(_indexed);
+}
+
+void SerializationInfo::MemberIndex::nameChanged(const SerializationInfo* si)
+{
+    if (!_dirty && _indexed < _nodes.size() && si == &_nodes[_indexed])
+        return;
+
+    _dirty = true;
+}
+
+const SerializationInfo* SerializationInfo::MemberIndex::find(const std::string& name, Nodes::size_type size) const
+{
+    std::size_t mask = _slots.size() - 1;
+    for (std::size_t i = hashName(name) & mask; _slots[i] != 0; i = (i + 1) & mask)
+    {
+        const SerializationInfo& si = _nodes[_slots[i] - 1];
+        if (si.name() == name)
+            return &si;
+    }
+
+    for (Nodes::size_type pos = _indexed; pos < size; ++pos)
+    {
+        if (_nodes[pos].name() == name)
+            return &_nodes[pos];
+    }
+
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////
+// SerializationInfo
+//
 SerializationInfo::SerializationInfo(const SerializationInfo& si)
 : _category(si._category),
   _name(si._name),
   _type(si._type),
   _u(si._u),
   _t(si._t),
-  _nodes(0)
+  _nodes(0),
+  _size(0),
+  _index(0),
+  _owner(0)
 {
     switch (_t)
     {
@@ -61,8 +182,13 @@ SerializationInfo::SerializationInfo(const SerializationInfo& si)
             ;
     }
 
-    if (si._nodes)
-        _nodes = new Nodes(*si._nodes);
+    if (si._size > 0)
+    {
+        _nodes = new Nodes(si.begin(), si.end());
+        _size = si._size;
+        if (_size >= memberIndexThreshold)
+            _createIndex();
+    }
 }
 
 
@@ -72,7 +198,12 @@ SerializationInfo& SerializationInfo::operator=(const SerializationInfo& si)
         return *this;
 
     assignData(si);
-    _name = si._name;
+    if (_name != si._name)
+    {
+        _name = si._name;
+        if (_owner)
+            _nameChanged();
+    }
 
     return *this;
 }
@@ -86,7 +217,10 @@ SerializationInfo::SerializationInfo(SerializationInfo&& si) noexcept
       _type(std::move(si._type)),
       _u(si._u),
       _t(si._t),
-      _nodes(si._nodes)
+      _nodes(si._nodes),
+      _size(si._size),
+      _index(si._index),
+      _owner(0)
 {
     if (si._t == t_string)
     {
@@ -98,16 +232,36 @@ SerializationInfo::SerializationInfo(SerializationInfo&& si) noexcept
     }
 
     si._nodes = 0;
+    si._size = 0;
+    si._index = 0;
+    if (si._owner)
+        si._nameChanged();
 }
 
 
 SerializationInfo& SerializationInfo::operator=(SerializationInfo&& si)
 {
+    if (this == &si)
+        return *this;
+
+    // si may be one of our members, so release our nodes at the end
+    Nodes* nodes = _nodes;
+    MemberIndex* index = _index;
+
     _category = si._category;
     _name = std::move(si._name);
     _type = std::move(si._type);
     _nodes = si._nodes;
+    _size = si._size;
+    _index = si._index;
     si._nodes = 0;
+    si._size = 0;
+    si._index = 0;
+
+    if (_owner)
+        _nameChanged();
+    if (si._owner)
+        si._nameChanged();
 
     if (si._t == t_string)
     {
@@ -138,6 +292,9 @@ SerializationInfo& SerializationInfo::operator=(SerializationInfo&& si)
         _u = si._u;
     }
 
+    delete index;
+    delete nodes;
+
     return *this;
 }
 
@@ -147,6 +304,7 @@ SerializationInfo& SerializationInfo::operator=(SerializationInfo&& si)
 SerializationInfo::~SerializationInfo()
 {
     _releaseValue();
+    delete _index;
     delete _nodes;
 }
 
@@ -155,8 +313,23 @@ SerializationInfo& SerializationInfo::addMember(const std::string& name)
     log_debug("addMember(\"" << name << "\")");
 
     Nodes& n = nodes();
-    n.push_back(SerializationInfo());
-    n.back().setName(name);
+    if (_size < n.size())
+        n[_size]._reset();   // reuse a node kept by reset()
+    else
+        n.push_back(SerializationInfo());
+
+    SerializationInfo& member = n[_size++];
+    member._name = name;
+    member._owner = _index;
+
+    if (_index)
+    {
+        _index->update(_size);
+    }
+    else if (_size >= memberIndexThreshold)
+    {
+        _createIndex();
+    }
 
     // category Array overrides Object
     // This is needed for xmldeserialization. In the xml file the root node of a array
@@ -166,7 +339,7 @@ SerializationInfo& SerializationInfo::addMember(const std::string& name)
     if (_category != Array && _category != Object)
         _category = name.empty() ? Array : Object;
 
-    return n.back();
+    return member;
 }
 
 
@@ -174,15 +347,11 @@ const SerializationInfo& SerializationInfo::getMember(const std::string& name) c
 {
     log_debug("getMember(\"" << name << "\")");
 
-    const Nodes& n = nodes();
+    const SerializationInfo* si = findMember(name);
+    if (si == 0)
+        throw SerializationMemberNotFound(name);
 
-    for (Nodes::const_iterator it = n.begin(); it != n.end(); ++it)
-    {
-        if( it->name() == name )
-            return *it;
-    }
-
-    throw SerializationMemberNotFound(name);
+    return *si;
 }
 
 
@@ -192,10 +361,10 @@ const SerializationInfo& SerializationInfo::getMember(unsigned idx) const
 
     const Nodes& n = nodes();
 
-    if (idx >= n.size())
+    if (idx >= _size)
     {
         std::ostringstream msg;
-        msg << "requested member index " << idx << " exceeds number of members " << n.size();
+        msg << "requested member index " << idx << " exceeds number of members " << _size;
         throw std::range_error(msg.str());
     }
 
@@ -207,9 +376,10 @@ const SerializationInfo* SerializationInfo::findMember(const std::string& name)
 {
     log_debug("findMember(\"" << name << "\")");
 
-    const Nodes& n = nodes();
+    if (_index && !_index->dirty())
+        return _index->find(name, _size);
 
-    for (Nodes::const_iterator it = n.begin(); it != n.end(); ++it)
+    for (ConstIterator it = begin(); it != end(); ++it)
     {
         if( it->name() == name )
             return &(*it);
@@ -223,9 +393,13 @@ SerializationInfo* SerializationInfo::findMember(const std::string& name)
 {
     log_debug("findMember(\"" << name << "\")");
 
-    Nodes& n = nodes();
+    if (_index)
+    {
+        _index->update(_size);
+        return const_cast<SerializationInfo*>(_index->find(name, _size));
+    }
 
-    for (Nodes::iterator it = n.begin(); it != n.end(); ++it)
+    for (Iterator it = begin(); it != end(); ++it)
     {
         if( it->name() == name )
             return &(*it);
@@ -237,9 +411,39 @@ SerializationInfo* SerializationInfo::findMember(const std::string& name)
 void SerializationInfo::clear()
 {
     _category = Void;
-    _name.clear();
+    if (!_name.empty())
+    {
+        _name.clear();
+        if (_owner)
+            _nameChanged();
+    }
     _type.clear();
+    delete _index;
+    _index = 0;
     nodes().clear();
+    _size = 0;
+    _releaseValue();
+}
+
+void SerializationInfo::reset()
+{
+    if (!_name.empty() && _owner)
+    {
+        _name.clear();
+        _nameChanged();
+    }
+
+    _reset();
+}
+
+void SerializationInfo::_reset()
+{
+    _category = Void;
+    _name.clear();
+    _type.clear();
+    _size = 0;
+    if (_index)
+        _index->reset();
     _releaseValue();
 }
 
@@ -249,9 +453,17 @@ void SerializationInfo::swap(SerializationInfo& si)
         return;
 
     std::swap(_category, si._category);
-    std::swap(_name, si._name);
     std::swap(_type, si._type);
 
+    if (_name != si._name)
+    {
+        std::swap(_name, si._name);
+        if (_owner)
+            _nameChanged();
+        if (si._owner)
+            si._nameChanged();
+    }
+
     if (_t == t_string)
     {
         if (si._t == t_string)
@@ -338,6 +550,8 @@ void SerializationInfo::swap(SerializationInfo& si)
     }
 
     std::swap(_nodes, si._nodes);
+    std::swap(_size, si._size);
+    std::swap(_index, si._index);
 }
 
 void SerializationInfo::dump(std::ostream& out, const std::string& prefix) const
@@ -380,10 +594,10 @@ void SerializationInfo::dump(std::ostream& out, const std::string& prefix) const
     out << prefix << "category = " << static_cast<unsigned>(_category) << '\n';
 
     const Nodes& n = nodes();
-    if (!n.empty())
+    if (_size > 0)
     {
         std::string p = prefix + '\t';
-        for (Nodes::size_type i = 0; i < n.size(); ++i)
+        for (Nodes::size_type i = 0; i < _size; ++i)
         {
             out << prefix << "node[" << i << "]\n";
             n[i].dump(out, p);
@@ -945,6 +1159,19 @@ SerializationInfo::Nodes& SerializationInfo::nodes()
     return *_nodes;
 }
 
+void SerializationInfo::_createIndex()
+{
+    _index = new MemberIndex(*_nodes);
+    for (Nodes::iterator it = _nodes->begin(); it != _nodes->end(); ++it)
+        it->_owner = _index;
+    _index->update(_size);
+}
+
+void SerializationInfo::_nameChanged()
+{
+    _owner->nameChanged(this);
+}
+
 const SerializationInfo::Nodes& SerializationInfo::nodes() const
 {
     static const Nodes emptyNodes;
@@ -960,10 +1187,18 @@ void SerializationInfo::assignData(const SerializationInfo& si)
     _category = si._category;
     _type = si._type;
 
+    delete _index;
+    _index = 0;
     delete _nodes;
     _nodes = 0;
-    if (si._nodes)
-        _nodes = new Nodes(*si._nodes);
+    _size = 0;
+    if (si._size > 0)
+    {
+        _nodes = new Nodes(si.begin(), si.end());
+        _size = si._size;
+        if (_size >= memberIndexThreshold)
+            _createIndex();
+    }
 
     if (si._t == t_string)
         _setString( si._String() );
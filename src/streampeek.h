@@ -0,0 +1,62 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef CXXTOOLS_STREAMPEEK_H
+#define CXXTOOLS_STREAMPEEK_H
+
+#include <cxxtools/streambuffer.h>
+#include <streambuf>
+
+namespace cxxtools
+{
+  // Copies up to size characters of the input of sb to buffer without
+  // consuming them. The stream buffers of cxxtools give all buffered
+  // characters, others just the next one. The buffer is filled first, when
+  // it is empty, which may block. Returns 0 at the end of the input.
+  inline std::streamsize peekInput(std::streambuf& sb, char* buffer, std::streamsize size)
+  {
+    if (size <= 0 || sb.sgetc() == std::streambuf::traits_type::eof())
+      return 0;
+
+    BasicStreamBuffer<char>* csb = dynamic_cast<BasicStreamBuffer<char>*>(&sb);
+    if (csb)
+      return csb->speekn(buffer, size);
+
+    buffer[0] = std::streambuf::traits_type::to_char_type(sb.sgetc());
+    return 1;
+  }
+
+  // Consumes n characters, which were returned by peekInput.
+  inline void skipInput(std::streambuf& sb, std::streamsize n)
+  {
+    for ( ; n > 0; --n)
+      sb.sbumpc();
+  }
+}
+
+#endif // CXXTOOLS_STREAMPEEK_H
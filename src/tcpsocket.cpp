@@ -238,6 +238,8 @@ void TcpSocket::beginSslConnect()
 #ifdef WITH_SSL
     if (_impl->beginSslConnect())
         sslConnected(*this);
+    else
+        setEnabled(true);  // let the selector update the requested events
 #else
     log_warn("can't connect ssl since ssl is disabled");
     sslConnected(*this);
@@ -267,6 +269,8 @@ void TcpSocket::beginSslAccept()
 #ifdef WITH_SSL
     if (_impl->beginSslAccept())
         sslAccepted(*this);
+    else
+        setEnabled(true);  // let the selector update the requested events
 #else
     log_warn("can't accept ssl connection since ssl is disabled");
     sslAccepted(*this);
@@ -295,6 +299,8 @@ void TcpSocket::beginSslShutdown()
 #ifdef WITH_SSL
     if (_impl->beginSslShutdown())
         sslClosed(*this);
+    else
+        setEnabled(true);  // let the selector update the requested events
 #else
     log_warn("can't shutdown ssl connection since ssl is disabled");
     sslClosed(*this);
@@ -57,7 +57,22 @@ namespace cxxtools
 
     ThreadPool::Future ThreadPool::schedule(const Callable<void>& cb)
     {
-        return _impl->schedule(cb);
+        return _impl->schedule(new CallableJob<void>(cb));
+    }
+
+    ThreadPool::Future ThreadPool::scheduleJob(Job* job)
+    {
+        return _impl->schedule(job);
+    }
+
+    std::vector<ThreadPool::Future> ThreadPool::scheduleBatch(const std::vector<Job*>& jobs)
+    {
+        return _impl->scheduleBatch(jobs);
+    }
+
+    void ThreadPool::parallelFor(std::size_t begin, std::size_t end, RangeJob& body, std::size_t grain)
+    {
+        _impl->parallelFor(begin, end, body, grain);
     }
 
     bool ThreadPool::running() const
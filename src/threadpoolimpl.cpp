@@ -27,53 +27,213 @@
  */
 
 #include "threadpoolimpl.h"
+#include <cxxtools/smartptr.h>
 #include <stdexcept>
+#include <algorithm>
 #include <cxxtools/log.h>
 
+#if __cplusplus >= 201103L
+#include <exception>
+#endif
+
 log_define("cxxtools.threadpool.impl")
 
 namespace cxxtools
 {
-    bool ThreadPool::Future::FutureImpl::wait(Timespan timeout) const
+    namespace
     {
-        MutexLock lock(_mutex);
+        // Threads waiting for a future sleep on one of these slots, chosen
+        // by the address of the future.
+        struct WaitSlot
+        {
+            Mutex mutex;
+            Condition stateChanged;
+        };
+
+        enum { WaitSlotCount = 16 };
+
+        WaitSlot& waitSlot(const void* future)
+        {
+            static WaitSlot slots[WaitSlotCount];
+            return slots[(reinterpret_cast<std::size_t>(future) / 64) % WaitSlotCount];
+        }
 
-        if (timeout > Timespan(0))
+        // The worker run by the current thread, if it belongs to a pool.
+        thread_local void* currentWorker = 0;
+
+        // The state of a parallelFor call, which is shared between the
+        // calling thread and the helper jobs. Helpers, which start after all
+        // chunks are taken, return without touching the body.
+        class ParallelFor : public AtomicRefCounted
         {
-            Timespan until = Timespan::gettimeofday() + timeout;
-            Timespan remaining;
+                ThreadPool::RangeJob& _body;
+                std::size_t _begin;
+                std::size_t _end;
+                std::size_t _grain;
+                atomic_t _chunks;
+                volatile atomic_t _next;
+                volatile atomic_t _done;
+
+                Mutex _mutex;
+                Condition _finished;
+                bool _failed;
+#if __cplusplus >= 201103L
+                std::exception_ptr _exception;
+#endif
+
+            public:
+                ParallelFor(ThreadPool::RangeJob& body, std::size_t begin, std::size_t end, std::size_t grain)
+                    : _body(body),
+                      _begin(begin),
+                      _end(end),
+                      _grain(grain),
+                      _chunks((end - begin + grain - 1) / grain),
+                      _next(0),
+                      _done(0),
+                      _failed(false)
+                { }
+
+                atomic_t chunks() const
+                { return _chunks; }
 
-            while (_state != Finished && _state != Failed
-              && (remaining = until - Timespan::gettimeofday()) > Timespan(0))
+                void work();
+                void wait();
+        };
+
+        void ParallelFor::work()
+        {
+            atomic_t chunk;
+            while ((chunk = atomicIncrement(_next) - 1) < _chunks)
             {
-                _stateChanged.wait(_mutex, remaining);
+                std::size_t begin = _begin + static_cast<std::size_t>(chunk) * _grain;
+                std::size_t end = std::min(begin + _grain, _end);
+
+                try
+                {
+                    _body.run(begin, end);
+                }
+                catch (...)
+                {
+                    MutexLock lock(_mutex);
+                    if (!_failed)
+                    {
+                        _failed = true;
+#if __cplusplus >= 201103L
+                        _exception = std::current_exception();
+#endif
+                    }
+                }
+
+                if (atomicIncrement(_done) == _chunks)
+                {
+                    MutexLock lock(_mutex);
+                    _finished.broadcast();
+                }
             }
         }
-        else
+
+        void ParallelFor::wait()
+        {
+            MutexLock lock(_mutex);
+            while (atomicGet(_done) < _chunks)
+                _finished.wait(lock);
+
+            if (_failed)
+            {
+#if __cplusplus >= 201103L
+                if (_exception)
+                    std::rethrow_exception(_exception);
+#endif
+                throw std::runtime_error("parallel for failed");
+            }
+        }
+
+        class ParallelForJob : public ThreadPool::Job
+        {
+                SmartPtr<ParallelFor> _parallelFor;
+
+            public:
+                explicit ParallelForJob(ParallelFor* parallelFor)
+                    : _parallelFor(parallelFor)
+                { }
+
+                virtual void run()
+                { _parallelFor->work(); }
+        };
+    }
+
+    bool ThreadPool::Future::FutureImpl::wait(Timespan timeout) const
+    {
+        if (isFinal(state()))
+            return true;
+
+        WaitSlot& slot = waitSlot(this);
+
+        // setState checks the waiters after setting the state, so either
+        // it sees us or we see the final state
+        atomicIncrement(_waiters);
+
         {
-            while (_state != Finished && _state != Failed)
-                _stateChanged.wait(_mutex);
+            MutexLock lock(slot.mutex);
+
+            if (timeout > Timespan(0))
+            {
+                Timespan until = Timespan::gettimeofday() + timeout;
+                Timespan remaining;
+
+                while (!isFinal(state())
+                  && (remaining = until - Timespan::gettimeofday()) > Timespan(0))
+                {
+                    slot.stateChanged.wait(lock, remaining);
+                }
+            }
+            else
+            {
+                while (!isFinal(state()))
+                    slot.stateChanged.wait(lock);
+            }
         }
 
-        return _state == Finished || _state == Failed;
+        atomicDecrement(_waiters);
+
+        return isFinal(state());
     }
 
     void ThreadPool::Future::FutureImpl::setState(State state)
     {
-        MutexLock lock(_mutex);
-        _state = state;
-        _stateChanged.broadcast();
+        atomicSet(_state, state);
+
+        if (atomicGet(_waiters) > 0)
+        {
+            WaitSlot& slot = waitSlot(this);
+            MutexLock lock(slot.mutex);
+            slot.stateChanged.broadcast();
+        }
+    }
+
+    ThreadPoolImpl::ThreadPoolImpl(unsigned size)
+        : _state(Stopped),
+          _size(size),
+          _pending(0),
+          _sleeping(0),
+          _next(0)
+    {
+        // jobs may be scheduled before the pool is started, so the queues
+        // exist for the whole lifetime
+        for (unsigned n = 0; n < std::max(size, 1u); ++n)
+            _workers.push_back(new Worker(this, n));
     }
 
     ThreadPoolImpl::~ThreadPoolImpl()
     {
-        log_debug("delete " << _threads.size() << " threads");
-        for (ThreadsType::iterator it = _threads.begin(); it != _threads.end(); ++it)
-            delete *it;
+        log_debug("delete " << _workers.size() << " workers");
+        cancelJobs();
 
-        log_debug("delete " << _queue.size() << " left tasks");
-        while (!_queue.empty())
-            _queue.get()._impl->setCanceled();
+        for (WorkersType::iterator it = _workers.begin(); it != _workers.end(); ++it)
+        {
+            delete (*it)->thread;
+            delete *it;
+        }
     }
 
     void ThreadPoolImpl::start()
@@ -83,15 +243,15 @@ namespace cxxtools
 
         _state = Starting;
 
-        while (_threads.size() < _size)
-            _threads.push_back(new AttachedThread(callable(*this, &ThreadPoolImpl::threadFunc)));
+        for (unsigned n = 0; n < _size; ++n)
+            _workers[n]->thread = new AttachedThread(callable(*_workers[n], &Worker::run));
 
         _state = Running;
 
-        for (ThreadsType::iterator it = _threads.begin(); it != _threads.end(); ++it)
+        for (unsigned n = 0; n < _size; ++n)
         {
-            log_debug("start thread " << static_cast<void*>(*it));
-            (*it)->start();
+            log_debug("start thread " << static_cast<void*>(_workers[n]->thread));
+            _workers[n]->thread->start();
         }
     }
 
@@ -100,62 +260,199 @@ namespace cxxtools
         if (_state != Running)
             throw std::logic_error("thread pool not running");
 
-        log_debug("stop " << _threads.size() << " threads");
-        _state = Stopping;
+        log_debug("stop " << _size << " threads");
+
+        {
+            MutexLock lock(_idleMutex);
+            _state = Stopping;
+            _jobAvailable.broadcast();
+        }
 
         if (cancel)
+            cancelJobs();
+
+        for (unsigned n = 0; n < _size; ++n)
         {
-            std::pair<ThreadPool::Future, bool> p;
-            while ((p = _queue.tryGet()).second)
-                p.first._impl->setCanceled();
+            _workers[n]->thread->join();
+            log_debug("joined thread " << static_cast<void*>(_workers[n]->thread));
+            delete _workers[n]->thread;
+            _workers[n]->thread = 0;
         }
 
-        for (ThreadsType::iterator it = _threads.begin(); it != _threads.end(); ++it)
-            _queue.put(0);
+        _state = Stopped;
+    }
 
-        for (ThreadsType::iterator it = _threads.begin(); it != _threads.end(); ++it)
+    void ThreadPoolImpl::cancelJobs()
+    {
+        for (WorkersType::iterator it = _workers.begin(); it != _workers.end(); ++it)
         {
-            (*it)->join();
-            log_debug("joined thread " << static_cast<void*>(*it));
-            delete *it;
+            MutexLock lock((*it)->mutex);
+            log_debug("cancel " << (*it)->jobs.size() << " left tasks");
+            while (!(*it)->jobs.empty())
+            {
+                (*it)->jobs.front()._impl->setCanceled();
+                (*it)->jobs.pop_front();
+                atomicDecrement(_pending);
+            }
         }
+    }
 
-        _threads.clear();
+    void ThreadPoolImpl::wakeWorkers(unsigned count)
+    {
+        if (atomicGet(_sleeping) == 0)
+            return;
 
-        _state = Stopped;
+        MutexLock lock(_idleMutex);
+        if (count >= _workers.size())
+            _jobAvailable.broadcast();
+        else
+            while (count-- > 0)
+                _jobAvailable.signal();
     }
 
-    ThreadPool::Future ThreadPoolImpl::schedule(const Callable<void>& cb)
+    ThreadPool::Future ThreadPoolImpl::schedule(ThreadPool::Job* job)
     {
-        ThreadPool::Future future(new ThreadPool::Future::FutureImpl(cb));
+        ThreadPool::Future future(new ThreadPool::Future::FutureImpl(job));
+
+        // jobs scheduled by a job stay in the queue of its thread
+        Worker* worker = static_cast<Worker*>(currentWorker);
+        if (worker == 0 || worker->pool != this)
+            worker = _workers[static_cast<std::size_t>(atomicIncrement(_next)) % _workers.size()];
+
+        {
+            MutexLock lock(worker->mutex);
+            worker->jobs.push_back(future);
+        }
 
-        log_debug("queue new task " << static_cast<void*>(future._impl->_callable));
-        _queue.put(future);
-        log_debug("queue size " << _queue.size());
+        atomicIncrement(_pending);
+        wakeWorkers(1);
 
         return future;
     }
 
-    void ThreadPoolImpl::threadFunc()
+    std::vector<ThreadPool::Future> ThreadPoolImpl::scheduleBatch(const std::vector<ThreadPool::Job*>& jobs)
     {
-        ThreadPool::Future future;
-        while ((future = _queue.get()), future._impl != 0)
+        std::vector<ThreadPool::Future> futures;
+        futures.reserve(jobs.size());
+        for (std::vector<ThreadPool::Job*>::const_iterator it = jobs.begin(); it != jobs.end(); ++it)
+            futures.push_back(ThreadPool::Future(new ThreadPool::Future::FutureImpl(*it)));
+
+        // pass a contiguous part of the jobs to each queue
+        std::size_t count = _workers.size();
+        std::size_t first = static_cast<std::size_t>(atomicIncrement(_next));
+        std::size_t begin = 0;
+        for (std::size_t n = 0; n < count && begin < futures.size(); ++n)
         {
-            log_debug("new task " << static_cast<void*>(future._impl->_callable) << " received " << _queue.size() << " tasks left");
+            std::size_t end = begin + (futures.size() - begin + count - n - 1) / (count - n);
+            Worker* worker = _workers[(first + n) % count];
 
-            try
+            MutexLock lock(worker->mutex);
+            worker->jobs.insert(worker->jobs.end(), futures.begin() + begin, futures.begin() + end);
+
+            begin = end;
+        }
+
+        atomicExchangeAdd(_pending, futures.size());
+        wakeWorkers(futures.size());
+
+        return futures;
+    }
+
+    void ThreadPoolImpl::parallelFor(std::size_t begin, std::size_t end, ThreadPool::RangeJob& body, std::size_t grain)
+    {
+        if (end <= begin)
+            return;
+
+        if (grain == 0)
+            grain = std::max<std::size_t>(1, (end - begin) / ((_size + 1) * 4));
+
+        SmartPtr<ParallelFor> parallelFor(new ParallelFor(body, begin, end, grain));
+
+        // the calling thread takes chunks as well, so we need helpers just
+        // for the remaining chunks
+        if (_state == Running)
+        {
+            std::size_t helpers = std::min<std::size_t>(parallelFor->chunks() - 1, _size);
+            std::vector<ThreadPool::Job*> jobs;
+            jobs.reserve(helpers);
+            for (std::size_t n = 0; n < helpers; ++n)
+                jobs.push_back(new ParallelForJob(parallelFor.getPointer()));
+            scheduleBatch(jobs);
+        }
+
+        parallelFor->work();
+        parallelFor->wait();
+    }
+
+    bool ThreadPoolImpl::takeJob(Worker& worker, ThreadPool::Future& future)
+    {
+        if (atomicGet(_pending) == 0)
+            return false;
+
+        // try our own queue first and then the queues of the other threads
+        std::size_t count = _workers.size();
+        for (std::size_t n = 0; n < count; ++n)
+        {
+            Worker& w = *_workers[(worker.index + n) % count];
+            MutexLock lock(w.mutex);
+            if (!w.jobs.empty())
             {
-                (*future._impl->_callable)();
-                future._impl->setFinished();
+                future = w.jobs.front();
+                w.jobs.pop_front();
+                atomicDecrement(_pending);
+                return true;
             }
-            catch (...)
+        }
+
+        return false;
+    }
+
+    void ThreadPoolImpl::runJob(ThreadPool::Future& future)
+    {
+        ThreadPool::Future::FutureImpl* impl = future._impl;
+        impl->setRunning();
+
+        try
+        {
+            impl->_job->run();
+            impl->setFinished();
+        }
+        catch (...)
+        {
+            impl->_job->fail();
+            impl->setFailed();
+        }
+    }
+
+    void ThreadPoolImpl::threadFunc(Worker& worker)
+    {
+        currentWorker = &worker;
+
+        ThreadPool::Future future;
+        while (true)
+        {
+            if (takeJob(worker, future))
             {
-                future._impl->setFailed();
+                runJob(future);
+                future = ThreadPool::Future();
+                continue;
             }
 
-            log_debug("task " << static_cast<void*>(future._impl->_callable) << " finished");
+            MutexLock lock(_idleMutex);
+
+            // schedule checks the sleeping threads after adding the job, so
+            // either it wakes us or we see the job
+            atomicIncrement(_sleeping);
+            while (atomicGet(_pending) == 0 && _state != Stopping)
+                _jobAvailable.wait(lock);
+            atomicDecrement(_sleeping);
+
+            if (atomicGet(_pending) == 0 && _state == Stopping)
+                break;
         }
 
+        currentWorker = 0;
+
         log_debug("end thread");
     }
 
@@ -29,13 +29,20 @@
 #ifndef CXXTOOLS_THREADPOOLIMPL_H
 #define CXXTOOLS_THREADPOOLIMPL_H
 
-#include <cxxtools/queue.h>
 #include <cxxtools/threadpool.h>
 #include <cxxtools/refcounted.h>
+#include <cxxtools/atomicity.h>
+#include <cxxtools/condition.h>
+#include <cxxtools/mutex.h>
+#include <cxxtools/thread.h>
 #include <vector>
+#include <deque>
 
 namespace cxxtools
 {
+    // The state is an atomic. Threads waiting for a future sleep on a
+    // condition shared with other futures, so that a future does not need
+    // a mutex and a condition of its own.
     class ThreadPool::Future::FutureImpl : public AtomicRefCounted
     {
             friend class ThreadPoolImpl;
@@ -50,32 +57,35 @@ namespace cxxtools
             };
 
         private:
-            Callable<void>* _callable;
-            State _state;
-            mutable Condition _stateChanged;
-            mutable Mutex _mutex;
+            ThreadPool::Job* _job;
+            mutable volatile atomic_t _state;
+            mutable volatile atomic_t _waiters;
 
             FutureImpl(FutureImpl&);
             FutureImpl& operator=(FutureImpl&);
 
+            static bool isFinal(State state)
+            { return state == Finished || state == Canceled || state == Failed; }
+
         public:
-            explicit FutureImpl(const Callable<void>& callable)
-                : _callable(callable.clone()),
-                  _state(Waiting)
+            explicit FutureImpl(ThreadPool::Job* job)
+                : _job(job),
+                  _state(Waiting),
+                  _waiters(0)
                   { }
             ~FutureImpl()
-            { delete _callable; }
+            { delete _job; }
 
             State state() const
-            {
-                MutexLock lock(_mutex);
-                return _state;
-            }
+            { return static_cast<State>(atomicGet(_state)); }
 
             bool wait(Timespan timeout) const;
 
             void setState(State state);
 
+            void setRunning()
+            { atomicSet(_state, Running); }
+
             void setFinished()
             { setState(Finished); }
 
@@ -89,10 +99,7 @@ namespace cxxtools
     class ThreadPoolImpl
     {
         public:
-            explicit ThreadPoolImpl(unsigned size)
-                : _state(Stopped),
-                  _size(size)
-                  { }
+            explicit ThreadPoolImpl(unsigned size);
 
             ~ThreadPoolImpl();
 
@@ -100,7 +107,11 @@ namespace cxxtools
 
             void stop(bool cancel);
 
-            ThreadPool::Future schedule(const Callable<void>& cb);
+            ThreadPool::Future schedule(ThreadPool::Job* job);
+
+            std::vector<ThreadPool::Future> scheduleBatch(const std::vector<ThreadPool::Job*>& jobs);
+
+            void parallelFor(std::size_t begin, std::size_t end, ThreadPool::RangeJob& body, std::size_t grain);
 
             bool running() const
             { return _state == Running; }
@@ -109,7 +120,31 @@ namespace cxxtools
             { return _state == Stopped; }
 
         private:
-            void threadFunc();
+            // Each thread has its own queue. Other threads take jobs from
+            // it, when their own queue is empty.
+            struct Worker
+            {
+                ThreadPoolImpl* pool;
+                unsigned index;
+                Mutex mutex;
+                std::deque<ThreadPool::Future> jobs;
+                AttachedThread* thread;
+
+                Worker(ThreadPoolImpl* pool_, unsigned index_)
+                    : pool(pool_),
+                      index(index_),
+                      thread(0)
+                      { }
+
+                void run()
+                { pool->threadFunc(*this); }
+            };
+
+            void threadFunc(Worker& worker);
+            bool takeJob(Worker& worker, ThreadPool::Future& future);
+            void runJob(ThreadPool::Future& future);
+            void wakeWorkers(unsigned count);
+            void cancelJobs();
 
             enum {
                 Stopped,
@@ -118,10 +153,15 @@ namespace cxxtools
                 Stopping
             } _state;
 
-            Queue<ThreadPool::Future> _queue;
-            typedef std::vector<AttachedThread*> ThreadsType;
-            ThreadsType _threads;
+            typedef std::vector<Worker*> WorkersType;
+            WorkersType _workers;
             unsigned _size;
+
+            volatile atomic_t _pending;   // number of jobs in the queues
+            volatile atomic_t _sleeping;  // number of threads waiting for jobs
+            volatile atomic_t _next;      // round robin counter for jobs from outside
+            Mutex _idleMutex;
+            Condition _jobAvailable;
     };
 
 }
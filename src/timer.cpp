@@ -28,6 +28,7 @@
 #include "cxxtools/selector.h"
 #include "cxxtools/datetime.h"
 #include <stdexcept>
+#include <time.h>
 
 namespace cxxtools
 {
@@ -67,6 +68,7 @@ Timer::Timer(SelectorBase* selector)
 , _selector(0)
 , _active(false)
 , _finished(0)
+, _heapIndex(NoHeapIndex)
 {
     if (selector)
         setSelector(selector);
@@ -263,6 +265,13 @@ bool Timer::update(const Milliseconds& now)
         }
     }
 
+    if( ! sentry )
+        return hasElapsed;
+
+    // reposition the timer since _finished was moved forward
+    if (hasElapsed && _active && _selector)
+        _selector->onTimerChanged(*this);
+
     return hasElapsed;
 }
 
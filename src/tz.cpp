@@ -33,8 +33,10 @@
 #include <cxxtools/smartptr.h>
 #include <cxxtools/systemerror.h>
 
+#include <algorithm>
 #include <iostream>
 #include <fstream>
+#include <limits>
 #include <vector>
 #include <map>
 
@@ -188,6 +190,43 @@ class Tz::Impl : public RefCounted
     const char* abbreviation(int index) const
     { return abbreviations.data() + index; }
 
+    // compares a time with the transition time of a Transition or LeapInfo
+    struct TimeLess
+    {
+        template <typename T>
+        bool operator() (time_t t, const T& v) const
+        { return t < v.transitionTime; }
+
+        template <typename T>
+        bool operator() (const T& v, time_t t) const
+        { return v.transitionTime < t; }
+    };
+
+    // A period of UTC times [begin, end) with the same offset and leap seconds.
+    struct Range
+    {
+        const Impl* impl;
+        time_t begin;
+        time_t end;
+        int32_t gmtoff;
+        bool isdst;
+        int abbreviationIndex;
+        uint32_t leapSeconds;
+    };
+
+    // Returns the index of the last transition at or before t or 0.
+    unsigned transitionIndex(time_t t) const
+    {
+        std::vector<Transition>::const_iterator it =
+            std::upper_bound(transitions.begin(), transitions.end(), t, TimeLess());
+        return it == transitions.begin() ? 0 : it - transitions.begin() - 1;
+    }
+
+    const Range& range(time_t t) const;
+
+    // Returns the offset of the transition range, which contains the local time t.
+    int32_t localOffset(time_t t, const LocalDateTime& dt, bool throwAmbiguous, bool early) const;
+
 public:
     explicit Impl(std::istream& in, const std::string& name);
 
@@ -276,6 +315,117 @@ void Tz::Impl::dump(std::ostream& out) const
     }
 }
 
+// Consecutive conversions mostly fall into the same period, so the last
+// period found is kept per thread and checked before searching.
+const Tz::Impl::Range& Tz::Impl::range(time_t t) const
+{
+    static thread_local Range cache = { 0, 0, 0, 0, false, 0, 0 };
+
+    if (cache.impl == this && cache.begin <= t && t < cache.end)
+        return cache;
+
+    cache.impl = this;
+    cache.begin = std::numeric_limits<time_t>::min();
+    cache.end = std::numeric_limits<time_t>::max();
+
+    std::vector<Transition>::const_iterator it =
+        std::upper_bound(transitions.begin(), transitions.end(), t, TimeLess());
+
+    uint8_t ttIndex = 0;
+    if (it != transitions.begin())
+    {
+        ttIndex = (it - 1)->ttIndex;
+        cache.begin = (it - 1)->transitionTime;
+    }
+
+    if (it != transitions.end())
+        cache.end = it->transitionTime;
+
+    const TtInfo& tt = ttInfos[ttIndex];
+    cache.gmtoff = tt.gmtoff;
+    cache.isdst = tt.isdst;
+    cache.abbreviationIndex = tt.abbreviationIndex;
+
+    std::vector<LeapInfo>::const_iterator lit =
+        std::upper_bound(leapInfos.begin(), leapInfos.end(), t, TimeLess());
+
+    cache.leapSeconds = 0;
+    if (lit != leapInfos.begin())
+    {
+        cache.leapSeconds = (lit - 1)->corrections;
+        cache.begin = std::max(cache.begin, (lit - 1)->transitionTime);
+    }
+
+    if (lit != leapInfos.end())
+        cache.end = std::min(cache.end, lit->transitionTime);
+
+    return cache;
+}
+
+static std::string timeT2s(time_t t)
+{
+    return cxxtools::DateTime::fromMSecsSinceEpoch(cxxtools::Seconds(t)).toString();
+}
+
+int32_t Tz::Impl::localOffset(time_t t, const LocalDateTime& dt, bool throwAmbiguous, bool early) const
+{
+    if (transitions.empty())
+        return ttInfos[0].gmtoff;
+
+    // Find the first transition range i, which ends after the local time
+    // measured with its own offset. The end of the ranges in local time
+    // grows with i, so it can be searched with bisection.
+    unsigned lo = 0;
+    unsigned hi = transitions.size() - 1;
+    while (lo < hi)
+    {
+        unsigned mid = lo + (hi - lo) / 2;
+        const TtInfo& tt = ttInfos[transitions[mid].ttIndex];
+        if (transitions[mid + 1].transitionTime > t - tt.gmtoff)
+            hi = mid;
+        else
+            lo = mid + 1;
+    }
+
+    // step back over ranges, which are not ordered in local time
+    while (lo > 0 && transitions[lo].transitionTime > t - ttInfos[transitions[lo - 1].ttIndex].gmtoff)
+        --lo;
+
+    unsigned i = lo;
+    const TtInfo& tt = ttInfos[transitions[i].ttIndex];
+
+    if (i + 1 == transitions.size())
+        return tt.gmtoff;
+
+    // This is the first transition range, which is still valid.
+
+    log_debug(i << " transitionTime: " << timeT2s(transitions[i + 1].transitionTime) << ' ' << (tt.isdst ? "dst" : "nodst"));
+
+    if (transitions[i].transitionTime > t - tt.gmtoff)
+        throw TzInvalidLocalTime(dt);
+
+    if (!throwAmbiguous && early)
+    {
+        log_debug("take earliest; gmtoff=" << tt.gmtoff);
+        return tt.gmtoff;
+    }
+
+    const TtInfo& tt2 = ttInfos[transitions[i + 1].ttIndex];
+
+    // Check whether the next range is already valid
+    log_debug(timeT2s(transitions[i + 1].transitionTime) << ", " << timeT2s(t) << ", " << tt2.gmtoff << ", " << timeT2s(t - tt2.gmtoff));
+    if (transitions[i + 1].transitionTime <= t - tt2.gmtoff)
+    {
+        log_debug("next transition is also valid; gmtoff=" << tt2.gmtoff);
+        if (throwAmbiguous)
+            throw TzAmbiguousLocalTime(dt);
+        return tt2.gmtoff;
+    }
+
+    log_debug("next transition is not valid; gmtoff=" << tt.gmtoff);
+    return tt.gmtoff;
+}
+
 ////////////////////////////////////////////////////////////////////////
 // class Tz
 //
@@ -333,35 +483,19 @@ TzDateTime Tz::toLocal(const UtcDateTime& dt) const
 {
     time_t t = static_cast<time_t>(dt.msecsSinceEpoch().totalSeconds());
 
-    uint8_t ttIndex = 0;
-    for (unsigned i = 0; i < _impl->transitions.size(); ++i)
-    {
-        if (_impl->transitions[i].transitionTime > t)
-            break;
-        ttIndex = _impl->transitions[i].ttIndex;
-    }
-
-    const auto& tt = _impl->ttInfos[ttIndex];
+    const Impl::Range& r = _impl->range(t);
+    cxxtools::Timespan gmtoff = cxxtools::Seconds(r.gmtoff);
 
-    std::string tzName = _impl->abbreviations.data() + tt.abbreviationIndex;
-    cxxtools::Timespan gmtoff = cxxtools::Seconds(tt.gmtoff);
-    bool isdst = tt.isdst;
-
-    uint32_t leapSeconds = 0;
-    for (unsigned i = 0; i < _impl->leapInfos.size(); ++i)
-    {
-        if (_impl->leapInfos[i].transitionTime > t)
-            break;
-
-        leapSeconds = _impl->leapInfos[i].corrections;
-    }
-
-    return TzDateTime(dt + gmtoff, tzName, gmtoff, isdst, leapSeconds);
+    return TzDateTime(dt + gmtoff, _impl->abbreviation(r.abbreviationIndex), gmtoff, r.isdst, r.leapSeconds);
 }
 
-static std::string timeT2s(time_t t)
+void Tz::toLocal(const UtcDateTime* utc, LocalDateTime* local, std::size_t count) const
 {
-    return cxxtools::DateTime::fromMSecsSinceEpoch(cxxtools::Seconds(t)).toString();
+    for (std::size_t n = 0; n < count; ++n)
+    {
+        time_t t = static_cast<time_t>(utc[n].msecsSinceEpoch().totalSeconds());
+        local[n] = LocalDateTime(utc[n] + cxxtools::Seconds(_impl->range(t).gmtoff));
+    }
 }
 
 UtcDateTime Tz::toUtc(const LocalDateTime& dt) const
@@ -369,36 +503,7 @@ UtcDateTime Tz::toUtc(const LocalDateTime& dt) const
     log_debug("toUtc(" << dt.toString() << ')');
 
     time_t t = static_cast<time_t>(dt.msecsSinceEpoch().totalSeconds());
-    unsigned i;
-    for (i = 0; i < _impl->transitions.size() - 1; ++i)
-    {
-        const auto& tt = _impl->ttInfos[_impl->transitions[i].ttIndex];
-        if (_impl->transitions[i + 1].transitionTime > t - tt.gmtoff)
-        {
-            // This is the first transition range, which is still valid.
-
-            log_debug(i << " transitionTime: " << timeT2s(_impl->transitions[i + 1].transitionTime) << ' ' << (tt.isdst ? "dst" : "nodst"));
-
-            if (_impl->transitions[i].transitionTime > t - tt.gmtoff)
-                throw TzInvalidLocalTime(dt);
-
-            const auto& tt2 = _impl->ttInfos[_impl->transitions[i + 1].ttIndex];
-
-            // Check whether the next range is already valid
-            log_debug(timeT2s(_impl->transitions[i + 1].transitionTime) << ", " << timeT2s(t) << ", " << tt2.gmtoff << ", " << timeT2s(t - tt2.gmtoff));
-            if (_impl->transitions[i + 1].transitionTime <= t - tt2.gmtoff)
-            {
-                log_debug("next transition is also valid; gmtoff=" << tt2.gmtoff);
-                throw TzAmbiguousLocalTime(dt);
-            }
-
-            log_debug("next transition is not valid; gmtoff=" << tt.gmtoff);
-            return UtcDateTime(dt - cxxtools::Seconds(tt.gmtoff));
-        }
-    }
-
-    const auto& tt = _impl->ttInfos[_impl->transitions[i].ttIndex];
-    return UtcDateTime(dt - cxxtools::Seconds(tt.gmtoff));
+    return UtcDateTime(dt - cxxtools::Seconds(_impl->localOffset(t, dt, true, true)));
 }
 
 UtcDateTime Tz::toUtc(const LocalDateTime& dt, bool early) const
@@ -406,44 +511,7 @@ UtcDateTime Tz::toUtc(const LocalDateTime& dt, bool early) const
     log_debug("toUtc(" << dt.toString() << ", " << early << ')');
 
     time_t t = static_cast<time_t>(dt.msecsSinceEpoch().totalSeconds());
-    unsigned i;
-    for (i = 0; i < _impl->transitions.size() - 1; ++i)
-    {
-        const auto& tt = _impl->ttInfos[_impl->transitions[i].ttIndex];
-        if (_impl->transitions[i + 1].transitionTime > t - tt.gmtoff)
-        {
-            // This is the first transition range, which is still valid.
-
-            log_debug(i << " transitionTime: " << timeT2s(_impl->transitions[i + 1].transitionTime) << ' ' << (tt.isdst ? "dst" : "nodst"));
-
-            if (_impl->transitions[i].transitionTime > t - tt.gmtoff)
-                throw TzInvalidLocalTime(dt);
-
-            if (early)
-            {
-                log_debug("take earliest; gmtoff=" << tt.gmtoff);
-                return UtcDateTime(dt - cxxtools::Seconds(tt.gmtoff));
-            }
-
-            const auto& tt2 = _impl->ttInfos[_impl->transitions[i + 1].ttIndex];
-
-            // Check whether the next range is already valid
-            log_debug(timeT2s(_impl->transitions[i + 1].transitionTime) << ", " << timeT2s(t) << ", " << tt2.gmtoff << ", " << timeT2s(t - tt2.gmtoff));
-            if (_impl->transitions[i + 1].transitionTime <= t - tt2.gmtoff)
-            {
-                log_debug("next transition is also valid; gmtoff=" << tt2.gmtoff);
-                return UtcDateTime(dt - cxxtools::Seconds(tt2.gmtoff));
-            }
-            else
-            {
-                log_debug("next transition is not valid; gmtoff=" << tt.gmtoff);
-                return UtcDateTime(dt - cxxtools::Seconds(tt.gmtoff));
-            }
-        }
-    }
-
-    const auto& tt = _impl->ttInfos[_impl->transitions[i].ttIndex];
-    return UtcDateTime(dt - cxxtools::Seconds(tt.gmtoff));
+    return UtcDateTime(dt - cxxtools::Seconds(_impl->localOffset(t, dt, false, early)));
 }
 
 UtcDateTime Tz::previousChange(const cxxtools::DateTime& dt, bool local) const
@@ -451,13 +519,11 @@ UtcDateTime Tz::previousChange(const cxxtools::DateTime& dt, bool local) const
     log_debug("previousChange(" << dt.toString() << ')');
 
     time_t t = static_cast<time_t>(dt.msecsSinceEpoch().totalSeconds());
-    for (unsigned i = 0; i < _impl->transitions.size() - 1; ++i)
+    unsigned i = _impl->transitionIndex(t);
+    if (i + 1 < _impl->transitions.size())
     {
-        if (_impl->transitions[i + 1].transitionTime > t)
-        {
-            int32_t gmtoff = local ? _impl->ttInfos[_impl->transitions[i].ttIndex].gmtoff : 0;
-            return UtcDateTime(cxxtools::DateTime::fromMSecsSinceEpoch(cxxtools::Seconds(_impl->transitions[i].transitionTime + gmtoff)));
-        }
+        int32_t gmtoff = local ? _impl->ttInfos[_impl->transitions[i].ttIndex].gmtoff : 0;
+        return UtcDateTime(cxxtools::DateTime::fromMSecsSinceEpoch(cxxtools::Seconds(_impl->transitions[i].transitionTime + gmtoff)));
     }
 
     return UtcDateTime(0, 1, 1, 0, 0, 0);
@@ -468,13 +534,11 @@ UtcDateTime Tz::nextChange(const cxxtools::DateTime& dt, bool local) const
     log_debug("nextChange(" << dt.toString() << ')');
 
     time_t t = static_cast<time_t>(dt.msecsSinceEpoch().totalSeconds());
-    for (unsigned i = 0; i < _impl->transitions.size() - 1; ++i)
+    unsigned i = _impl->transitionIndex(t);
+    if (i + 1 < _impl->transitions.size())
     {
-        if (_impl->transitions[i + 1].transitionTime > t)
-        {
-            int32_t gmtoff = local ? _impl->ttInfos[_impl->transitions[i].ttIndex].gmtoff : 0;
-            return UtcDateTime(cxxtools::DateTime::fromMSecsSinceEpoch(cxxtools::Seconds(_impl->transitions[i + 1].transitionTime + gmtoff)));
-        }
+        int32_t gmtoff = local ? _impl->ttInfos[_impl->transitions[i].ttIndex].gmtoff : 0;
+        return UtcDateTime(cxxtools::DateTime::fromMSecsSinceEpoch(cxxtools::Seconds(_impl->transitions[i + 1].transitionTime + gmtoff)));
     }
 
     return UtcDateTime(9999, 12, 31, 23, 59, 59, 999, 999);
@@ -483,17 +547,7 @@ UtcDateTime Tz::nextChange(const cxxtools::DateTime& dt, bool local) const
 cxxtools::Timespan Tz::offset(const UtcDateTime& gmtDt) const
 {
     time_t t = static_cast<time_t>(gmtDt.msecsSinceEpoch().totalSeconds());
-
-    uint8_t ttIndex = 0;
-    for (unsigned i = 0; i < _impl->transitions.size(); ++i)
-    {
-        if (_impl->transitions[i].transitionTime > t)
-            break;
-        ttIndex = _impl->transitions[i].ttIndex;
-    }
-
-    const auto& tt = _impl->ttInfos[ttIndex];
-    return cxxtools::Seconds(tt.gmtoff);
+    return cxxtools::Seconds(_impl->range(t).gmtoff);
 }
 
 std::string Tz::currentZone()
@@ -28,6 +28,10 @@
 #include "cxxtools/utf8codec.h"
 #include <cstring>
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 #define byteMask 0xBF
 #define byteMark 0x80
 
@@ -157,6 +161,141 @@ namespace
         else
             return fromBegin[n - s.n];
     }
+
+    // Converts a complete and valid sequence directly from the input.
+    // Returns false, if the sequence is incomplete or illegal.
+    inline bool decodeChar(const uint8_t*& f, const uint8_t* fend, Char*& t)
+    {
+        if (*f < 0x80)
+        {
+            *t++ = Char(*f++);
+            return true;
+        }
+
+        const unsigned extraBytesToRead = trailingBytesForUTF8[*f];
+        if (f + extraBytesToRead >= fend || !isLegalUTF8(f, extraBytesToRead + 1))
+            return false;
+
+        // legal sequences have at most 3 trailing bytes
+        Char::value_type ch = 0;
+        switch (extraBytesToRead)
+        {
+            case 3: ch += *f++; ch <<= 6;
+                    // fallthrough
+            case 2: ch += *f++; ch <<= 6;
+                    // fallthrough
+            case 1: ch += *f++; ch <<= 6;
+                    // fallthrough
+            case 0: ch += *f++;
+        }
+
+        ch -= offsetsFromUTF8[extraBytesToRead];
+
+        // UTF-16 surrogate values are illegal in UTF-32, and anything
+        // over Plane 17 (> 0x10FFFF) is illegal.
+        if (ch > MaxLegalUtf32.value()
+            || (ch >= SurHighStart.value() && ch <= SurLowEnd.value()))
+            *t++ = ReplacementChar;
+        else
+            *t++ = Char(ch);
+
+        return true;
+    }
+
+    // Converts input as long as the sequences are complete and valid without
+    // going through the state buffer. The rest is left to the caller, which
+    // processes it byte by byte.
+    void decodeRun(const char*& fromNext, const char* fromEnd, Char*& toNext, Char* toEnd)
+    {
+        const uint8_t* f = reinterpret_cast<const uint8_t*>(fromNext);
+        const uint8_t* fend = reinterpret_cast<const uint8_t*>(fromEnd);
+        Char* t = toNext;
+
+        bool ok = true;
+        while (ok && f < fend && t < toEnd)
+        {
+            const uint8_t* blockEnd = fend;
+
+#ifdef __SSE2__
+            // widen blocks of 16 ascii characters
+            if (sizeof(Char) == 4)
+            {
+                const __m128i zero = _mm_setzero_si128();
+                while (fend - f >= 16 && toEnd - t >= 16)
+                {
+                    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(f));
+                    if (_mm_movemask_epi8(v) != 0)
+                        break;
+
+                    __m128i lo = _mm_unpacklo_epi8(v, zero);
+                    __m128i hi = _mm_unpackhi_epi8(v, zero);
+                    __m128i* out = reinterpret_cast<__m128i*>(t);
+                    _mm_storeu_si128(out, _mm_unpacklo_epi16(lo, zero));
+                    _mm_storeu_si128(out + 1, _mm_unpackhi_epi16(lo, zero));
+                    _mm_storeu_si128(out + 2, _mm_unpacklo_epi16(hi, zero));
+                    _mm_storeu_si128(out + 3, _mm_unpackhi_epi16(hi, zero));
+                    f += 16;
+                    t += 16;
+                }
+
+                // decode the block with non ascii characters one by one
+                if (fend - f > 16)
+                    blockEnd = f + 16;
+            }
+#endif
+
+            while (f < blockEnd && t < toEnd)
+            {
+                if (!decodeChar(f, fend, t))
+                {
+                    ok = false;
+                    break;
+                }
+            }
+        }
+
+        fromNext = reinterpret_cast<const char*>(f);
+        toNext = t;
+    }
+
+    // Converts characters from the input as long as they are ascii.
+    void encodeAscii(const Char*& fromNext, const Char* fromEnd, char*& toNext, char* toEnd)
+    {
+        const Char* f = fromNext;
+        char* t = toNext;
+
+#ifdef __SSE2__
+        // narrow blocks of 16 characters; like the generic code we never
+        // fill the output completely
+        if (sizeof(Char) == 4)
+        {
+            const __m128i nonAscii = _mm_set1_epi32(~0x7f);
+            const __m128i zero = _mm_setzero_si128();
+            while (fromEnd - f >= 16 && toEnd - t > 16)
+            {
+                const __m128i* in = reinterpret_cast<const __m128i*>(f);
+                __m128i a = _mm_loadu_si128(in);
+                __m128i b = _mm_loadu_si128(in + 1);
+                __m128i c = _mm_loadu_si128(in + 2);
+                __m128i d = _mm_loadu_si128(in + 3);
+                __m128i all = _mm_or_si128(_mm_or_si128(a, b), _mm_or_si128(c, d));
+                if (_mm_movemask_epi8(_mm_cmpeq_epi32(_mm_and_si128(all, nonAscii), zero)) != 0xffff)
+                    break;
+
+                __m128i v = _mm_packus_epi16(_mm_packs_epi32(a, b), _mm_packs_epi32(c, d));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(t), v);
+                f += 16;
+                t += 16;
+            }
+        }
+#endif
+
+        while (f < fromEnd && t + 1 < toEnd && f->value() >= 0 && f->value() < 0x80)
+            *t++ = static_cast<char>((f++)->value());
+
+        fromNext = f;
+        toNext = t;
+    }
 }
 
 
@@ -203,6 +342,13 @@ Utf8Codec::result Utf8Codec::do_in(MBState& s, const char* fromBegin, const char
 
     while (fromNext < fromEnd)
     {
+        if (s.n == 0)
+        {
+            decodeRun(fromNext, fromEnd, toNext, toEnd);
+            if (fromNext >= fromEnd)
+                break;
+        }
+
         if (toNext >= toEnd)
         {
             retstat = partial;
@@ -274,6 +420,10 @@ Utf8Codec::result Utf8Codec::do_out(MBState& /*s*/, const Char* fromBegin, const
 
     while(fromNext < fromEnd)
     {
+        encodeAscii(fromNext, fromEnd, toNext, toEnd);
+        if (fromNext >= fromEnd)
+            break;
+
         ch = *fromNext;
         if (ch >= SurHighStart && ch <= SurLowEnd)
         {
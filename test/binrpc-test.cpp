@@ -89,6 +89,7 @@ class BinRpcTest : public cxxtools::unit::TestSuite
             registerMethod("PrepareConnect", *this, &BinRpcTest::PrepareConnect);
             registerMethod("Connect", *this, &BinRpcTest::Connect);
             registerMethod("Multiple", *this, &BinRpcTest::Multiple);
+            registerMethod("KeepDictionary", *this, &BinRpcTest::KeepDictionary);
 
             char* PORT = getenv("UTEST_PORT");
             if (PORT)
@@ -804,6 +805,63 @@ class BinRpcTest : public cxxtools::unit::TestSuite
 
         }
 
+        ////////////////////////////////////////////////////////////
+        // KeepDictionary
+        //
+        void KeepDictionary()
+        {
+            _server->registerMethod("multiply", *this, &BinRpcTest::multiplyColor);
+            _server->registerMethod("fault", *this, &BinRpcTest::throwFault);
+
+            cxxtools::bin::RpcClient client(_loop, _listen, _port);
+            client.keepDictionary(true);
+            CXXTOOLS_UNIT_ASSERT(client.keepDictionary());
+
+            cxxtools::RemoteProcedure< Color, Color, Color > multiply(client, "multiply");
+            cxxtools::RemoteProcedure<bool> fault(client, "fault");
+
+            Color a;
+            a.red = 2;
+            a.green = 3;
+            a.blue = 4;
+
+            for (int n = 1; n <= 4; ++n)
+            {
+                Color b;
+                b.red = n;
+                b.green = n + 1;
+                b.blue = n + 2;
+
+                Color r;
+                if (n % 2)
+                {
+                    multiply.begin(a, b);
+                    r = multiply.end(2000);
+                }
+                else
+                    r = multiply.call(a, b);
+
+                CXXTOOLS_UNIT_ASSERT_EQUALS(r.red, 2 * n);
+                CXXTOOLS_UNIT_ASSERT_EQUALS(r.green, 3 * (n + 1));
+                CXXTOOLS_UNIT_ASSERT_EQUALS(r.blue, 4 * (n + 2));
+
+                // an error reply resets the dictionary of the replies
+                if (n == 2)
+                {
+                    fault.begin();
+                    CXXTOOLS_UNIT_ASSERT_THROW(fault.end(2000), cxxtools::RemoteException);
+                }
+            }
+
+            // switching back closes the connection, so that the server starts over too
+            client.keepDictionary(false);
+            multiply.begin(a, a);
+            Color r = multiply.end(2000);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(r.red, 4);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(r.green, 9);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(r.blue, 16);
+        }
+
 };
 
 cxxtools::unit::RegisterTest<BinRpcTest> register_BinRpcTest;
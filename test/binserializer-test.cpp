@@ -36,6 +36,7 @@
 #include "cxxtools/datetime.h"
 #include "cxxtools/timespan.h"
 #include "cxxtools/hexdump.h"
+#include "cxxtools/convert.h"
 #include <limits>
 #include <stdint.h>
 #include <config.h>
@@ -153,6 +154,7 @@ class BinSerializerTest : public cxxtools::unit::TestSuite
             registerMethod("testBinaryData", *this, &BinSerializerTest::testBinaryData);
             registerMethod("testReuse", *this, &BinSerializerTest::testReuse);
             registerMethod("testNamedVector", *this, &BinSerializerTest::testNamedVector);
+            registerMethod("testManyNames", *this, &BinSerializerTest::testManyNames);
             registerMethod("testDate", *this, &BinSerializerTest::testDate);
             registerMethod("testTime", *this, &BinSerializerTest::testTime);
             registerMethod("testDatetime", *this, &BinSerializerTest::testDatetime);
@@ -458,6 +460,7 @@ class BinSerializerTest : public cxxtools::unit::TestSuite
 
         void testReuse();
         void testNamedVector();
+        void testManyNames();
 
         void testDate()
         {
@@ -607,3 +610,41 @@ void BinSerializerTest::testNamedVector()
 }
 
 cxxtools::unit::RegisterTest<BinSerializerTest> register_BinSerializerTest;
+
+void BinSerializerTest::testManyNames()
+{
+    // more names than fit into the dictionary; the second object uses
+    // dictionary references for the first 0x10000 names only
+    const unsigned N = 0x10000 + 100;
+
+    cxxtools::SerializationInfo si;
+    si.setCategory(cxxtools::SerializationInfo::Array);
+    for (unsigned o = 0; o < 2; ++o)
+    {
+        cxxtools::SerializationInfo& obj = si.addMember();
+        for (unsigned n = 0; n < N; ++n)
+            obj.addMember("m" + cxxtools::convert<std::string>(n)) <<= n + o;
+    }
+
+    std::stringstream data;
+    data << cxxtools::bin::Bin(si);
+
+    cxxtools::SerializationInfo si2;
+    data >> cxxtools::bin::Bin(si2);
+
+    CXXTOOLS_UNIT_ASSERT_EQUALS(si2.memberCount(), 2);
+    for (unsigned o = 0; o < 2; ++o)
+    {
+        const cxxtools::SerializationInfo& obj = si2.getMember(o);
+        CXXTOOLS_UNIT_ASSERT_EQUALS(obj.memberCount(), N);
+
+        unsigned n = 0;
+        for (cxxtools::SerializationInfo::ConstIterator it = obj.begin(); it != obj.end(); ++it, ++n)
+        {
+            CXXTOOLS_UNIT_ASSERT_EQUALS(it->name(), "m" + cxxtools::convert<std::string>(n));
+            unsigned v;
+            *it >>= v;
+            CXXTOOLS_UNIT_ASSERT_EQUALS(v, n + o);
+        }
+    }
+}
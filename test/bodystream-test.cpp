@@ -0,0 +1,147 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "cxxtools/http/bodystream.h"
+#include "cxxtools/unit/testsuite.h"
+#include "cxxtools/unit/registertest.h"
+#include <sstream>
+
+class BodyStreamTest : public cxxtools::unit::TestSuite
+{
+    public:
+        BodyStreamTest()
+        : cxxtools::unit::TestSuite("bodystream")
+        {
+            registerMethod("testWriteRead", *this, &BodyStreamTest::testWriteRead);
+            registerMethod("testBlocks", *this, &BodyStreamTest::testBlocks);
+            registerMethod("testReadWhileWriting", *this, &BodyStreamTest::testReadWhileWriting);
+            registerMethod("testStr", *this, &BodyStreamTest::testStr);
+            registerMethod("testClear", *this, &BodyStreamTest::testClear);
+            registerMethod("testSendTo", *this, &BodyStreamTest::testSendTo);
+        }
+
+        void testWriteRead()
+        {
+            cxxtools::http::BodyStream body;
+            body << "hello " << 42;
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(body.size(), 8);
+
+            std::string s;
+            int i;
+            body >> s >> i;
+            CXXTOOLS_UNIT_ASSERT_EQUALS(s, "hello");
+            CXXTOOLS_UNIT_ASSERT_EQUALS(i, 42);
+
+            body >> s;
+            CXXTOOLS_UNIT_ASSERT(body.eof());
+        }
+
+        void testBlocks()
+        {
+            cxxtools::http::BodyStream body;
+
+            std::string data;
+            for (unsigned n = 0; n < 100000; ++n)
+                data += static_cast<char>('a' + n % 26);
+
+            for (unsigned n = 0; n < data.size(); n += 1000)
+                body.write(data.data() + n, 1000);
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(body.size(), data.size());
+            CXXTOOLS_UNIT_ASSERT(body.buffer().blocks() > 1);
+
+            std::size_t total = 0;
+            for (std::size_t n = 0; n < body.buffer().blocks(); ++n)
+                total += body.buffer().blockSize(n);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(total, data.size());
+
+            std::ostringstream out;
+            out << body.rdbuf();
+            CXXTOOLS_UNIT_ASSERT(out.str() == data);
+        }
+
+        void testReadWhileWriting()
+        {
+            cxxtools::http::BodyStream body;
+
+            body << "abc";
+            CXXTOOLS_UNIT_ASSERT_EQUALS(body.get(), 'a');
+            CXXTOOLS_UNIT_ASSERT_EQUALS(body.rdbuf()->in_avail(), 2);
+
+            body << "def";
+            std::string s;
+            body >> s;
+            CXXTOOLS_UNIT_ASSERT_EQUALS(s, "bcdef");
+            CXXTOOLS_UNIT_ASSERT_EQUALS(body.size(), 6);
+        }
+
+        void testStr()
+        {
+            cxxtools::http::BodyStream body;
+            body.str("foo");
+            body << "bar";
+            CXXTOOLS_UNIT_ASSERT_EQUALS(body.str(), "foobar");
+
+            // reading does not remove data like with a std::stringstream
+            std::string s;
+            body >> s;
+            CXXTOOLS_UNIT_ASSERT_EQUALS(body.str(), "foobar");
+        }
+
+        void testClear()
+        {
+            cxxtools::http::BodyStream body;
+            for (unsigned n = 0; n < 10000; ++n)
+                body << "0123456789";
+
+            body.str(std::string());
+            CXXTOOLS_UNIT_ASSERT_EQUALS(body.size(), 0);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(body.buffer().blocks(), 1);
+
+            body << "x";
+            CXXTOOLS_UNIT_ASSERT_EQUALS(body.str(), "x");
+            CXXTOOLS_UNIT_ASSERT_EQUALS(body.get(), 'x');
+        }
+
+        void testSendTo()
+        {
+            cxxtools::http::BodyStream body;
+            std::string data;
+            for (unsigned n = 0; n < 50000; ++n)
+                data += static_cast<char>('0' + n % 10);
+            body << data;
+
+            std::ostringstream out;
+            body.buffer().sendTo(out);
+            CXXTOOLS_UNIT_ASSERT(out.str() == data);
+        }
+
+};
+
+cxxtools::unit::RegisterTest<BodyStreamTest> register_BodyStreamTest;
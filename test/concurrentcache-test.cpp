@@ -0,0 +1,180 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "cxxtools/concurrentcache.h"
+#include "cxxtools/cache.h"
+#include "cxxtools/atomicity.h"
+#include "cxxtools/thread.h"
+#include "cxxtools/unit/testsuite.h"
+#include "cxxtools/unit/registertest.h"
+#include <string>
+#include <vector>
+#include <stdexcept>
+
+class ConcurrentCacheTest : public cxxtools::unit::TestSuite
+{
+        cxxtools::ConcurrentCache<int, std::string>* _cache;
+        volatile cxxtools::atomic_t _created;
+
+    public:
+        ConcurrentCacheTest()
+        : cxxtools::unit::TestSuite("concurrentcache"),
+          _cache(0),
+          _created(0)
+        {
+            registerMethod("putGet", *this, &ConcurrentCacheTest::putGet);
+            registerMethod("maxElements", *this, &ConcurrentCacheTest::maxElements);
+            registerMethod("cacheShards", *this, &ConcurrentCacheTest::cacheShards);
+            registerMethod("getOrCreate", *this, &ConcurrentCacheTest::getOrCreate);
+            registerMethod("createFailed", *this, &ConcurrentCacheTest::createFailed);
+            registerMethod("stampede", *this, &ConcurrentCacheTest::stampede);
+        }
+
+        void putGet()
+        {
+          cxxtools::ConcurrentCache<int, int> cache(100, 4);
+
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cache.shards(), 4);
+
+          for (int n = 0; n < 20; ++n)
+            cache.put(n, n * 10);
+
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cache.size(), 20);
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cache.get(7), 70);
+          CXXTOOLS_UNIT_ASSERT(!cache.getx(20).first);
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cache.get(20, -1), -1);
+
+          CXXTOOLS_UNIT_ASSERT(cache.erase(7));
+          CXXTOOLS_UNIT_ASSERT(!cache.erase(7));
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cache.size(), 19);
+
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cache.getHits(), 1);
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cache.getMisses(), 2);
+
+          cache.clear(true);
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cache.size(), 0);
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cache.getHits(), 0);
+        }
+
+        void maxElements()
+        {
+          cxxtools::ConcurrentCache<int, int> cache(16, 4);
+
+          for (int n = 0; n < 100; ++n)
+            cache.put(n, n);
+
+          CXXTOOLS_UNIT_ASSERT(cache.size() <= 16);
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cache.get(99), 99);
+
+          cache.setMaxElements(4);
+          CXXTOOLS_UNIT_ASSERT(cache.size() <= 4);
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cache.getMaxElements(), 4);
+        }
+
+        void cacheShards()
+        {
+          cxxtools::ConcurrentCache<int, int, cxxtools::Cache<int, int> > cache(32, 2);
+
+          for (int n = 0; n < 100; ++n)
+            cache.put(n, n);
+
+          CXXTOOLS_UNIT_ASSERT(cache.size() <= 32);
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cache.get(99), 99);
+        }
+
+        std::string create(int key)
+        {
+          cxxtools::atomicIncrement(_created);
+          return std::string(key, 'x');
+        }
+
+        static std::string fail(int)
+        {
+          throw std::runtime_error("create failed");
+        }
+
+        void getOrCreate()
+        {
+          cxxtools::ConcurrentCache<int, std::string> cache(100);
+          _created = 0;
+
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cache.getOrCreate(3, cxxtools::callable(*this, &ConcurrentCacheTest::create)), "xxx");
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cache.getOrCreate(3, cxxtools::callable(*this, &ConcurrentCacheTest::create)), "xxx");
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cache.getOrCreate(4, cxxtools::callable(*this, &ConcurrentCacheTest::create)), "xxxx");
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::atomicGet(_created), 2);
+        }
+
+        void createFailed()
+        {
+          cxxtools::ConcurrentCache<int, std::string> cache(100);
+
+          CXXTOOLS_UNIT_ASSERT_THROW(cache.getOrCreate(3, fail), std::runtime_error);
+          CXXTOOLS_UNIT_ASSERT(!cache.getx(3).first);
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cache.getOrCreate(3, cxxtools::callable(*this, &ConcurrentCacheTest::create)), "xxx");
+        }
+
+        std::string slowCreate(int key)
+        {
+          cxxtools::Thread::sleep(cxxtools::Milliseconds(50));
+          return create(key);
+        }
+
+        void getOrCreateThread()
+        {
+          _cache->getOrCreate(5, cxxtools::callable(*this, &ConcurrentCacheTest::slowCreate));
+        }
+
+        void stampede()
+        {
+          cxxtools::ConcurrentCache<int, std::string> cache(100);
+          _cache = &cache;
+          _created = 0;
+
+          std::vector<cxxtools::AttachedThread*> threads;
+          for (unsigned n = 0; n < 8; ++n)
+          {
+            threads.push_back(new cxxtools::AttachedThread(
+                cxxtools::callable(*this, &ConcurrentCacheTest::getOrCreateThread)));
+            threads.back()->start();
+          }
+
+          for (unsigned n = 0; n < threads.size(); ++n)
+          {
+            threads[n]->join();
+            delete threads[n];
+          }
+
+          _cache = 0;
+
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::atomicGet(_created), 1);
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cache.get(5), "xxxxx");
+        }
+
+};
+
+cxxtools::unit::RegisterTest<ConcurrentCacheTest> register_ConcurrentCacheTest;
@@ -0,0 +1,194 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+#include <cxxtools/arg.h>
+#include <cxxtools/clock.h>
+#include <cxxtools/convert.h>
+#include <cxxtools/log.h>
+
+namespace
+{
+    volatile double sink;
+
+    // Formats and parses with the generic iterator based functions, which
+    // were used by convert before.
+    std::string oldFormat(double d)
+    {
+        std::string s;
+        cxxtools::putFloat(std::back_inserter(s), d, cxxtools::FloatFormat<char>(),
+            std::numeric_limits<double>::digits10 - 1);
+        return s;
+    }
+
+    std::string oldFormat(int i)
+    {
+        std::string s;
+        cxxtools::putInt(std::back_inserter(s), i, cxxtools::DecimalFormat<char>());
+        return s;
+    }
+
+    double oldParseDouble(const std::string& s)
+    {
+        bool ok;
+        double d;
+        cxxtools::getFloat(s.begin(), s.end(), ok, d);
+        return d;
+    }
+
+    int oldParseInt(const std::string& s)
+    {
+        bool ok;
+        int i;
+        cxxtools::getInt(s.begin(), s.end(), ok, i);
+        return i;
+    }
+
+    template <typename T>
+    std::string newFormat(T v)
+    {
+        std::string s;
+        cxxtools::putInt(std::back_inserter(s), v);
+        return s;
+    }
+
+    template <>
+    std::string newFormat(double d)
+    {
+        std::string s;
+        cxxtools::putFloat(std::back_inserter(s), d);
+        return s;
+    }
+
+    double newParseDouble(const std::string& s)
+    {
+        return cxxtools::convert<double>(s);
+    }
+
+    int newParseInt(const std::string& s)
+    {
+        return cxxtools::convert<int>(s);
+    }
+
+    template <typename T>
+    void benchFormat(const char* title, const std::vector<T>& values, unsigned N,
+        std::string (*fn)(T))
+    {
+        cxxtools::Clock clock;
+        clock.start();
+
+        std::string::size_type size = 0;
+        for (unsigned n = 0; n < N; ++n)
+            for (typename std::vector<T>::const_iterator it = values.begin(); it != values.end(); ++it)
+                size += fn(*it).size();
+
+        cxxtools::Timespan t = clock.stop();
+        sink = static_cast<double>(size);
+
+        std::cout << title << ": " << t << std::endl;
+    }
+
+    template <typename T>
+    void benchParse(const char* title, const std::vector<std::string>& values, unsigned N,
+        T (*fn)(const std::string&))
+    {
+        cxxtools::Clock clock;
+        clock.start();
+
+        T sum = 0;
+        for (unsigned n = 0; n < N; ++n)
+            for (std::vector<std::string>::const_iterator it = values.begin(); it != values.end(); ++it)
+                sum += fn(*it);
+
+        cxxtools::Timespan t = clock.stop();
+        sink = static_cast<double>(sum);
+
+        std::cout << title << ": " << t << std::endl;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    try
+    {
+        log_init();
+
+        cxxtools::Arg<unsigned> N(argc, argv, 'n', 100);
+        cxxtools::Arg<unsigned> V(argc, argv, 'v', 10000);
+
+        std::cout << "benchmark number conversion with " << V.getValue() << " values and " << N.getValue() << " iterations\n\n"
+                     "options:\n"
+                     "   -n <number>       specify number of iterations\n"
+                     "   -v <number>       specify number of values\n" << std::endl;
+
+        // doubles with full precision and short decimal fractions like prices
+        std::vector<double> doubles;
+        std::vector<double> shortDoubles;
+        std::vector<int> ints;
+        std::vector<std::string> doubleStrings;
+        std::vector<std::string> shortDoubleStrings;
+        std::vector<std::string> intStrings;
+
+        double d = 0.1;
+        int i = 1;
+        for (unsigned n = 0; n < V; ++n)
+        {
+            doubles.push_back(d);
+            ints.push_back(i);
+            doubleStrings.push_back(newFormat(d));
+            shortDoubles.push_back(static_cast<double>(i % 100000) / 100);
+            shortDoubleStrings.push_back(newFormat(shortDoubles.back()));
+            intStrings.push_back(newFormat(i));
+            d = d * 1.37 + 0.25;
+            if (d > 1e9)
+                d = 0.1;
+            i = static_cast<int>((static_cast<unsigned>(i) * 7u + 3u) % 2000000000u);
+        }
+
+        benchFormat<double>("format double (old)", doubles, N, oldFormat);
+        benchFormat<double>("format double (new)", doubles, N, newFormat<double>);
+        benchFormat<double>("format short double (old)", shortDoubles, N, oldFormat);
+        benchFormat<double>("format short double (new)", shortDoubles, N, newFormat<double>);
+        benchFormat<int>("format int (old)", ints, N, oldFormat);
+        benchFormat<int>("format int (new)", ints, N, newFormat<int>);
+        benchParse<double>("parse double (old)", doubleStrings, N, oldParseDouble);
+        benchParse<double>("parse double (new)", doubleStrings, N, newParseDouble);
+        benchParse<double>("parse short double (old)", shortDoubleStrings, N, oldParseDouble);
+        benchParse<double>("parse short double (new)", shortDoubleStrings, N, newParseDouble);
+        benchParse<int>("parse int (old)", intStrings, N, oldParseInt);
+        benchParse<int>("parse int (new)", intStrings, N, newParseInt);
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -57,6 +57,9 @@ class ConvertTest : public cxxtools::unit::TestSuite
             registerMethod("infTest", *this, &ConvertTest::infTest);
             registerMethod("emptyTest", *this, &ConvertTest::emptyTest);
             registerMethod("floatTest", *this, &ConvertTest::floatTest);
+            registerMethod("shortestFloatTest", *this, &ConvertTest::shortestFloatTest);
+            registerMethod("roundtripTest", *this, &ConvertTest::roundtripTest);
+            registerMethod("intLimitsTest", *this, &ConvertTest::intLimitsTest);
         }
 
         void successTest()
@@ -281,6 +284,76 @@ class ConvertTest : public cxxtools::unit::TestSuite
           t(12);
         }
 
+        void shortestFloatTest()
+        {
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::convert<std::string>(0.1), "0.1");
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::convert<std::string>(1.5), "1.5");
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::convert<std::string>(100.0), "100");
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::convert<std::string>(-0.00125), "-0.00125");
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::convert<std::string>(0.0), "0");
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::convert<std::string>(1e21), "1000000000000000000000");
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::convert<std::string>(1.0 / 3), "0.3333333333333333");
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::convert<std::string>(0.1f), "0.1");
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::convert<std::string>(3.14159f), "3.14159");
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::convert<cxxtools::String>(2.75).narrow(), "2.75");
+        }
+
+        void r(double d)
+        {
+          std::string s = cxxtools::convert<std::string>(d);
+          log_debug("d=" << d << " s=\"" << s << '"');
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::convert<double>(s), d);
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::convert<double>(s.c_str()), d);
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::convert<double>(cxxtools::String(s)), d);
+        }
+
+        void roundtripTest()
+        {
+          r(1.0 / 3);
+          r(2.0 / 3);
+          r(0.1 + 0.2);
+          r(123456789.55555555);
+          r(1.7976931348623157e308);
+          r(2.2250738585072014e-308);
+          r(4.9406564584124654e-324);
+          r(-9007199254740993.0);
+          r(5e-324 * 3);
+          r(6.02214076e23);
+
+          float f = 1.0f / 3;
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::convert<float>(cxxtools::convert<std::string>(f)), f);
+
+          f = 16777217.0f;
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::convert<float>(cxxtools::convert<std::string>(f)), f);
+
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::convert<double>("0.30000000000000004441"), 0.1 + 0.2);
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::convert<double>(".5"), 0.5);
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::convert<double>("+5."), 5.0);
+          CXXTOOLS_UNIT_ASSERT_THROW(cxxtools::convert<double>("1.5x"), cxxtools::ConversionError);
+        }
+
+        void intLimitsTest()
+        {
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::convert<std::string>(std::numeric_limits<int>::min()), "-2147483648");
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::convert<std::string>(std::numeric_limits<int>::max()), "2147483647");
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::convert<std::string>(std::numeric_limits<unsigned>::max()), "4294967295");
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::convert<std::string>(0), "0");
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::convert<std::string>(-7), "-7");
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::convert<cxxtools::String>(-42).narrow(), "-42");
+
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::convert<int>("-2147483648"), std::numeric_limits<int>::min());
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::convert<int>(" 2147483647\n"), std::numeric_limits<int>::max());
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::convert<unsigned>("+4294967295"), std::numeric_limits<unsigned>::max());
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::convert<short>(cxxtools::String(L"-32768")), -32768);
+
+          CXXTOOLS_UNIT_ASSERT_THROW(cxxtools::convert<int>("2147483648"), cxxtools::ConversionError);
+          CXXTOOLS_UNIT_ASSERT_THROW(cxxtools::convert<int>("-2147483649"), cxxtools::ConversionError);
+          CXXTOOLS_UNIT_ASSERT_THROW(cxxtools::convert<unsigned>("-1"), cxxtools::ConversionError);
+          CXXTOOLS_UNIT_ASSERT_THROW(cxxtools::convert<unsigned char>("256"), cxxtools::ConversionError);
+          CXXTOOLS_UNIT_ASSERT_THROW(cxxtools::convert<int>("-"), cxxtools::ConversionError);
+          CXXTOOLS_UNIT_ASSERT_THROW(cxxtools::convert<int>("12 3"), cxxtools::ConversionError);
+        }
+
 };
 
 cxxtools::unit::RegisterTest<ConvertTest> register_ConvertTest;
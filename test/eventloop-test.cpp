@@ -31,6 +31,8 @@
 #include "cxxtools/unit/registertest.h"
 #include "cxxtools/event.h"
 #include "cxxtools/eventloop.h"
+#include "cxxtools/thread.h"
+#include <vector>
 
 namespace
 {
@@ -45,10 +47,19 @@ class EventLoopTest : public cxxtools::unit::TestSuite
 {
     cxxtools::EventLoop _loop;
     std::string _events;
+    unsigned _count;
+
+    void commitEvents()
+    {
+        for (unsigned n = 0; n < 1000; ++n)
+            _loop.commitEvent(TestEvent1());
+    }
 
     void onTestEvent1(const TestEvent1&)
     {
         _events += "1";
+        if (++_count == 4000)
+            _loop.exit();
     }
 
     void onTestEvent2(const TestEvent2&)
@@ -62,6 +73,7 @@ public:
     {
         registerMethod("commitEvent", *this, &EventLoopTest::commitEvent);
         registerMethod("priorityEvent", *this, &EventLoopTest::priorityEvent);
+        registerMethod("commitFromThreads", *this, &EventLoopTest::commitFromThreads);
 
         _loop.event.subscribe(slot(*this, &EventLoopTest::onTestEvent1));
         _loop.event.subscribe(slot(*this, &EventLoopTest::onTestEvent2));
@@ -70,6 +82,7 @@ public:
     void setUp()
     {
         _events.clear();
+        _count = 0;
     }
 
     void commitEvent()
@@ -88,6 +101,24 @@ public:
         CXXTOOLS_UNIT_ASSERT_EQUALS(_events, "21");
     }
 
+    void commitFromThreads()
+    {
+        std::vector<cxxtools::AttachedThread*> threads;
+        for (unsigned n = 0; n < 4; ++n)
+        {
+            threads.push_back(new cxxtools::AttachedThread(
+                cxxtools::callable(*this, &EventLoopTest::commitEvents)));
+            threads.back()->start();
+        }
+
+        _loop.run();
+
+        for (unsigned n = 0; n < threads.size(); ++n)
+            delete threads[n];
+
+        CXXTOOLS_UNIT_ASSERT_EQUALS(_count, 4000);
+    }
+
 };
 
 cxxtools::unit::RegisterTest<EventLoopTest> register_EventLoopTest;
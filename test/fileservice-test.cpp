@@ -0,0 +1,246 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "cxxtools/unit/testsuite.h"
+#include "cxxtools/unit/registertest.h"
+#include "cxxtools/http/fileservice.h"
+#include "cxxtools/http/server.h"
+#include "cxxtools/http/client.h"
+#include "cxxtools/http/request.h"
+#include "cxxtools/http/reply.h"
+#include "cxxtools/eventloop.h"
+#include "cxxtools/thread.h"
+#include "cxxtools/regex.h"
+#include <fstream>
+#include <sstream>
+#include <stdlib.h>
+#include <stdio.h>
+
+class FileServiceTest : public cxxtools::unit::TestSuite
+{
+    private:
+        cxxtools::EventLoop _loop;
+        cxxtools::http::Server* _server;
+        cxxtools::http::FileService _service;
+        cxxtools::AttachedThread* _thread;
+        std::string _listen;
+        unsigned short _port;
+        std::string _data;
+
+    public:
+        FileServiceTest()
+        : cxxtools::unit::TestSuite("fileservice"),
+          _service(".", "/files/"),
+          _listen("127.0.0.1"),
+          _port(8001)
+        {
+            registerMethod("testGet", *this, &FileServiceTest::testGet);
+            registerMethod("testRange", *this, &FileServiceTest::testRange);
+            registerMethod("testSuffixRange", *this, &FileServiceTest::testSuffixRange);
+            registerMethod("testUnsatisfiableRange", *this, &FileServiceTest::testUnsatisfiableRange);
+            registerMethod("testIfRange", *this, &FileServiceTest::testIfRange);
+            registerMethod("testNotModified", *this, &FileServiceTest::testNotModified);
+            registerMethod("testNotFound", *this, &FileServiceTest::testNotFound);
+            registerMethod("testMimeType", *this, &FileServiceTest::testMimeType);
+
+            char* PORT = getenv("UTEST_PORT");
+            if (PORT)
+            {
+                std::istringstream s(PORT);
+                s >> _port;
+            }
+
+            char* LISTEN = getenv("UTEST_LISTEN");
+            if (LISTEN)
+                _listen = LISTEN;
+
+            // larger than the socket buffers, so that sendfile does not
+            // write everything at once
+            for (unsigned n = 0; _data.size() < 4000000; ++n)
+                _data += static_cast<char>('a' + n % 26);
+        }
+
+        void setUp()
+        {
+            std::ofstream f("fileservice-test.txt");
+            f << _data;
+            f.close();
+
+            _server = new cxxtools::http::Server(_loop, _listen, _port);
+            _server->addService(cxxtools::Regex("^/files/"), _service);
+
+            _thread = new cxxtools::AttachedThread(cxxtools::callable(_loop, &cxxtools::EventLoop::run));
+            _thread->start();
+        }
+
+        void tearDown()
+        {
+            _loop.exit();
+            delete _thread;
+            delete _server;
+            ::remove("fileservice-test.txt");
+        }
+
+        void testGet()
+        {
+            cxxtools::http::Client client(_listen, _port);
+            const cxxtools::http::Reply& reply = client.get("/files/fileservice-test.txt", 10000);
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reply.httpReturnCode(), 200);
+            CXXTOOLS_UNIT_ASSERT(reply.getHeader("ETag") != 0);
+            CXXTOOLS_UNIT_ASSERT(reply.getHeader("Last-Modified") != 0);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reply.bodySize(), _data.size());
+            CXXTOOLS_UNIT_ASSERT(reply.body() == _data);
+
+            // keep alive
+            client.get("/files/fileservice-test.txt", 10000);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(client.reply().httpReturnCode(), 200);
+            CXXTOOLS_UNIT_ASSERT(client.body() == _data);
+        }
+
+        void testRange()
+        {
+            cxxtools::http::Client client(_listen, _port);
+            cxxtools::http::Request request("/files/fileservice-test.txt");
+            request.setHeader("Range", "bytes=10-19");
+            client.execute(request, 10000);
+            client.readBody();
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(client.reply().httpReturnCode(), 206);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(client.body(), _data.substr(10, 10));
+
+            std::ostringstream contentRange;
+            contentRange << "bytes 10-19/" << _data.size();
+            CXXTOOLS_UNIT_ASSERT_EQUALS(client.header().getHeader("Content-Range"), contentRange.str());
+
+            request.setHeader("Range", "bytes=1000-");
+            client.execute(request, 10000);
+            client.readBody();
+            CXXTOOLS_UNIT_ASSERT_EQUALS(client.reply().httpReturnCode(), 206);
+            CXXTOOLS_UNIT_ASSERT(client.body() == _data.substr(1000));
+        }
+
+        void testSuffixRange()
+        {
+            cxxtools::http::Client client(_listen, _port);
+            cxxtools::http::Request request("/files/fileservice-test.txt");
+            request.setHeader("Range", "bytes=-5");
+            client.execute(request, 10000);
+            client.readBody();
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(client.reply().httpReturnCode(), 206);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(client.body(), _data.substr(_data.size() - 5));
+        }
+
+        void testUnsatisfiableRange()
+        {
+            cxxtools::http::Client client(_listen, _port);
+            cxxtools::http::Request request("/files/fileservice-test.txt");
+            request.setHeader("Range", "bytes=5000000-");
+            client.execute(request, 10000);
+            client.readBody();
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(client.reply().httpReturnCode(), 416);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(client.body(), "");
+        }
+
+        void testIfRange()
+        {
+            cxxtools::http::Client client(_listen, _port);
+            cxxtools::http::Request request("/files/fileservice-test.txt");
+            request.setHeader("Range", "bytes=10-19");
+            request.setHeader("If-Range", "\"other\"");
+            client.execute(request, 10000);
+            client.readBody();
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(client.reply().httpReturnCode(), 200);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(client.reply().bodySize(), _data.size());
+
+            std::string etag = client.header().getHeader("ETag");
+            request.setHeader("If-Range", etag.c_str());
+            client.execute(request, 10000);
+            client.readBody();
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(client.reply().httpReturnCode(), 206);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(client.body(), _data.substr(10, 10));
+        }
+
+        void testNotModified()
+        {
+            cxxtools::http::Client client(_listen, _port);
+            client.get("/files/fileservice-test.txt", 10000);
+            std::string etag = client.header().getHeader("ETag");
+            std::string lastModified = client.header().getHeader("Last-Modified");
+
+            cxxtools::http::Request request("/files/fileservice-test.txt");
+            request.setHeader("If-None-Match", etag.c_str());
+            client.execute(request, 10000);
+            client.readBody();
+            CXXTOOLS_UNIT_ASSERT_EQUALS(client.reply().httpReturnCode(), 304);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(client.body(), "");
+
+            cxxtools::http::Request request2("/files/fileservice-test.txt");
+            request2.setHeader("If-Modified-Since", lastModified.c_str());
+            client.execute(request2, 10000);
+            client.readBody();
+            CXXTOOLS_UNIT_ASSERT_EQUALS(client.reply().httpReturnCode(), 304);
+
+            request2.setHeader("If-Modified-Since", "Sat, 01 Jan 2000 00:00:00 GMT");
+            client.execute(request2, 10000);
+            client.readBody();
+            CXXTOOLS_UNIT_ASSERT_EQUALS(client.reply().httpReturnCode(), 200);
+        }
+
+        void testNotFound()
+        {
+            cxxtools::http::Client client(_listen, _port);
+            client.get("/files/no-such-file.txt", 10000);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(client.reply().httpReturnCode(), 404);
+
+            client.get("/files/../fileservice-test.txt", 10000);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(client.reply().httpReturnCode(), 404);
+
+            // directories are not delivered
+            client.get("/files/", 10000);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(client.reply().httpReturnCode(), 404);
+        }
+
+        void testMimeType()
+        {
+            CXXTOOLS_UNIT_ASSERT_EQUALS(_service.mimeType("a/b.html"), "text/html");
+            CXXTOOLS_UNIT_ASSERT_EQUALS(_service.mimeType("a/b.PNG"), "image/png");
+            CXXTOOLS_UNIT_ASSERT_EQUALS(_service.mimeType("a.d/b"), "application/octet-stream");
+
+            cxxtools::http::Client client(_listen, _port);
+            client.get("/files/fileservice-test.txt", 10000);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(client.header().getHeader("Content-Type"), std::string("text/plain"));
+        }
+
+};
+
+cxxtools::unit::RegisterTest<FileServiceTest> register_FileServiceTest;
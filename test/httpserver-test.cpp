@@ -0,0 +1,207 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "cxxtools/unit/testsuite.h"
+#include "cxxtools/unit/registertest.h"
+#include "cxxtools/http/server.h"
+#include "cxxtools/http/service.h"
+#include "cxxtools/http/responder.h"
+#include "cxxtools/http/request.h"
+#include "cxxtools/http/reply.h"
+#include "cxxtools/net/tcpsocket.h"
+#include "cxxtools/iostream.h"
+#include "cxxtools/eventloop.h"
+#include "cxxtools/thread.h"
+#include "cxxtools/regex.h"
+#include <sstream>
+#include <stdlib.h>
+
+namespace
+{
+    class EchoResponder : public cxxtools::http::Responder
+    {
+        public:
+            explicit EchoResponder(cxxtools::http::Service& service)
+                : cxxtools::http::Responder(service)
+                { }
+
+            void reply(std::ostream& out, cxxtools::http::Request& request, cxxtools::http::Reply& /*reply*/)
+            {
+                out << request.url() << ':' << request.bodyStr();
+            }
+    };
+
+    // reads a reply from the raw stream and returns the status code
+    int readReply(std::istream& in, std::string& body)
+    {
+        std::string line;
+        if (!std::getline(in, line))
+            return 0;
+
+        std::istringstream s(line);
+        std::string version;
+        int code = 0;
+        s >> version >> code;
+
+        std::size_t contentLength = 0;
+        while (std::getline(in, line) && line != "\r")
+        {
+            if (line.compare(0, 15, "Content-Length:") == 0)
+                contentLength = atoi(line.c_str() + 15);
+        }
+
+        body.resize(contentLength);
+        if (contentLength > 0)
+            in.read(&body[0], contentLength);
+
+        return in ? code : 0;
+    }
+}
+
+class HttpServerTest : public cxxtools::unit::TestSuite
+{
+    private:
+        cxxtools::EventLoop _loop;
+        cxxtools::http::Server* _server;
+        cxxtools::http::CachedService<EchoResponder> _service;
+        cxxtools::AttachedThread* _thread;
+        std::string _listen;
+        unsigned short _port;
+
+    public:
+        HttpServerTest()
+        : cxxtools::unit::TestSuite("httpserver"),
+          _listen("127.0.0.1"),
+          _port(8002)
+        {
+            registerMethod("testPipelinedGet", *this, &HttpServerTest::testPipelinedGet);
+            registerMethod("testPipelinedPost", *this, &HttpServerTest::testPipelinedPost);
+            registerMethod("testPipelinedClose", *this, &HttpServerTest::testPipelinedClose);
+
+            char* PORT = getenv("UTEST_PORT");
+            if (PORT)
+            {
+                std::istringstream s(PORT);
+                s >> _port;
+            }
+
+            char* LISTEN = getenv("UTEST_LISTEN");
+            if (LISTEN)
+                _listen = LISTEN;
+        }
+
+        void setUp()
+        {
+            _server = new cxxtools::http::Server(_loop, _listen, _port);
+            _server->addService(cxxtools::Regex("^/"), _service);
+
+            _thread = new cxxtools::AttachedThread(cxxtools::callable(_loop, &cxxtools::EventLoop::run));
+            _thread->start();
+        }
+
+        void tearDown()
+        {
+            _loop.exit();
+            delete _thread;
+            delete _server;
+        }
+
+        void testPipelinedGet()
+        {
+            cxxtools::net::TcpSocket socket(_listen, _port);
+            socket.setTimeout(cxxtools::Seconds(10));
+            cxxtools::IOStream stream(socket);
+
+            stream << "GET /a HTTP/1.1\r\nHost: localhost\r\n\r\n"
+                      "GET /b HTTP/1.1\r\nHost: localhost\r\n\r\n"
+                      "GET /c HTTP/1.1\r\nHost: localhost\r\n\r\n"
+                   << std::flush;
+
+            std::string body;
+            CXXTOOLS_UNIT_ASSERT_EQUALS(readReply(stream, body), 200);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(body, "/a:");
+            CXXTOOLS_UNIT_ASSERT_EQUALS(readReply(stream, body), 200);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(body, "/b:");
+            CXXTOOLS_UNIT_ASSERT_EQUALS(readReply(stream, body), 200);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(body, "/c:");
+
+            // the connection is still usable
+            stream << "GET /d HTTP/1.1\r\nHost: localhost\r\n\r\n" << std::flush;
+            CXXTOOLS_UNIT_ASSERT_EQUALS(readReply(stream, body), 200);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(body, "/d:");
+        }
+
+        void testPipelinedPost()
+        {
+            cxxtools::net::TcpSocket socket(_listen, _port);
+            socket.setTimeout(cxxtools::Seconds(10));
+            cxxtools::IOStream stream(socket);
+
+            stream << "POST /a HTTP/1.1\r\nHost: localhost\r\nContent-Length: 5\r\n\r\nhello"
+                      "POST /b HTTP/1.1\r\nHost: localhost\r\nContent-Length: 3\r\n\r\nfoo"
+                      "GET /c HTTP/1.1\r\nHost: localhost\r\n\r\n"
+                      "POST /d HTTP/1.1\r\nHost: localhost\r\nContent-Length: 5\r\n\r\nwo"
+                   << std::flush;
+
+            std::string body;
+            CXXTOOLS_UNIT_ASSERT_EQUALS(readReply(stream, body), 200);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(body, "/a:hello");
+            CXXTOOLS_UNIT_ASSERT_EQUALS(readReply(stream, body), 200);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(body, "/b:foo");
+            CXXTOOLS_UNIT_ASSERT_EQUALS(readReply(stream, body), 200);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(body, "/c:");
+
+            // the rest of the last body arrives later
+            stream << "rld" << std::flush;
+            CXXTOOLS_UNIT_ASSERT_EQUALS(readReply(stream, body), 200);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(body, "/d:world");
+        }
+
+        void testPipelinedClose()
+        {
+            cxxtools::net::TcpSocket socket(_listen, _port);
+            socket.setTimeout(cxxtools::Seconds(10));
+            cxxtools::IOStream stream(socket);
+
+            stream << "GET /a HTTP/1.1\r\nHost: localhost\r\n\r\n"
+                      "GET /b HTTP/1.1\r\nHost: localhost\r\nConnection: close\r\n\r\n"
+                      "GET /c HTTP/1.1\r\nHost: localhost\r\n\r\n"
+                   << std::flush;
+
+            std::string body;
+            CXXTOOLS_UNIT_ASSERT_EQUALS(readReply(stream, body), 200);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(body, "/a:");
+            CXXTOOLS_UNIT_ASSERT_EQUALS(readReply(stream, body), 200);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(body, "/b:");
+
+            // the server closes the connection after the second reply
+            CXXTOOLS_UNIT_ASSERT_EQUALS(readReply(stream, body), 0);
+        }
+};
+
+cxxtools::unit::RegisterTest<HttpServerTest> register_HttpServerTest;
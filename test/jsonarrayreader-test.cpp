@@ -0,0 +1,218 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#include "cxxtools/unit/testsuite.h"
+#include "cxxtools/unit/registertest.h"
+#include "cxxtools/jsonarrayreader.h"
+#include "cxxtools/serializationinfo.h"
+#include <sstream>
+
+namespace
+{
+    struct Record
+    {
+        int id;
+        std::string name;
+    };
+
+    void operator>>= (const cxxtools::SerializationInfo& si, Record& r)
+    {
+        si.getMember("id") >>= r.id;
+        si.getMember("name") >>= r.name;
+    }
+
+    bool lineIs(const std::exception& e, unsigned lineNo)
+    {
+        std::ostringstream s;
+        s << "line " << lineNo << ':';
+        return std::string(e.what()).find(s.str()) != std::string::npos;
+    }
+}
+
+class JsonArrayReaderTest : public cxxtools::unit::TestSuite
+{
+    public:
+        JsonArrayReaderTest()
+            : cxxtools::unit::TestSuite("jsonarrayreader")
+        {
+            registerMethod("testRecords", *this, &JsonArrayReaderTest::testRecords);
+            registerMethod("testValues", *this, &JsonArrayReaderTest::testValues);
+            registerMethod("testEmpty", *this, &JsonArrayReaderTest::testEmpty);
+            registerMethod("testComments", *this, &JsonArrayReaderTest::testComments);
+            registerMethod("testLarge", *this, &JsonArrayReaderTest::testLarge);
+            registerMethod("testNoArray", *this, &JsonArrayReaderTest::testNoArray);
+            registerMethod("testErrorLine", *this, &JsonArrayReaderTest::testErrorLine);
+            registerMethod("testUnexpectedEnd", *this, &JsonArrayReaderTest::testUnexpectedEnd);
+            registerMethod("testTrailingComma", *this, &JsonArrayReaderTest::testTrailingComma);
+        }
+
+        void testRecords()
+        {
+            std::istringstream in("[ {\"id\": 1, \"name\": \"foo\"},\n"
+                                  "  {\"id\": 2, \"name\": \"bar\", \"extra\": [1,2]} ]");
+
+            cxxtools::JsonArrayReader reader(in);
+
+            Record r;
+            CXXTOOLS_UNIT_ASSERT(reader.get(r));
+            CXXTOOLS_UNIT_ASSERT_EQUALS(r.id, 1);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(r.name, "foo");
+
+            CXXTOOLS_UNIT_ASSERT(reader.next());
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reader.si().memberCount(), 3);
+            reader.si() >>= r;
+            CXXTOOLS_UNIT_ASSERT_EQUALS(r.id, 2);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(r.name, "bar");
+
+            CXXTOOLS_UNIT_ASSERT(!reader.get(r));
+            CXXTOOLS_UNIT_ASSERT(!reader.next());
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reader.count(), 2);
+        }
+
+        void testValues()
+        {
+            std::istringstream in("[1,-2.5 , \"x\",null,true,[3,4]]");
+            cxxtools::JsonArrayReader reader(in);
+
+            CXXTOOLS_UNIT_ASSERT(reader.next());
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reader.si().typeName(), "int");
+
+            double d = 0;
+            CXXTOOLS_UNIT_ASSERT(reader.get(d));
+            CXXTOOLS_UNIT_ASSERT_EQUALS(d, -2.5);
+
+            std::string s;
+            CXXTOOLS_UNIT_ASSERT(reader.get(s));
+            CXXTOOLS_UNIT_ASSERT_EQUALS(s, "x");
+
+            CXXTOOLS_UNIT_ASSERT(reader.next());
+            CXXTOOLS_UNIT_ASSERT(reader.si().isNull());
+
+            bool b = false;
+            CXXTOOLS_UNIT_ASSERT(reader.get(b));
+            CXXTOOLS_UNIT_ASSERT(b);
+
+            std::vector<int> v;
+            CXXTOOLS_UNIT_ASSERT(reader.get(v));
+            CXXTOOLS_UNIT_ASSERT_EQUALS(v.size(), 2);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(v[1], 4);
+
+            CXXTOOLS_UNIT_ASSERT(!reader.next());
+        }
+
+        void testEmpty()
+        {
+            std::istringstream in("  [ ] ");
+            cxxtools::JsonArrayReader reader(in);
+            CXXTOOLS_UNIT_ASSERT(!reader.next());
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reader.count(), 0);
+        }
+
+        void testComments()
+        {
+            std::istringstream in("// records\n[ /* first */ 1, // second\n 2 /* end */ ]");
+            cxxtools::JsonArrayReader reader(in);
+
+            int value = 0;
+            CXXTOOLS_UNIT_ASSERT(reader.get(value));
+            CXXTOOLS_UNIT_ASSERT_EQUALS(value, 1);
+            CXXTOOLS_UNIT_ASSERT(reader.get(value));
+            CXXTOOLS_UNIT_ASSERT_EQUALS(value, 2);
+            CXXTOOLS_UNIT_ASSERT(!reader.get(value));
+        }
+
+        void testLarge()
+        {
+            // elements span the blocks read from the input
+            std::ostringstream json;
+            json << '[';
+            for (unsigned n = 0; n < 20000; ++n)
+                json << (n ? ",\n" : "") << "{\"id\":" << n << ",\"name\":\"record " << n << "\"}";
+            json << ']';
+
+            std::istringstream in(json.str());
+            cxxtools::JsonArrayReader reader(in);
+
+            Record r;
+            unsigned count = 0;
+            while (reader.get(r))
+            {
+                CXXTOOLS_UNIT_ASSERT_EQUALS(r.id, static_cast<int>(count));
+                ++count;
+            }
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(count, 20000);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(r.name, "record 19999");
+        }
+
+        void testNoArray()
+        {
+            std::istringstream in("{\"id\": 1}");
+            cxxtools::JsonArrayReader reader(in);
+            CXXTOOLS_UNIT_ASSERT_THROW(reader.next(), cxxtools::JsonParserError);
+        }
+
+        void testErrorLine()
+        {
+            std::istringstream in("[\n1,\n{\"a\"\n 1}]");
+            cxxtools::JsonArrayReader reader(in);
+
+            CXXTOOLS_UNIT_ASSERT(reader.next());
+            try
+            {
+                reader.next();
+                CXXTOOLS_UNIT_FAIL("JsonParserError expected");
+            }
+            catch (const cxxtools::JsonParserError& e)
+            {
+                CXXTOOLS_UNIT_ASSERT(lineIs(e, 4));
+            }
+        }
+
+        void testUnexpectedEnd()
+        {
+            std::istringstream in("[1, 2");
+            cxxtools::JsonArrayReader reader(in);
+
+            CXXTOOLS_UNIT_ASSERT(reader.next());
+            CXXTOOLS_UNIT_ASSERT(reader.next());
+            CXXTOOLS_UNIT_ASSERT_THROW(reader.next(), cxxtools::JsonParserError);
+        }
+
+        void testTrailingComma()
+        {
+            std::istringstream in("[1, /* end */ ]");
+            cxxtools::JsonArrayReader reader(in);
+
+            CXXTOOLS_UNIT_ASSERT(reader.next());
+            CXXTOOLS_UNIT_ASSERT_THROW(reader.next(), cxxtools::JsonParserError);
+        }
+};
+
+cxxtools::unit::RegisterTest<JsonArrayReaderTest> register_JsonArrayReaderTest;
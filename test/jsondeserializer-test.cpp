@@ -31,6 +31,7 @@
 #include "cxxtools/jsondeserializer.h"
 #include "cxxtools/json.h"
 #include "cxxtools/log.h"
+#include <cstring>
 
 //log_define("cxxtools.test.jsondeserializer")
 //
@@ -89,6 +90,26 @@ namespace
     {
     }
 
+    // stream buffer without get area
+    class UnbufferedInput : public std::streambuf
+    {
+        const char* _p;
+        const char* _end;
+
+    public:
+        explicit UnbufferedInput(const char* s)
+            : _p(s),
+              _end(s + std::strlen(s))
+        { }
+
+    protected:
+        int_type underflow()
+        { return _p == _end ? traits_type::eof() : traits_type::to_int_type(*_p); }
+
+        int_type uflow()
+        { return _p == _end ? traits_type::eof() : traits_type::to_int_type(*_p++); }
+    };
+
 }
 
 class JsonDeserializerTest : public cxxtools::unit::TestSuite
@@ -98,6 +119,7 @@ class JsonDeserializerTest : public cxxtools::unit::TestSuite
             : cxxtools::unit::TestSuite("jsondeserializer")
         {
             registerMethod("testInt", *this, &JsonDeserializerTest::testInt);
+            registerMethod("testIntFollowed", *this, &JsonDeserializerTest::testIntFollowed);
             registerMethod("testObject", *this, &JsonDeserializerTest::testObject);
             registerMethod("testObjectPlainKeys", *this, &JsonDeserializerTest::testObjectPlainKeys);
             registerMethod("testEmptyObject", *this, &JsonDeserializerTest::testEmptyObject);
@@ -111,6 +133,13 @@ class JsonDeserializerTest : public cxxtools::unit::TestSuite
             registerMethod("testMultipleObjectsT", *this, &JsonDeserializerTest::testMultipleObjectsT);
             registerMethod("testMultipleObjectsI", *this, &JsonDeserializerTest::testMultipleObjectsI);
             registerMethod("testTrailingComma", *this, &JsonDeserializerTest::testTrailingComma);
+            registerMethod("testReuseStorage", *this, &JsonDeserializerTest::testReuseStorage);
+            registerMethod("testBytes", *this, &JsonDeserializerTest::testBytes);
+            registerMethod("testBytesUnicode", *this, &JsonDeserializerTest::testBytesUnicode);
+            registerMethod("testBytesChunked", *this, &JsonDeserializerTest::testBytesChunked);
+            registerMethod("testBytesTrailing", *this, &JsonDeserializerTest::testBytesTrailing);
+            registerMethod("testBytesNumberEnd", *this, &JsonDeserializerTest::testBytesNumberEnd);
+            registerMethod("testBytesError", *this, &JsonDeserializerTest::testBytesError);
         }
 
         void testInt()
@@ -124,6 +153,17 @@ class JsonDeserializerTest : public cxxtools::unit::TestSuite
             CXXTOOLS_UNIT_ASSERT_EQUALS(data, -4711);
         }
 
+        void testIntFollowed()
+        {
+            int data = 0;
+            std::istringstream in("-4711 ");
+
+            cxxtools::JsonDeserializer deserializer(in);
+            deserializer.deserialize(data);
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(data, -4711);
+        }
+
         void testObject()
         {
             TestObject data;
@@ -361,6 +401,36 @@ class JsonDeserializerTest : public cxxtools::unit::TestSuite
 
         }
 
+        void parse(cxxtools::JsonDeserializer& deserializer, const char* json)
+        {
+            deserializer.begin();
+            for (const char* p = json; *p; ++p)
+                deserializer.advance(cxxtools::Char(*p));
+            deserializer.finish();
+        }
+
+        void testReuseStorage()
+        {
+            cxxtools::JsonDeserializer deserializer;
+            deserializer.reuseStorage(true);
+
+            parse(deserializer, "{\"a\": 1, \"b\": [1, 2, 3], \"c\": \"some long string value\"}");
+            CXXTOOLS_UNIT_ASSERT_EQUALS(deserializer.si().memberCount(), 3);
+
+            parse(deserializer, "{\"b\": [4], \"d\": null}");
+
+            const cxxtools::SerializationInfo& si = deserializer.si();
+            CXXTOOLS_UNIT_ASSERT_EQUALS(si.memberCount(), 2);
+            CXXTOOLS_UNIT_ASSERT(si.findMember("a") == 0);
+            CXXTOOLS_UNIT_ASSERT(si.findMember("c") == 0);
+            CXXTOOLS_UNIT_ASSERT(si.getMember("d").isNull());
+
+            std::vector<int> b;
+            si.getMember("b") >>= b;
+            CXXTOOLS_UNIT_ASSERT_EQUALS(b.size(), 1);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(b[0], 4);
+        }
+
         void testTrailingComma()
         {
             std::istringstream in("{ a: 5, b: [ 2,3,], }");
@@ -379,6 +449,158 @@ class JsonDeserializerTest : public cxxtools::unit::TestSuite
             CXXTOOLS_UNIT_ASSERT_EQUALS(data[0], 2);
             CXXTOOLS_UNIT_ASSERT_EQUALS(data[1], 3);
         }
+
+        void testBytes()
+        {
+            TestObject2 data;
+
+            std::istringstream in(" {"
+                "\"intValue\": 17, "
+                "\"stringValue\":  \"foo \\\"bar\\\"\\t\","
+                "\"doubleValue\": -1.5e3, "
+                "\"boolValue\"  :    true,"
+                "\"nullValue\"  :  null,"
+                "setValue:[5,7,8],"
+                "\"structValue\" : { \"n\":3,\"s\":\"sss\"}"
+            "}");
+
+            cxxtools::JsonDeserializer deserializer(*in.rdbuf());
+            deserializer.deserialize(data);
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(data.intValue, 17);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(data.stringValue, "foo \"bar\"\t");
+            CXXTOOLS_UNIT_ASSERT_EQUALS(data.doubleValue, -1500.0);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(data.boolValue, true);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(data.nullValue, true);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(data.setValue.size(), 3);
+            CXXTOOLS_UNIT_ASSERT(data.setValue.find(8) != data.setValue.end());
+            CXXTOOLS_UNIT_ASSERT_EQUALS(data.structValue.n, 3);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(data.structValue.s, "sss");
+        }
+
+        void testBytesUnicode()
+        {
+            std::vector<std::string> data;
+            std::vector<cxxtools::String> sdata;
+
+            // utf-8 is passed through; escaped non ascii characters keep their
+            // value like in the decoding parser
+            std::istringstream in("[\"M\xc3\xa4kitalo\", \"\\u00e4\", \"a\\u1e04\"]");
+
+            cxxtools::JsonDeserializer deserializer(*in.rdbuf());
+            deserializer.deserialize(data);
+            deserializer.deserialize(sdata);
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(data.size(), 3);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(data[0], "M\xc3\xa4kitalo");
+            CXXTOOLS_UNIT_ASSERT_EQUALS(data[1], "\xe4");
+            CXXTOOLS_UNIT_ASSERT_EQUALS(sdata.size(), 3);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(sdata[1].size(), 1);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(sdata[1][0].value(), 0xe4);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(sdata[2].size(), 2);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(sdata[2][0], 'a');
+            CXXTOOLS_UNIT_ASSERT_EQUALS(sdata[2][1].value(), 0x1e04);
+        }
+
+        void testBytesChunked()
+        {
+            const std::string json = "{\"a\": 12345, \"b\": [1.25, \"x\\ny\"], "
+                "\"long member name\": \"some longer value\", \"u\": \"\\u0041\"}";
+
+            for (unsigned chunk = 1; chunk <= 7; ++chunk)
+            {
+                cxxtools::JsonDeserializer deserializer;
+                deserializer.begin();
+
+                bool finished = false;
+                for (unsigned n = 0; n < json.size() && !finished; n += chunk)
+                {
+                    const char* b = json.data() + n;
+                    const char* e = json.data() + std::min(json.size(), std::size_t(n + chunk));
+                    finished = deserializer.advance(b, e);
+                }
+
+                CXXTOOLS_UNIT_ASSERT(finished);
+                deserializer.finish();
+
+                const cxxtools::SerializationInfo& si = deserializer.si();
+                int a = 0;
+                double b0 = 0;
+                std::string b1, l, u;
+                si.getMember("a") >>= a;
+                si.getMember("b").getMember(0) >>= b0;
+                si.getMember("b").getMember(1) >>= b1;
+                si.getMember("long member name") >>= l;
+                si.getMember("u") >>= u;
+                CXXTOOLS_UNIT_ASSERT_EQUALS(a, 12345);
+                CXXTOOLS_UNIT_ASSERT_EQUALS(b0, 1.25);
+                CXXTOOLS_UNIT_ASSERT_EQUALS(b1, "x\ny");
+                CXXTOOLS_UNIT_ASSERT_EQUALS(l, "some longer value");
+                CXXTOOLS_UNIT_ASSERT_EQUALS(u, "A");
+            }
+        }
+
+        void testBytesTrailing()
+        {
+            std::istringstream in("{\"a\":1} {\"a\":2}");
+
+            int value = 0;
+            cxxtools::JsonDeserializer deserializer;
+
+            deserializer.begin();
+            CXXTOOLS_UNIT_ASSERT(deserializer.advance(*in.rdbuf()));
+            deserializer.finish();
+            deserializer.si().getMember("a") >>= value;
+            CXXTOOLS_UNIT_ASSERT_EQUALS(value, 1);
+
+            deserializer.begin();
+            CXXTOOLS_UNIT_ASSERT(deserializer.advance(*in.rdbuf()));
+            deserializer.finish();
+            deserializer.si().getMember("a") >>= value;
+            CXXTOOLS_UNIT_ASSERT_EQUALS(value, 2);
+        }
+
+        void testBytesNumberEnd()
+        {
+            // the byte ending a number is not part of the value and stays
+            // in the stream
+            UnbufferedInput in("42,");
+
+            int value = 0;
+            std::size_t count = 0;
+            std::size_t n;
+            cxxtools::JsonDeserializer deserializer;
+
+            deserializer.begin();
+            while (!deserializer.advance(in, n))
+                count += n;
+            count += n;
+            deserializer.finish();
+            deserializer.si() >>= value;
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(value, 42);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(count, 2);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(in.sgetc(), ',');
+        }
+
+        void testBytesError()
+        {
+            const char json[] = "{\n\"a\": [1,\n\"x\"\n,\n2 x]}";
+            const char* b = json;
+
+            cxxtools::JsonDeserializer deserializer;
+            deserializer.begin();
+
+            try
+            {
+                deserializer.advance(b, json + sizeof(json) - 1);
+                CXXTOOLS_UNIT_FAIL("JsonParserError expected");
+            }
+            catch (const cxxtools::JsonParserError& e)
+            {
+                CXXTOOLS_UNIT_ASSERT(std::string(e.what()).find("line 5:") != std::string::npos);
+            }
+        }
 };
 
 cxxtools::unit::RegisterTest<JsonDeserializerTest> register_JsonDeserializerTest;
@@ -39,6 +39,7 @@
 #include "cxxtools/net/addrinfo.h"
 #include <stdlib.h>
 #include <sstream>
+#include <stdexcept>
 
 log_define("cxxtools.test.jsonrpchttp")
 
@@ -109,9 +110,12 @@ class JsonRpcHttpTest : public cxxtools::unit::TestSuite
             registerMethod("CallbackException", *this, &JsonRpcHttpTest::CallbackException);
             registerMethod("ConnectError", *this, &JsonRpcHttpTest::ConnectError);
             registerMethod("BigRequest", *this, &JsonRpcHttpTest::BigRequest);
+            registerMethod("BigReply", *this, &JsonRpcHttpTest::BigReply);
             registerMethod("PrepareConnect", *this, &JsonRpcHttpTest::PrepareConnect);
             registerMethod("Connect", *this, &JsonRpcHttpTest::Connect);
             registerMethod("Multiple", *this, &JsonRpcHttpTest::Multiple);
+            registerMethod("Reactors", *this, &JsonRpcHttpTest::Reactors);
+            registerMethod("ReactorsRunning", *this, &JsonRpcHttpTest::ReactorsRunning);
 
             char* PORT = getenv("UTEST_PORT");
             if (PORT)
@@ -689,6 +693,27 @@ class JsonRpcHttpTest : public cxxtools::unit::TestSuite
             return v.size();
         }
 
+        ////////////////////////////////////////////////////////////
+        // BigReply
+        //
+        void BigReply()
+        {
+            cxxtools::json::HttpService service;
+            service.registerMethod("echoString", *this, &JsonRpcHttpTest::echoString);
+            _server->addService("/rpc", service);
+
+            cxxtools::json::HttpClient client(_loop, _listen, _port, "/rpc");
+            cxxtools::RemoteProcedure<std::string, std::string> echo(client, "echoString");
+
+            // larger than the stream buffers, so that the body is sent in multiple blocks
+            std::string s;
+            for (unsigned n = 0; s.size() < 300000; ++n)
+                s += static_cast<char>('a' + n % 26);
+
+            echo.begin(s);
+            CXXTOOLS_UNIT_ASSERT(echo.end(2000) == s);
+        }
+
         ////////////////////////////////////////////////////////////
         // PrepareConnect
         //
@@ -835,6 +860,69 @@ class JsonRpcHttpTest : public cxxtools::unit::TestSuite
 
         }
 
+        ////////////////////////////////////////////////////////////
+        // Reactors
+        //
+        void Reactors()
+        {
+            cxxtools::http::Server server(_loop);
+            server.reactors(3);
+            server.minThreads(1);
+            server.listen(_listen, _port + 1);
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(server.reactors(), 3);
+
+            cxxtools::json::HttpService service;
+            service.registerMethod("multiply", *this, &JsonRpcHttpTest::multiplyDouble);
+            server.addService("/rpc", service);
+
+            typedef cxxtools::RemoteProcedure<double, double, double> Multiply;
+
+            std::vector<cxxtools::json::HttpClient> clients;
+            std::vector<Multiply> procs;
+
+            clients.reserve(16);
+            procs.reserve(16);
+
+            for (unsigned i = 0; i < 16; ++i)
+            {
+                clients.push_back(cxxtools::json::HttpClient(_loop, _listen, _port + 1, "/rpc"));
+                procs.push_back(Multiply(clients.back(), "multiply"));
+                procs.back().begin(i, i);
+            }
+
+            for (unsigned i = 0; i < 16; ++i)
+            {
+                CXXTOOLS_UNIT_ASSERT_EQUALS(procs[i].end(2000), i*i);
+            }
+
+        }
+
+        void ReactorsRunning()
+        {
+            cxxtools::http::Server server(_loop);
+            server.minThreads(1);
+
+            // start the server
+            _loop.processEvents();
+
+            // too late; the server keeps its reactor
+            CXXTOOLS_UNIT_ASSERT_THROW(server.reactors(3), std::logic_error);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(server.reactors(), 1);
+            server.listen(_listen, _port + 1);
+
+            cxxtools::json::HttpService service;
+            service.registerMethod("multiply", *this, &JsonRpcHttpTest::multiplyDouble);
+            server.addService("/rpc", service);
+
+            typedef cxxtools::RemoteProcedure<double, double, double> Multiply;
+
+            cxxtools::json::HttpClient client(_loop, _listen, _port + 1, "/rpc");
+            Multiply multiply(client, "multiply");
+            multiply.begin(3, 4);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(multiply.end(2000), 12);
+        }
+
 };
 
 cxxtools::unit::RegisterTest<JsonRpcHttpTest> register_JsonRpcHttpTest;
@@ -89,6 +89,51 @@ namespace
       jsi.setTypeName("json");
     }
 
+    // object written directly to the formatter
+    struct DirectObject
+    {
+        int a;
+        std::vector<std::string> b;
+    };
+
+    void formatValue(cxxtools::Formatter& formatter, const std::string& name, const DirectObject& obj)
+    {
+        formatter.beginObject(name, "DirectObject");
+        cxxtools::formatMember(formatter, "a", obj.a);
+        cxxtools::formatMember(formatter, "b", obj.b);
+        formatter.finishObject();
+    }
+
+    // containers with an own serialization operator
+    struct Counted
+    {
+        int value;
+    };
+
+    void operator<<= (cxxtools::SerializationInfo& si, const Counted& c)
+    {
+        si <<= c.value;
+    }
+
+    void operator<<= (cxxtools::SerializationInfo& si, const std::vector<Counted>& v)
+    {
+        si.addMember("count") <<= v.size();
+    }
+
+    void operator<<= (cxxtools::SerializationInfo& si, const std::map<std::string, Counted>& m)
+    {
+        si.addMember("keys") <<= m.size();
+    }
+}
+
+namespace cxxtools
+{
+    template <> struct DirectFormat<DirectObject> { enum { value = true }; };
+}
+
+namespace
+{
+
     template <typename T>
     std::string toJson(const T& t)
     {
@@ -121,6 +166,9 @@ class JsonSerializerTest : public cxxtools::unit::TestSuite
             registerMethod("testEasyJson", *this, &JsonSerializerTest::testEasyJson);
             registerMethod("testPlainkey", *this, &JsonSerializerTest::testPlainkey);
             registerMethod("testTimespan", *this, &JsonSerializerTest::testTimespan);
+            registerMethod("testFormatValue", *this, &JsonSerializerTest::testFormatValue);
+            registerMethod("testFormatValueOverload", *this, &JsonSerializerTest::testFormatValueOverload);
+            registerMethod("testContainerOperator", *this, &JsonSerializerTest::testContainerOperator);
         }
 
         void testInt()
@@ -377,6 +425,77 @@ class JsonSerializerTest : public cxxtools::unit::TestSuite
             j = toJson(cxxtools::Hours(67));
             CXXTOOLS_UNIT_ASSERT_EQUALS(j, "67");
         }
+
+        template <typename T>
+        std::string toJsonSi(const T& t)
+        {
+            cxxtools::SerializationInfo si;
+            si <<= t;
+
+            std::ostringstream out;
+            cxxtools::JsonFormatter formatter;
+            formatter.begin(out);
+            cxxtools::IDecomposer::formatEach(si, formatter);
+            formatter.finish();
+            return out.str();
+        }
+
+        void testFormatValue()
+        {
+            // direct formatting gives the same result as the serialization info
+
+            std::map<std::string, std::vector<TestObject> > m;
+            m["a"].resize(2);
+            m["a"][1].stringValue = "foo";
+            m["b"];
+
+            std::list<std::pair<char, std::set<double> > > l;
+            l.push_back(std::pair<char, std::set<double> >('x', std::set<double>()));
+            l.back().second.insert(1.5);
+            l.back().second.insert(-2);
+
+            std::vector<cxxtools::String> s;
+            s.push_back(cxxtools::String(L"\xe4\x1e04"));
+
+            std::deque<unsigned char> d;
+            d.push_back(200);
+            std::vector<short> e;
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(toJson(m), toJsonSi(m));
+            CXXTOOLS_UNIT_ASSERT_EQUALS(toJson(l), toJsonSi(l));
+            CXXTOOLS_UNIT_ASSERT_EQUALS(toJson(s), toJsonSi(s));
+            CXXTOOLS_UNIT_ASSERT_EQUALS(toJson(d), toJsonSi(d));
+            CXXTOOLS_UNIT_ASSERT_EQUALS(toJson(e), toJsonSi(e));
+            CXXTOOLS_UNIT_ASSERT_EQUALS(toJson(true), toJsonSi(true));
+            CXXTOOLS_UNIT_ASSERT_EQUALS(toJson("hi"), toJsonSi("hi"));
+            CXXTOOLS_UNIT_ASSERT_EQUALS(toJson(-3LL), toJsonSi(-3LL));
+        }
+
+        void testFormatValueOverload()
+        {
+            std::vector<DirectObject> v(1);
+            v[0].a = 5;
+            v[0].b.push_back("x");
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(toJson(v), "[{\"a\":5,\"b\":[\"x\"]}]");
+        }
+
+        void testContainerOperator()
+        {
+            // an own operator <<= for a container is not bypassed
+            std::vector<Counted> v(3);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(toJson(v), "{\"count\":3}");
+
+            std::map<std::string, Counted> m;
+            m["a"].value = 1;
+            CXXTOOLS_UNIT_ASSERT_EQUALS(toJson(m), "{\"keys\":1}");
+
+            // other containers use the operator of the element
+            std::list<Counted> l(2);
+            l.front().value = 1;
+            l.back().value = 2;
+            CXXTOOLS_UNIT_ASSERT_EQUALS(toJson(l), "[1,2]");
+        }
 };
 
 cxxtools::unit::RegisterTest<JsonSerializerTest> register_JsonSerializerTest;
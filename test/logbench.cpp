@@ -85,6 +85,64 @@ namespace bench
   }
 }
 
+namespace
+{
+  typedef std::vector<cxxtools::SmartPtr<bench::Logtester> > Threads;
+
+  // runs the loggers until the minimum runtime is reached and returns messages per second
+  double measure(Threads& threads, unsigned long loops, double total, bool verbose)
+  {
+    unsigned long count = 1;
+    double T;
+
+    while (true)
+    {
+      if (verbose)
+        std::cout << "count=" << (count * loops) << '\t' << std::flush;
+
+      for (Threads::iterator it = threads.begin(); it != threads.end(); ++it)
+        (*it)->setCount(count);
+
+      struct timeval tv0;
+      struct timeval tv1;
+
+      gettimeofday(&tv0, 0);
+
+      if (threads.size() == 1)
+      {
+        (*threads.begin())->run();
+      }
+      else
+      {
+        for (Threads::iterator it = threads.begin(); it != threads.end(); ++it)
+          (*it)->start();
+        for (Threads::iterator it = threads.begin(); it != threads.end(); ++it)
+          (*it)->join();
+      }
+
+      gettimeofday(&tv1, 0);
+
+      double t0 = tv0.tv_sec + tv0.tv_usec / 1e6;
+      double t1 = tv1.tv_sec + tv1.tv_usec / 1e6;
+      T = t1 - t0;
+
+      if (verbose)
+      {
+        std::cout.precision(6);
+        std::cout << " T=" << T << '\t' << std::setprecision(12) << (count / T * loops)
+          << " msg/s" << std::endl;
+      }
+
+      if (T >= total || count > (~0ul >> 1))
+        break;
+
+      count <<= 1;
+    }
+
+    return count / T * loops;
+  }
+}
+
 int main(int argc, char* argv[])
 {
   try
@@ -92,12 +150,36 @@ int main(int argc, char* argv[])
     cxxtools::Arg<double> total(argc, argv, 'T', 5.0); // minimum runtime
     cxxtools::Arg<long> loops(argc, argv, 'l', 1000);
     cxxtools::Arg<unsigned> numthreads(argc, argv, 't', 1);
+    cxxtools::Arg<unsigned> maxthreads(argc, argv, 'm', 0);  // measure 1, 2, 4, ... up to maxthreads threads
 
     cxxtools::Arg<bool> enable(argc, argv, 'e');
     cxxtools::Arg<bool> consolelog(argc, argv, 'c');
     cxxtools::Arg<unsigned short> udpport(argc, argv, 'u');
     cxxtools::Arg<std::string> logfile(argc, argv, 'f', "/dev/null");
     cxxtools::Arg<bool> norollingfile(argc, argv, 'r');
+    cxxtools::Arg<bool> async(argc, argv, 'a');
+    cxxtools::Arg<unsigned> queuesize(argc, argv, 'q', 8192);
+    cxxtools::Arg<bool> block(argc, argv, 'b');
+    cxxtools::Arg<bool> coarseclock(argc, argv, 'C');
+
+    if (argc > 1)
+    {
+      std::cerr << "usage: " << argv[0] << " [options]\n"
+                   "  -T <seconds>  minimum runtime (default 5)\n"
+                   "  -l <number>   loops (default 1000)\n"
+                   "  -t <number>   number of threads (default 1)\n"
+                   "  -m <number>   measure with 1, 2, 4, ... up to <number> threads\n"
+                   "  -e            enable logging (otherwise disabled debug messages are measured)\n"
+                   "  -c            log to console\n"
+                   "  -u <port>     log to udp port\n"
+                   "  -f <file>     log to file (default /dev/null)\n"
+                   "  -r            no rolling file\n"
+                   "  -a            write log asynchronously\n"
+                   "  -q <number>   queue size for asynchronous logging (default 8192)\n"
+                   "  -b            block when queue is full instead of dropping messages\n"
+                   "  -C            use coarse clock for timestamps" << std::endl;
+      return -1;
+    }
 
     cxxtools::LogConfiguration logConfiguration;
     logConfiguration.setRootLevel(cxxtools::Logger::LOG_LEVEL_INFO);
@@ -129,56 +211,35 @@ int main(int argc, char* argv[])
         logConfiguration.setFile(logfile, 1024*1024, 0);
     }
 
-    log_init(logConfiguration);
+    if (async)
+      logConfiguration.setAsync(queuesize, block);
 
-    unsigned long count = 1;
-    double T;
+    if (coarseclock)
+      logConfiguration.setCoarseClock();
 
-    typedef std::vector<cxxtools::SmartPtr<bench::Logtester> > Threads;
-    Threads threads;
-    for (unsigned t = 0; t < numthreads; ++t)
-      threads.push_back(new bench::Logtester(count, loops.getValue() / numthreads.getValue(), enable));
+    log_init(logConfiguration);
 
-    while (count > 0)
+    if (maxthreads > 0)
     {
-      std::cout << "count=" << (count * loops) << '\t' << std::flush;
-
-      for (Threads::iterator it = threads.begin(); it != threads.end(); ++it)
-        (*it)->setCount(count);
-
-      struct timeval tv0;
-      struct timeval tv1;
-
-      gettimeofday(&tv0, 0);
-
-      if (threads.size() == 1)
+      for (unsigned n = 1; n <= maxthreads; n <<= 1)
       {
-        (*threads.begin())->run();
-      }
-      else
-      {
-        for (Threads::iterator it = threads.begin(); it != threads.end(); ++it)
-          (*it)->start();
-        for (Threads::iterator it = threads.begin(); it != threads.end(); ++it)
-          (*it)->join();
-      }
-
-      gettimeofday(&tv1, 0);
+        Threads threads;
+        for (unsigned t = 0; t < n; ++t)
+          threads.push_back(new bench::Logtester(1, loops.getValue() / n, enable));
 
-      double t0 = tv0.tv_sec + tv0.tv_usec / 1e6;
-      double t1 = tv1.tv_sec + tv1.tv_usec / 1e6;
-      T = t1 - t0;
-
-      std::cout.precision(6);
-      std::cout << " T=" << T << '\t' << std::setprecision(12) << (count / T * loops)
-        << " msg/s" << std::endl;
-
-      if (T >= total)
-        break;
-
-      count <<= 1;
+        double rate = measure(threads, loops, total, false);
+        std::cout << "threads=" << n << '\t' << std::setprecision(12) << rate << " msg/s\t"
+                  << (rate / n) << " msg/s per thread" << std::endl;
+      }
     }
+    else
+    {
+      Threads threads;
+      for (unsigned t = 0; t < numthreads; ++t)
+        threads.push_back(new bench::Logtester(1, loops.getValue() / numthreads.getValue(), enable));
 
+      measure(threads, loops, total, true);
+    }
   }
   catch (const std::exception& e)
   {
@@ -186,4 +247,3 @@ int main(int argc, char* argv[])
     return -1;
   }
 }
-
@@ -30,7 +30,12 @@
 #include "cxxtools/unit/testsuite.h"
 #include "cxxtools/unit/registertest.h"
 #include <sstream>
+#include <fstream>
+#include <iterator>
 #include <cxxtools/properties.h>
+#include <cxxtools/serializationinfo.h>
+#include <cxxtools/thread.h>
+#include <stdio.h>
 
 log_define("cxxtools.test.logconfiguration")
 
@@ -47,6 +52,11 @@ class LogconfigurationTest : public cxxtools::unit::TestSuite
       registerMethod("rootLevelTest", *this, &LogconfigurationTest::rootLevelTest);
       registerMethod("hierachicalTest", *this, &LogconfigurationTest::hierachicalTest);
       registerMethod("convertLogFlagsTest", *this, &LogconfigurationTest::convertLogFlagsTest);
+      registerMethod("asyncConfigTest", *this, &LogconfigurationTest::asyncConfigTest);
+      registerMethod("asyncLogTest", *this, &LogconfigurationTest::asyncLogTest);
+      registerMethod("coarseClockTest", *this, &LogconfigurationTest::coarseClockTest);
+      registerMethod("binaryLogTest", *this, &LogconfigurationTest::binaryLogTest);
+      registerMethod("loggerLookupTest", *this, &LogconfigurationTest::loggerLookupTest);
     }
 
     void logLevelTest();
@@ -56,6 +66,11 @@ class LogconfigurationTest : public cxxtools::unit::TestSuite
     void rootLevelTest();
     void hierachicalTest();
     void convertLogFlagsTest();
+    void asyncConfigTest();
+    void asyncLogTest();
+    void coarseClockTest();
+    void binaryLogTest();
+    void loggerLookupTest();
 };
 
 void LogconfigurationTest::logLevelTest()
@@ -259,5 +274,191 @@ void LogconfigurationTest::convertLogFlagsTest()
   CXXTOOLS_UNIT_ASSERT_THROW(cxxtools::LogConfiguration::strToLogFlags("blah"), std::runtime_error);
 }
 
+void LogconfigurationTest::asyncConfigTest()
+{
+  std::istringstream properties(
+    "rootlogger=WARN\n"
+    "async=true\n"
+    "queuesize=100\n"
+    "block=true\n");
+
+  cxxtools::LogConfiguration config;
+  properties >> cxxtools::Properties(config);
+
+  cxxtools::SerializationInfo si;
+  si <<= config;
+
+  bool async = false;
+  unsigned queueSize = 0;
+  bool block = false;
+  CXXTOOLS_UNIT_ASSERT(si.getMember("async", async));
+  CXXTOOLS_UNIT_ASSERT(si.getMember("queuesize", queueSize));
+  CXXTOOLS_UNIT_ASSERT(si.getMember("block", block));
+  CXXTOOLS_UNIT_ASSERT(async);
+  CXXTOOLS_UNIT_ASSERT_EQUALS(queueSize, 100);
+  CXXTOOLS_UNIT_ASSERT(block);
+
+  config.setSync();
+  cxxtools::SerializationInfo si2;
+  si2 <<= config;
+  CXXTOOLS_UNIT_ASSERT(si2.findMember("async") == 0);
+}
+
+namespace
+{
+  void logSomeMessages()
+  {
+    for (unsigned n = 0; n < 1000; ++n)
+      log_info("message " << n);
+  }
+}
+
+void LogconfigurationTest::asyncLogTest()
+{
+  const char* fname = "logconfiguration-test.log";
+  ::remove(fname);
+
+  cxxtools::LogConfiguration config;
+  config.setRootLevel(cxxtools::Logger::LOG_LEVEL_INFO);
+  config.setFile(fname);
+  config.setAsync(16, true);
+  cxxtools::LogManager::getInstance().configure(config);
+
+  {
+    cxxtools::AttachedThread t1(cxxtools::callable(logSomeMessages));
+    cxxtools::AttachedThread t2(cxxtools::callable(logSomeMessages));
+    t1.start();
+    t2.start();
+    logSomeMessages();
+  }
+
+  // fatal messages are written, when the log statement returns
+  log_fatal("fatal message");
+
+  std::ifstream in(fname);
+  std::string line;
+  unsigned count = 0;
+  bool fatal = false;
+  while (std::getline(in, line))
+  {
+    ++count;
+    fatal = line.find("FATAL cxxtools.test.logconfiguration - fatal message") != std::string::npos;
+  }
+
+  cxxtools::LogManager::disable();
+  ::remove(fname);
+
+  CXXTOOLS_UNIT_ASSERT_EQUALS(count, 3001);
+  CXXTOOLS_UNIT_ASSERT(fatal);
+}
+
+void LogconfigurationTest::coarseClockTest()
+{
+  std::istringstream properties(
+    "rootlogger=WARN\n"
+    "coarseclock=true\n");
+
+  cxxtools::LogConfiguration config;
+  properties >> cxxtools::Properties(config);
+
+  cxxtools::SerializationInfo si;
+  si <<= config;
+
+  bool coarseClock = false;
+  CXXTOOLS_UNIT_ASSERT(si.getMember("coarseclock", coarseClock));
+  CXXTOOLS_UNIT_ASSERT(coarseClock);
+
+  config.setCoarseClock(false);
+  cxxtools::SerializationInfo si2;
+  si2 <<= config;
+  CXXTOOLS_UNIT_ASSERT(si2.findMember("coarseclock") == 0);
+}
+
+void LogconfigurationTest::binaryLogTest()
+{
+  const char* fname = "logconfiguration-test.bin";
+  ::remove(fname);
+
+  std::istringstream properties(
+    "rootlogger=INFO\n"
+    "file=logconfiguration-test.bin\n"
+    "binary=true\n");
+
+  cxxtools::LogConfiguration config;
+  properties >> cxxtools::Properties(config);
+
+  cxxtools::SerializationInfo si;
+  si <<= config;
+  bool binary = false;
+  CXXTOOLS_UNIT_ASSERT(si.getMember("binary", binary));
+  CXXTOOLS_UNIT_ASSERT(binary);
+
+  cxxtools::LogManager::getInstance().configure(config);
+  log_info("first binary message");
+  log_warn("second binary message " << 42);
+  cxxtools::LogManager::disable();
+
+  std::ifstream in(fname, std::ios::binary);
+  std::string content((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+  ::remove(fname);
+
+  CXXTOOLS_UNIT_ASSERT_EQUALS(content.substr(0, 8), "CXXLOG1\n");
+  CXXTOOLS_UNIT_ASSERT(content.find("first binary message") != std::string::npos);
+  CXXTOOLS_UNIT_ASSERT(content.find("second binary message 42") != std::string::npos);
+  CXXTOOLS_UNIT_ASSERT(content.find("WARN") != std::string::npos);
+
+  // the category is written once
+  std::string::size_type pos = content.find("cxxtools.test.logconfiguration");
+  CXXTOOLS_UNIT_ASSERT(pos != std::string::npos);
+  CXXTOOLS_UNIT_ASSERT(content.find("cxxtools.test.logconfiguration", pos + 1) == std::string::npos);
+
+  config.setFile(fname);
+  cxxtools::SerializationInfo si2;
+  si2 <<= config;
+  CXXTOOLS_UNIT_ASSERT(si2.findMember("binary") == 0);
+}
+
+namespace
+{
+  void getSomeLoggers()
+  {
+    for (unsigned n = 0; n < 1000; ++n)
+    {
+      std::ostringstream category;
+      category << "cxxtools.test.lookup." << n % 100;
+      cxxtools::LogManager::getInstance().getLogger(category.str());
+    }
+  }
+}
+
+void LogconfigurationTest::loggerLookupTest()
+{
+  cxxtools::LogConfiguration config;
+  config.setRootLevel(cxxtools::Logger::LOG_LEVEL_ERROR);
+  cxxtools::LogManager::getInstance().configure(config);
+
+  {
+    cxxtools::AttachedThread t1(cxxtools::callable(getSomeLoggers));
+    cxxtools::AttachedThread t2(cxxtools::callable(getSomeLoggers));
+    t1.start();
+    t2.start();
+    getSomeLoggers();
+  }
+
+  cxxtools::Logger* logger = cxxtools::LogManager::getInstance().getLogger("cxxtools.test.lookup.42");
+  CXXTOOLS_UNIT_ASSERT(logger != 0);
+  CXXTOOLS_UNIT_ASSERT_EQUALS(logger->getCategory(), "cxxtools.test.lookup.42");
+  CXXTOOLS_UNIT_ASSERT(logger == cxxtools::LogManager::getInstance().getLogger("cxxtools.test.lookup.42"));
+  CXXTOOLS_UNIT_ASSERT(logger != cxxtools::LogManager::getInstance().getLogger("cxxtools.test.lookup.43"));
+  CXXTOOLS_UNIT_ASSERT(!logger->isEnabled(cxxtools::Logger::LOG_INFO));
+
+  // existing loggers are updated on reconfiguration
+  config.setLogLevel("cxxtools.test.lookup", cxxtools::Logger::LOG_LEVEL_INFO);
+  cxxtools::LogManager::getInstance().configure(config);
+  CXXTOOLS_UNIT_ASSERT(logger->isEnabled(cxxtools::Logger::LOG_INFO));
+  CXXTOOLS_UNIT_ASSERT(!logger->isEnabled(cxxtools::Logger::LOG_DEBUG));
+
+  cxxtools::LogManager::disable();
+}
 
 cxxtools::unit::RegisterTest<LogconfigurationTest> register_LogconfigurationTest;
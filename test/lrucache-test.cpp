@@ -40,6 +40,8 @@ class LruCacheTest : public cxxtools::unit::TestSuite
             registerMethod("erase", *this, &LruCacheTest::erase);
             registerMethod("resize", *this, &LruCacheTest::resize);
             registerMethod("stats", *this, &LruCacheTest::stats);
+            registerMethod("order", *this, &LruCacheTest::order);
+            registerMethod("copy", *this, &LruCacheTest::copy);
         }
 
         void cacheTest()
@@ -158,6 +160,57 @@ class LruCacheTest : public cxxtools::unit::TestSuite
           CXXTOOLS_UNIT_ASSERT_EQUALS(cache.getMisses(), 1);
         }
 
+        void order()
+        {
+          cxxtools::LruCache<int, int> cache(3);
+
+          cache.put(1, 10);
+          cache.put(2, 20);
+          cache.put(3, 30);
+
+          CXXTOOLS_UNIT_ASSERT(cache.getptr(1) != 0);
+          cache.put(3, 30);
+          cache.put(4, 40);   // drops 2
+
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cache.size(), 3);
+          CXXTOOLS_UNIT_ASSERT(cache.getptr(2) == 0);
+
+          cache.put(5, 50);   // drops 1
+          CXXTOOLS_UNIT_ASSERT(cache.getptr(1) == 0);
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cache.get(3), 30);
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cache.get(4), 40);
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cache.get(5), 50);
+
+          CXXTOOLS_UNIT_ASSERT(cache.erase(4));
+          cache.put(6, 60);
+          cache.put(7, 70);   // drops 3
+          CXXTOOLS_UNIT_ASSERT(cache.getptr(3) == 0);
+          CXXTOOLS_UNIT_ASSERT(cache.getptr(5) != 0);
+        }
+
+        void copy()
+        {
+          cxxtools::LruCache<int, int> cache(3);
+
+          cache.put(1, 10);
+          cache.put(2, 20);
+          cache.put(3, 30);
+          cache.getptr(1);
+
+          cxxtools::LruCache<int, int> cache2(cache);
+          cache.clear();
+
+          cache2.put(4, 40);   // drops 2
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cache2.size(), 3);
+          CXXTOOLS_UNIT_ASSERT(cache2.getptr(2) == 0);
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cache2.get(1), 10);
+
+          cache = cache2;
+          cache.put(5, 50);   // drops 3
+          CXXTOOLS_UNIT_ASSERT(cache.getptr(3) == 0);
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cache.get(4), 40);
+        }
+
 };
 
 cxxtools::unit::RegisterTest<LruCacheTest> register_LruCacheTest;
@@ -0,0 +1,220 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "cxxtools/unit/testsuite.h"
+#include "cxxtools/unit/registertest.h"
+#include "cxxtools/selector.h"
+#include "cxxtools/pipe.h"
+#include "cxxtools/iodevice.h"
+#include "cxxtools/timer.h"
+#include <string>
+#include <vector>
+#include <stdexcept>
+#include <stdlib.h>
+
+class SelectorTest : public cxxtools::unit::TestSuite
+{
+    std::vector<cxxtools::IODevice*> _ready;
+    char _buffer[16];
+    std::string _ticks;
+
+    void onTimerA()  { _ticks += 'A'; }
+    void onTimerB()  { _ticks += 'B'; }
+    void onTimerC()  { _ticks += 'C'; }
+
+    void onTimerThrow()
+    {
+        _ticks += 'T';
+        if (_ticks.size() == 1)
+            throw std::runtime_error("timer slot failed");
+    }
+
+    void onInput(cxxtools::IODevice& dev)
+    {
+        _ready.push_back(&dev);
+        dev.endRead();
+    }
+
+    void checkPipes(const char* backend)
+    {
+        ::setenv("CXXTOOLS_SELECTOR", backend, 1);
+
+        cxxtools::Selector selector;
+
+        std::vector<cxxtools::Pipe*> pipes;
+        for (unsigned n = 0; n < 10; ++n)
+        {
+            cxxtools::Pipe* pipe = new cxxtools::Pipe(cxxtools::Pipe::Async);
+            pipes.push_back(pipe);
+            selector.add(pipe->out());
+            connect(pipe->out().inputReady, *this, &SelectorTest::onInput);
+            pipe->out().beginRead(_buffer, sizeof(_buffer));
+        }
+
+        CXXTOOLS_UNIT_ASSERT(!selector.wait(0));
+
+        pipes[3]->in().write("A", 1);
+        pipes[7]->in().write("B", 1);
+
+        _ready.clear();
+        CXXTOOLS_UNIT_ASSERT(selector.wait(1000));
+        CXXTOOLS_UNIT_ASSERT_EQUALS(_ready.size(), 2);
+
+        // devices, which are not reading, are not reported
+        pipes[3]->in().write("C", 1);
+        _ready.clear();
+        CXXTOOLS_UNIT_ASSERT(!selector.wait(0));
+        CXXTOOLS_UNIT_ASSERT_EQUALS(_ready.size(), 0);
+
+        pipes[3]->out().beginRead(_buffer, sizeof(_buffer));
+        CXXTOOLS_UNIT_ASSERT(selector.wait(1000));
+        CXXTOOLS_UNIT_ASSERT_EQUALS(_ready.size(), 1);
+        CXXTOOLS_UNIT_ASSERT(_ready[0] == &pipes[3]->out());
+
+        // removed devices are not reported
+        pipes[5]->in().write("D", 1);
+        selector.remove(pipes[5]->out());
+        _ready.clear();
+        CXXTOOLS_UNIT_ASSERT(!selector.wait(0));
+        CXXTOOLS_UNIT_ASSERT_EQUALS(_ready.size(), 0);
+
+        for (unsigned n = 0; n < pipes.size(); ++n)
+            delete pipes[n];
+
+        ::unsetenv("CXXTOOLS_SELECTOR");
+    }
+
+public:
+    SelectorTest()
+    : cxxtools::unit::TestSuite("selector")
+    {
+        registerMethod("poll", *this, &SelectorTest::poll);
+        registerMethod("epoll", *this, &SelectorTest::epoll);
+        registerMethod("wake", *this, &SelectorTest::wake);
+        registerMethod("timerOrder", *this, &SelectorTest::timerOrder);
+        registerMethod("timerRestart", *this, &SelectorTest::timerRestart);
+        registerMethod("timerThrow", *this, &SelectorTest::timerThrow);
+    }
+
+    void poll()
+    {
+        checkPipes("poll");
+    }
+
+    void epoll()
+    {
+        checkPipes("epoll");
+    }
+
+    void wake()
+    {
+        cxxtools::Selector selector;
+        selector.wake();
+        CXXTOOLS_UNIT_ASSERT(selector.wait(1000));
+        CXXTOOLS_UNIT_ASSERT(!selector.wait(0));
+    }
+
+    void timerOrder()
+    {
+        cxxtools::Selector selector;
+        cxxtools::Timer a(&selector);
+        cxxtools::Timer b(&selector);
+        cxxtools::Timer c(&selector);
+        connect(a.timeout, *this, &SelectorTest::onTimerA);
+        connect(b.timeout, *this, &SelectorTest::onTimerB);
+        connect(c.timeout, *this, &SelectorTest::onTimerC);
+
+        _ticks.clear();
+        c.after(30);
+        a.after(10);
+        b.after(20);
+
+        while (_ticks.size() < 3)
+            selector.wait(1000);
+
+        CXXTOOLS_UNIT_ASSERT_EQUALS(_ticks, "ABC");
+    }
+
+    void timerRestart()
+    {
+        cxxtools::Selector selector;
+        cxxtools::Timer a(&selector);
+        cxxtools::Timer b(&selector);
+        connect(a.timeout, *this, &SelectorTest::onTimerA);
+        connect(b.timeout, *this, &SelectorTest::onTimerB);
+
+        _ticks.clear();
+        a.after(10);
+        b.after(20);
+
+        // restarting moves the timer behind b; stopped timers do not tick
+        a.after(40);
+        b.stop();
+        b.after(30);
+        b.stop();
+
+        while (_ticks.empty())
+            selector.wait(1000);
+
+        CXXTOOLS_UNIT_ASSERT_EQUALS(_ticks, "A");
+        CXXTOOLS_UNIT_ASSERT(!a.active());
+    }
+
+    void timerThrow()
+    {
+        cxxtools::Selector selector;
+        cxxtools::Timer t(&selector);
+        connect(t.timeout, *this, &SelectorTest::onTimerThrow);
+
+        _ticks.clear();
+        t.start(10);
+
+        // the exception of the slot is passed to the caller of wait
+        bool thrown = false;
+        try
+        {
+            while (_ticks.empty())
+                selector.wait(1000);
+        }
+        catch (const std::runtime_error&)
+        {
+            thrown = true;
+        }
+
+        CXXTOOLS_UNIT_ASSERT(thrown);
+
+        // the timer keeps running
+        while (_ticks.size() < 2)
+            selector.wait(1000);
+
+        CXXTOOLS_UNIT_ASSERT_EQUALS(_ticks, "TT");
+    }
+
+};
+
+cxxtools::unit::RegisterTest<SelectorTest> register_SelectorTest;
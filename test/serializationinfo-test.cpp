@@ -72,6 +72,8 @@ class SerializationInfoTest : public cxxtools::unit::TestSuite
             registerMethod("testStringToBool", *this, &SerializationInfoTest::testStringToBool);
             registerMethod("testRangeCheck", *this, &SerializationInfoTest::testRangeCheck);
             registerMethod("testMember", *this, &SerializationInfoTest::testMember);
+            registerMethod("testManyMembers", *this, &SerializationInfoTest::testManyMembers);
+            registerMethod("testReset", *this, &SerializationInfoTest::testReset);
         }
 
         void testSiSet()
@@ -602,6 +604,83 @@ class SerializationInfoTest : public cxxtools::unit::TestSuite
             CXXTOOLS_UNIT_ASSERT_EQUALS(si.getMember(2).name(), "baz");
             CXXTOOLS_UNIT_ASSERT_EQUALS(si.getMember(3).name(), "foo");
         }
+
+        void testManyMembers()
+        {
+            cxxtools::SerializationInfo si;
+            for (int n = 0; n < 200; ++n)
+                si.addValue("m" + cxxtools::convert<std::string>(n), n);
+            si.addValue("m17", 1000);
+
+            const cxxtools::SerializationInfo& csi = si;
+            int value = -1;
+            for (int n = 0; n < 200; ++n)
+            {
+                csi.getMember("m" + cxxtools::convert<std::string>(n)) >>= value;
+                CXXTOOLS_UNIT_ASSERT_EQUALS(value, n);
+            }
+
+            CXXTOOLS_UNIT_ASSERT(csi.findMember("m200") == 0);
+            CXXTOOLS_UNIT_ASSERT_THROW(csi.getMember("foo"), cxxtools::SerializationError);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(csi.getMember(200).name(), "m17");
+
+            // renamed members are found under the new name only
+            si.findMember("m5")->setName("five");
+            CXXTOOLS_UNIT_ASSERT(csi.findMember("m5") == 0);
+            CXXTOOLS_UNIT_ASSERT(csi.findMember("five") != 0);
+
+            si.begin()->setName("zero");
+            CXXTOOLS_UNIT_ASSERT(si.findMember("m0") == 0);
+            CXXTOOLS_UNIT_ASSERT(si.findMember("zero") == &*si.begin());
+
+            // the last member may be renamed after adding
+            si.addMember().setName("last");
+            CXXTOOLS_UNIT_ASSERT(csi.findMember("last") != 0);
+
+            cxxtools::SerializationInfo si2(si);
+            CXXTOOLS_UNIT_ASSERT(si2.findMember("five") != 0);
+            CXXTOOLS_UNIT_ASSERT(si2.findMember("m199") != 0);
+            CXXTOOLS_UNIT_ASSERT(si2.findMember("m5") == 0);
+
+            cxxtools::SerializationInfo si3;
+            si3.swap(si2);
+            CXXTOOLS_UNIT_ASSERT(si3.findMember("last") != 0);
+            CXXTOOLS_UNIT_ASSERT(si2.findMember("last") == 0);
+
+            si3.clear();
+            CXXTOOLS_UNIT_ASSERT(si3.findMember("last") == 0);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(si3.memberCount(), 0);
+        }
+
+        void testReset()
+        {
+            cxxtools::SerializationInfo si;
+            for (int n = 0; n < 40; ++n)
+                si.addMember("m" + cxxtools::convert<std::string>(n)).addValue("v", n);
+            si.setTypeName("foo");
+
+            si.reset();
+            CXXTOOLS_UNIT_ASSERT_EQUALS(si.memberCount(), 0);
+            CXXTOOLS_UNIT_ASSERT(si.begin() == si.end());
+            CXXTOOLS_UNIT_ASSERT(si.findMember("m1") == 0);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(si.typeName(), "");
+            CXXTOOLS_UNIT_ASSERT_EQUALS(si.category(), cxxtools::SerializationInfo::Void);
+
+            si.addMember("x") <<= 5;
+            si.addMember("m1");
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(si.memberCount(), 2);
+            CXXTOOLS_UNIT_ASSERT(si.findMember("m2") == 0);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(si.getMember("m1").memberCount(), 0);
+            CXXTOOLS_UNIT_ASSERT(si.getMember("m1").isNull());
+
+            int value = 0;
+            si.getMember("x") >>= value;
+            CXXTOOLS_UNIT_ASSERT_EQUALS(value, 5);
+
+            cxxtools::SerializationInfo si2(si);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(si2.memberCount(), 2);
+        }
 };
 
 cxxtools::unit::RegisterTest<SerializationInfoTest> register_SerializationInfoTest;
@@ -82,6 +82,27 @@ namespace
         si.setTypeName(typeName);
     }
 
+    // Object with a member name of its own. Each element of a vector of those
+    // adds a new entry to the dictionary of the binary serializer.
+    struct NamedObject
+    {
+        std::string name;
+        int value;
+    };
+
+    void operator>>= (const cxxtools::SerializationInfo& si, NamedObject& obj)
+    {
+        cxxtools::SerializationInfo::ConstIterator it = si.begin();
+        obj.name = it->name();
+        *it >>= obj.value;
+    }
+
+    void operator<<= (cxxtools::SerializationInfo& si, const NamedObject& obj)
+    {
+        si.addMember(obj.name) <<= obj.value;
+        si.setTypeName(typeName);
+    }
+
     bool runXml = true;
     bool runJson = true;
     bool runBin = true;
@@ -199,6 +220,7 @@ int main(int argc, char* argv[])
         cxxtools::Arg<unsigned> I(argc, argv, 'I', nn);
         cxxtools::Arg<unsigned> D(argc, argv, 'D', nn);
         cxxtools::Arg<unsigned> C(argc, argv, 'C', nn);
+        cxxtools::Arg<unsigned> T(argc, argv, 'T', 10000);
 
         cxxtools::Arg<bool> fileoutput(argc, argv, 'f');
 
@@ -213,12 +235,13 @@ int main(int argc, char* argv[])
             runXml  = runJson = runBin  = true;
         }
 
-        std::cout << "benchmark serializer with " << I.getValue() << " int vector " << D.getValue() << " double vector and " << C.getValue() << " custom vector iterations\n\n"
+        std::cout << "benchmark serializer with " << I.getValue() << " int vector " << D.getValue() << " double vector " << C.getValue() << " custom vector and " << T.getValue() << " named object vector iterations\n\n"
                      "options:\n"
                      "   -n <number>       specify number of default iterations\n"
                      "   -I <number>       specify number of iterations for int vector\n"
                      "   -D <number>       specify number of iterations for double vector\n"
                      "   -C <number>       specify number of iterations for custom object\n"
+                     "   -T <number>       specify number of iterations for objects with distinct member names\n"
                      "   -f                write serialized output to files\n" << std::endl;
 
         if (I.getValue() > 0)
@@ -263,6 +286,38 @@ int main(int argc, char* argv[])
             }
         }
 
+        if (T.getValue() > 0)
+        {
+            std::cout << "vector of objects with distinct member names:" << std::endl;
+
+            NamedObject obj;
+            std::vector<NamedObject> v;
+            for (unsigned n = 0; n < T; ++n)
+            {
+                obj.name = "member" + cxxtools::convert<std::string>(n);
+                obj.value = n;
+                v.push_back(obj);
+            }
+
+            if (runXml)
+            {
+                std::cout << "xml:" << std::endl;
+                benchXmlSerialization(v, fileoutput ? "namedobject.xml" : 0);
+            }
+
+            if (runJson)
+            {
+                std::cout << "json:" << std::endl;
+                benchJsonSerialization(v, fileoutput ? "namedobject.json" : 0);
+            }
+
+            if (runBin)
+            {
+                std::cout << "bin:" << std::endl;
+                benchBinSerialization(v, fileoutput ? "namedobject.bin" : 0);
+            }
+        }
+
     }
     catch (const std::exception& e)
     {
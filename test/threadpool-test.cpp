@@ -0,0 +1,289 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "cxxtools/unit/testsuite.h"
+#include "cxxtools/unit/registertest.h"
+#include "cxxtools/threadpool.h"
+#include "cxxtools/atomicity.h"
+#include "cxxtools/function.h"
+#include <vector>
+#include <stdexcept>
+#if __cplusplus >= 201103L
+#include <memory>
+#endif
+
+namespace
+{
+    cxxtools::atomic_t counter = 0;
+
+    void increment()
+    {
+        cxxtools::atomicIncrement(counter);
+    }
+
+    int answer()
+    {
+        return 42;
+    }
+
+    int fail()
+    {
+        throw std::logic_error("failed");
+    }
+
+    class CountJob : public cxxtools::ThreadPool::Job
+    {
+        public:
+            virtual void run()
+            { cxxtools::atomicIncrement(counter); }
+    };
+
+    class MarkRange : public cxxtools::ThreadPool::RangeJob
+    {
+            std::vector<cxxtools::atomic_t>& _marks;
+
+        public:
+            explicit MarkRange(std::vector<cxxtools::atomic_t>& marks)
+                : _marks(marks)
+                { }
+
+            virtual void run(std::size_t begin, std::size_t end)
+            {
+                for (std::size_t n = begin; n < end; ++n)
+                    cxxtools::atomicIncrement(_marks[n]);
+            }
+    };
+
+    class ParallelForJob : public cxxtools::ThreadPool::Job
+    {
+            cxxtools::ThreadPool& _pool;
+            std::vector<cxxtools::atomic_t>& _marks;
+
+        public:
+            ParallelForJob(cxxtools::ThreadPool& pool, std::vector<cxxtools::atomic_t>& marks)
+                : _pool(pool),
+                  _marks(marks)
+                { }
+
+            virtual void run()
+            {
+                MarkRange body(_marks);
+                _pool.parallelFor(0, _marks.size(), body, 10);
+            }
+    };
+
+#if __cplusplus >= 201103L
+    struct Answer
+    {
+        int operator() () const
+        { return 42; }
+    };
+
+    class Twice
+    {
+            std::unique_ptr<int> _value;
+
+        public:
+            explicit Twice(std::unique_ptr<int>&& value)
+                : _value(std::move(value))
+                { }
+
+            int operator() () const
+            { return *_value * 2; }
+    };
+#endif
+
+    bool allMarked(const std::vector<cxxtools::atomic_t>& marks, cxxtools::atomic_t count)
+    {
+        for (std::size_t n = 0; n < marks.size(); ++n)
+            if (marks[n] != count)
+                return false;
+        return true;
+    }
+}
+
+class ThreadPoolTest : public cxxtools::unit::TestSuite
+{
+    public:
+        ThreadPoolTest()
+            : cxxtools::unit::TestSuite("threadpool")
+        {
+            registerMethod("testSchedule", *this, &ThreadPoolTest::testSchedule);
+            registerMethod("testResult", *this, &ThreadPoolTest::testResult);
+            registerMethod("testFailed", *this, &ThreadPoolTest::testFailed);
+            registerMethod("testCanceled", *this, &ThreadPoolTest::testCanceled);
+            registerMethod("testBatch", *this, &ThreadPoolTest::testBatch);
+            registerMethod("testParallelFor", *this, &ThreadPoolTest::testParallelFor);
+            registerMethod("testNestedParallelFor", *this, &ThreadPoolTest::testNestedParallelFor);
+#if __cplusplus >= 201103L
+            registerMethod("testFunction", *this, &ThreadPoolTest::testFunction);
+#endif
+        }
+
+        void testSchedule()
+        {
+            counter = 0;
+
+            cxxtools::ThreadPool pool(4);
+            std::vector<cxxtools::ThreadPool::Future> futures;
+            for (unsigned n = 0; n < 1000; ++n)
+                futures.push_back(pool.schedule(cxxtools::callable(increment)));
+
+            for (unsigned n = 0; n < futures.size(); ++n)
+            {
+                CXXTOOLS_UNIT_ASSERT(futures[n].wait());
+                CXXTOOLS_UNIT_ASSERT(futures[n].isFinished());
+            }
+
+            pool.stop();
+            CXXTOOLS_UNIT_ASSERT_EQUALS(counter, 1000);
+        }
+
+        void testResult()
+        {
+            cxxtools::ThreadPool pool(2);
+            cxxtools::ThreadPool::Result<int> result = pool.schedule(cxxtools::callable(answer));
+            CXXTOOLS_UNIT_ASSERT_EQUALS(result.get(), 42);
+            CXXTOOLS_UNIT_ASSERT(result.isFinished());
+            CXXTOOLS_UNIT_ASSERT(!result.isFailed());
+        }
+
+        void testFailed()
+        {
+            cxxtools::ThreadPool pool(2);
+            cxxtools::ThreadPool::Result<int> result = pool.schedule(cxxtools::callable(fail));
+            result.wait();
+            CXXTOOLS_UNIT_ASSERT(result.isFailed());
+#if __cplusplus >= 201103L
+            CXXTOOLS_UNIT_ASSERT_THROW(result.get(), std::logic_error);
+#else
+            CXXTOOLS_UNIT_ASSERT_THROW(result.get(), std::runtime_error);
+#endif
+        }
+
+        void testCanceled()
+        {
+            counter = 0;
+
+            cxxtools::ThreadPool::Future future;
+
+            {
+                cxxtools::ThreadPool pool(2, false);
+                future = pool.schedule(cxxtools::callable(increment));
+                CXXTOOLS_UNIT_ASSERT(future.isWaiting());
+            }
+
+            CXXTOOLS_UNIT_ASSERT(future.wait());
+            CXXTOOLS_UNIT_ASSERT(future.isCanceled());
+            CXXTOOLS_UNIT_ASSERT_EQUALS(counter, 0);
+        }
+
+        void testBatch()
+        {
+            counter = 0;
+
+            cxxtools::ThreadPool pool(3);
+            std::vector<cxxtools::ThreadPool::Job*> jobs;
+            for (unsigned n = 0; n < 100; ++n)
+                jobs.push_back(new CountJob());
+
+            std::vector<cxxtools::ThreadPool::Future> futures = pool.scheduleBatch(jobs);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(futures.size(), 100);
+
+            for (unsigned n = 0; n < futures.size(); ++n)
+                futures[n].wait();
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(counter, 100);
+        }
+
+        void testParallelFor()
+        {
+            cxxtools::ThreadPool pool(4);
+            std::vector<cxxtools::atomic_t> marks(10000);
+
+            MarkRange body(marks);
+            pool.parallelFor(0, marks.size(), body);
+            CXXTOOLS_UNIT_ASSERT(allMarked(marks, 1));
+
+            // works also, when the pool is not running
+            pool.stop();
+            pool.parallelFor(0, marks.size(), body, 7);
+            CXXTOOLS_UNIT_ASSERT(allMarked(marks, 2));
+        }
+
+        void testNestedParallelFor()
+        {
+            cxxtools::ThreadPool pool(2);
+            std::vector<cxxtools::atomic_t> marks(1000);
+
+            // all threads block in parallelFor, while helper jobs are queued
+            std::vector<cxxtools::ThreadPool::Future> futures;
+            for (unsigned n = 0; n < 4; ++n)
+                futures.push_back(pool.scheduleJob(new ParallelForJob(pool, marks)));
+
+            for (unsigned n = 0; n < futures.size(); ++n)
+                CXXTOOLS_UNIT_ASSERT(futures[n].wait(10));
+
+            CXXTOOLS_UNIT_ASSERT(allMarked(marks, 4));
+        }
+
+#if __cplusplus >= 201103L
+        void testFunction()
+        {
+            cxxtools::ThreadPool pool(2);
+
+            // a move only function object
+            std::unique_ptr<int> value(new int(5));
+            auto result = pool.schedule(Twice(std::move(value)));
+            CXXTOOLS_UNIT_ASSERT_EQUALS(result.get(), 10);
+
+            // function objects passed as lvalues are copied
+            auto answerFunction = [] () { return answer(); };
+            auto lvalue = pool.schedule(answerFunction);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(lvalue.get(), 42);
+
+            const Answer constAnswer = Answer();
+            auto constLvalue = pool.schedule(constAnswer);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(constLvalue.get(), 42);
+
+            auto failed = pool.schedule([] () { throw std::logic_error("failed"); });
+            CXXTOOLS_UNIT_ASSERT_THROW(failed.get(), std::logic_error);
+
+            std::vector<int> values(1000);
+            pool.parallelFor(0, values.size(), [&values] (std::size_t begin, std::size_t end) {
+                for (std::size_t n = begin; n < end; ++n)
+                    values[n] = static_cast<int>(n);
+            });
+
+            for (std::size_t n = 0; n < values.size(); ++n)
+                CXXTOOLS_UNIT_ASSERT_EQUALS(values[n], static_cast<int>(n));
+        }
+#endif
+};
+
+cxxtools::unit::RegisterTest<ThreadPoolTest> register_ThreadPoolTest;
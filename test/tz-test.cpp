@@ -3,6 +3,8 @@
 #include <cxxtools/unit/testsuite.h>
 #include <cxxtools/unit/registertest.h>
 
+#include <vector>
+
 class TzTest : public cxxtools::unit::TestSuite
 {
 public:
@@ -15,6 +17,8 @@ public:
         registerMethod("offset", *this, &TzTest::offset);
         registerMethod("isDst", *this, &TzTest::isDst);
         registerMethod("ownTz", *this, &TzTest::ownTz);
+        registerMethod("bulkToLocal", *this, &TzTest::bulkToLocal);
+        registerMethod("utcZone", *this, &TzTest::utcZone);
     }
 
     void local2utc();
@@ -23,6 +27,8 @@ public:
     void offset();
     void isDst();
     void ownTz();
+    void bulkToLocal();
+    void utcZone();
 };
 
 void TzTest::local2utc()
@@ -104,4 +110,32 @@ void TzTest::ownTz()
     CXXTOOLS_UNIT_ASSERT(diff >= cxxtools::Seconds(0) && diff <= cxxtools::Seconds(1));
 }
 
+void TzTest::bulkToLocal()
+{
+    cxxtools::Tz tz("Europe/Berlin");
+
+    std::vector<cxxtools::UtcDateTime> utc;
+    for (cxxtools::DateTime dt(2018, 3, 20, 0, 0, 0); dt < cxxtools::DateTime(2018, 11, 10, 0, 0, 0); dt += cxxtools::Hours(7))
+        utc.push_back(cxxtools::UtcDateTime(dt));
+
+    std::vector<cxxtools::LocalDateTime> local(utc.size());
+    tz.toLocal(&utc[0], &local[0], utc.size());
+
+    for (unsigned n = 0; n < utc.size(); ++n)
+        CXXTOOLS_UNIT_ASSERT_EQUALS(local[n].toString(), tz.toLocal(utc[n]).toString());
+
+    CXXTOOLS_UNIT_ASSERT_EQUALS(local.front().toString(), "2018-03-20 01:00:00");
+    CXXTOOLS_UNIT_ASSERT_EQUALS(local.back().toString(), cxxtools::LocalDateTime(utc.back() + cxxtools::Hours(1)).toString());
+}
+
+void TzTest::utcZone()
+{
+    cxxtools::Tz tz("UTC");
+    cxxtools::UtcDateTime ut(2018, 11, 7, 13, 0, 5);
+
+    CXXTOOLS_UNIT_ASSERT_EQUALS(tz.toLocal(ut).toString(), ut.toString());
+    CXXTOOLS_UNIT_ASSERT_EQUALS(tz.toUtc(cxxtools::LocalDateTime(ut)).toString(), ut.toString());
+    CXXTOOLS_UNIT_ASSERT_EQUALS(tz.offset(ut), cxxtools::Timespan(0));
+}
+
 cxxtools::unit::RegisterTest<TzTest> register_TzTest;
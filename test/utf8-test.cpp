@@ -44,6 +44,23 @@ class Utf8Test : public cxxtools::unit::TestSuite
       registerMethod("byteordermark", *this, &Utf8Test::byteordermarkTest);
       registerMethod("incompleteBom", *this, &Utf8Test::incompleteBomTest);
       registerMethod("partialBom", *this, &Utf8Test::partialBomTest);
+      registerMethod("longText", *this, &Utf8Test::longTextTest);
+      registerMethod("chunkedDecode", *this, &Utf8Test::chunkedDecodeTest);
+      registerMethod("illegalInAsciiRun", *this, &Utf8Test::illegalInAsciiRunTest);
+    }
+
+    // ascii runs of different length with 2, 3 and 4 byte sequences in between
+    static cxxtools::String mixedText()
+    {
+      static const cxxtools::Char::value_type special[] = { 0xe4, 0x20ac, 0x1f600 };
+      cxxtools::String ustr;
+      for (unsigned n = 0; n < 200; ++n)
+      {
+        for (unsigned i = 0; i < n % 37; ++i)
+          ustr += cxxtools::Char('a' + i % 26);
+        ustr += cxxtools::Char(special[n % 3]);
+      }
+      return ustr;
     }
 
     void encodeTest()
@@ -107,6 +124,66 @@ class Utf8Test : public cxxtools::unit::TestSuite
       CXXTOOLS_UNIT_ASSERT_EQUALS(to[0].narrow(), 'A');   // now output
     }
 
+    void longTextTest()
+    {
+      cxxtools::String ustr = mixedText();
+
+      // encode character by character for reference
+      std::string expected;
+      for (unsigned n = 0; n < ustr.size(); ++n)
+        expected += cxxtools::Utf8Codec::encode(ustr.data() + n, 1);
+
+      std::string bstr = cxxtools::Utf8Codec::encode(ustr);
+      CXXTOOLS_UNIT_ASSERT_EQUALS(bstr.size(), expected.size());
+      CXXTOOLS_UNIT_ASSERT(bstr == expected);
+
+      cxxtools::String ustr2 = cxxtools::Utf8Codec::decode(bstr);
+      CXXTOOLS_UNIT_ASSERT_EQUALS(ustr2.size(), ustr.size());
+      CXXTOOLS_UNIT_ASSERT(ustr2 == ustr);
+    }
+
+    void chunkedDecodeTest()
+    {
+      cxxtools::String ustr = mixedText();
+      std::string bstr = cxxtools::Utf8Codec::encode(ustr);
+
+      // feed input in chunks, which split sequences at all positions
+      for (unsigned chunk = 1; chunk <= 23; chunk += 2)
+      {
+        cxxtools::Utf8Codec codec;
+        cxxtools::MBState mbstate;
+        cxxtools::Char to[20];
+        cxxtools::String result;
+
+        const char* from = bstr.data();
+        const char* end = bstr.data() + bstr.size();
+        while (from < end)
+        {
+          const char* chunkEnd = end - from > chunk ? from + chunk : end;
+          const char* fromNext;
+          cxxtools::Char* toNext;
+          cxxtools::Utf8Codec::result r = codec.in(mbstate, from, chunkEnd, fromNext, to, to + 20, toNext);
+          CXXTOOLS_UNIT_ASSERT(r != cxxtools::Utf8Codec::error);
+          result.append(to, toNext);
+          from = fromNext;
+        }
+
+        CXXTOOLS_UNIT_ASSERT(result == ustr);
+      }
+    }
+
+    void illegalInAsciiRunTest()
+    {
+      std::string bstr(40, 'a');
+      bstr[20] = '\xff';
+      CXXTOOLS_UNIT_ASSERT_THROW(cxxtools::Utf8Codec::decode(bstr), cxxtools::ConversionError);
+
+      // overlong encoding of '/'
+      bstr[20] = '\xc0';
+      bstr[21] = '\xaf';
+      CXXTOOLS_UNIT_ASSERT_THROW(cxxtools::Utf8Codec::decode(bstr), cxxtools::ConversionError);
+    }
+
 };
 
 cxxtools::unit::RegisterTest<Utf8Test> register_Utf8Test;
@@ -0,0 +1,206 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <cxxtools/arg.h>
+#include <cxxtools/argout.h>
+#include <cxxtools/json.h>
+#include <cxxtools/serializationinfo.h>
+
+#include <iostream>
+#include <fstream>
+#include <stdexcept>
+#include <map>
+#include <string>
+#include <cstring>
+#include <cstdio>
+#include <time.h>
+#include <stdint.h>
+
+struct Usage { };
+
+// Reads the binary log format written by the log configuration
+// setBinaryFile. See BinaryFileAppender in src/log.cpp for the layout.
+class Logformat
+{
+        typedef std::map<uint32_t, std::string> Categories;
+
+        bool outputJson;
+        bool utc;
+        Categories categories;
+
+        template <typename T>
+        static bool get(std::istream& in, T& value)
+        {
+            return bool(in.read(reinterpret_cast<char*>(&value), sizeof(T)));
+        }
+
+        static bool get(std::istream& in, std::string& value, unsigned size)
+        {
+            value.resize(size);
+            return size == 0 || bool(in.read(&value[0], size));
+        }
+
+        void formatTime(std::ostream& out, int64_t sec, uint32_t usec) const;
+
+    public:
+        Logformat(int& argc, char* argv[]);
+        void format(std::istream& in, std::ostream& out);
+};
+
+Logformat::Logformat(int& argc, char* argv[])
+    : outputJson(cxxtools::Arg<bool>(argc, argv, 'j')),
+      utc(cxxtools::Arg<bool>(argc, argv, 'u'))
+{
+    if (cxxtools::Arg<bool>(argc, argv, 'h'))
+        throw Usage();
+}
+
+void Logformat::formatTime(std::ostream& out, int64_t sec, uint32_t usec) const
+{
+    time_t t = static_cast<time_t>(sec);
+    struct tm tt;
+    if (utc)
+        gmtime_r(&t, &tt);
+    else
+        localtime_r(&t, &tt);
+
+    char buffer[64];
+    std::snprintf(buffer, sizeof(buffer), "%04d-%02d-%02d %02d:%02d:%02d.%05u",
+        1900 + tt.tm_year, tt.tm_mon + 1, tt.tm_mday,
+        tt.tm_hour, tt.tm_min, tt.tm_sec, static_cast<unsigned>(usec / 10));
+    out << buffer;
+}
+
+void Logformat::format(std::istream& in, std::ostream& out)
+{
+    char magic[8];
+    if (!in.read(magic, 8) || std::memcmp(magic, "CXXLOG1\n", 8) != 0)
+        throw std::runtime_error("input is not a binary log file");
+
+    categories.clear();
+
+    std::string category;
+    std::string level;
+    std::string msg;
+
+    char type;
+    while (in.get(type) && type != '\0')
+    {
+        if (type == 'C')
+        {
+            uint32_t id;
+            uint16_t size;
+            if (!get(in, id) || !get(in, size) || !get(in, category, size))
+                break;
+            categories[id] = category;
+        }
+        else if (type == 'M')
+        {
+            int64_t sec;
+            uint32_t usec;
+            uint32_t pid;
+            uint64_t tid;
+            uint32_t categoryId;
+            uint8_t levelSize;
+            uint32_t size;
+            if (!get(in, sec) || !get(in, usec) || !get(in, pid) || !get(in, tid)
+              || !get(in, categoryId) || !get(in, levelSize) || !get(in, level, levelSize)
+              || !get(in, size) || !get(in, msg, size))
+                break;
+
+            Categories::const_iterator it = categories.find(categoryId);
+            const std::string& categoryName = it == categories.end() ? std::string() : it->second;
+
+            if (outputJson)
+            {
+                cxxtools::SerializationInfo si;
+                si.addMember("sec") <<= sec;
+                si.addMember("usec") <<= usec;
+                si.addMember("pid") <<= pid;
+                si.addMember("tid") <<= tid;
+                si.addMember("level") <<= level;
+                si.addMember("category") <<= categoryName;
+                si.addMember("message") <<= msg;
+                out << cxxtools::Json(si) << '\n';
+            }
+            else
+            {
+                formatTime(out, sec, usec);
+                out << " [" << pid << '.' << tid << "] "
+                    << level << ' ' << categoryName << " - " << msg << '\n';
+            }
+        }
+        else
+            throw std::runtime_error("invalid record type in binary log file");
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    try
+    {
+        cxxtools::ArgOut out(argc, argv, 'o');
+
+        Logformat app(argc, argv);
+
+        if (argc > 1)
+        {
+            for (int a = 1; a < argc; ++a)
+            {
+                std::ifstream in(argv[a], std::ios::binary);
+                if (!in)
+                    throw std::runtime_error(std::string("failed to open file \"") + argv[a] + '"');
+                app.format(in, out);
+            }
+        }
+        else
+        {
+            app.format(std::cin, out);
+        }
+
+        out.flush();
+    }
+    catch (Usage)
+    {
+        std::cerr << "Usage: " << argv[0] << " {options} [inputfiles...]\n\n"
+                     "Description:\n"
+                     "  Renders binary log files written by a cxxtools logger configured\n"
+                     "  with setBinaryFile as text lines or json.\n"
+                     "  When no inputfile is given, data is read from stdin.\n\n"
+                     "Options:\n"
+                     " -j         output one json object per record\n"
+                     " -u         output timestamps in utc instead of local time\n"
+                     " -o <file>  output to file\n"
+                     " -h         print this help\n";
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+}